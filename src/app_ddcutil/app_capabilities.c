@@ -103,9 +103,7 @@ void
 app_show_parsed_capabilities(Display_Handle * dh, Parsed_Capabilities * pcap)
 {
    assert(pcap);
-
-   if ( dh->dref->io_path.io_mode == DDCA_IO_USB )
-      pcap->raw_value_synthesized = true;
+   // n. raw_value_synthesized is set for USB displays by ddc_get_parsed_capabilities()
 
    // report_parsed_capabilities(pcap, dh->dref->io_path.io_mode);    // io_mode no longer needed
    dyn_report_parsed_capabilities(pcap, dh, /* Display_Ref* */ NULL, 0);
@@ -122,13 +120,12 @@ app_capabilities(Display_Handle * dh)
 {
    char * capabilities_string;
    DDCA_Status ddcrc;
-   FILE * fout = stdout;
 
    ddcrc = app_get_capabilities_string(dh, &capabilities_string);
    if (ddcrc == 0) {
       DDCA_Output_Level ol = get_output_level();
       if (ol == DDCA_OL_TERSE) {
-          f0printf(fout,
+          f0printf(fout(),
                   "%s capabilities string: %s\n",
                        (dh->dref->io_path.io_mode == DDCA_IO_USB)
                              ? "Synthesized unparsed"
@@ -136,10 +133,19 @@ app_capabilities(Display_Handle * dh)
                   capabilities_string);
       }
       else {
-         // pcaps is always set, but may be damaged if there was a parsing error
-         Parsed_Capabilities * pcaps = parse_capabilities_string(capabilities_string);
-         app_show_parsed_capabilities(dh, pcaps);
-         free_parsed_capabilities(pcaps);
+         // pcaps may be damaged if there was a parsing error
+         // pcaps is owned by the display reference, do not free
+         Parsed_Capabilities * pcaps = NULL;
+         Error_Info * erec = ddc_get_parsed_capabilities(dh, &pcaps);
+         if (erec) {
+            ddcrc = ERRINFO_STATUS(erec);
+            f0printf(ferr(), "Unable to get parsed capabilities for monitor on %s: %s\n",
+                             dh_repr(dh), psc_desc(ddcrc));
+            errinfo_free(erec);
+         }
+         else {
+            app_show_parsed_capabilities(dh, pcaps);
+         }
       }
    }
    return ddcrc;
@@ -0,0 +1,129 @@
+/** @file app_concurrent.c
+ *
+ *  Execute a command function for several items, e.g. displays or files,
+ *  concurrently using the worker pool.
+ *
+ *  Each execution applies the calling thread's output level and setvcp
+ *  verification setting, and its fout() and ferr() output is captured.
+ *  Once all have completed, the captured output is written to the calling
+ *  thread's fout() in item order.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "config.h"
+
+/** \cond */
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+/** \endcond */
+
+#include "base/core.h"
+#include "base/rtti.h"
+#include "base/worker_pool.h"
+
+#include "ddc/ddc_vcp.h"
+
+#include "app_ddcutil/app_concurrent.h"
+
+// Default trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_TOP;
+
+/** Work item for one of the items */
+typedef struct {
+   gpointer          item;
+   char *            output;        // captured fout() and ferr() output
+   size_t            output_size;
+   bool              ok;
+} Concurrent_Work;
+
+/** Settings of the calling thread, applied to the threads executing the function */
+typedef struct {
+   App_Concurrent_Func func;
+   gpointer            arg;
+   DDCA_Output_Level   output_level;
+   bool                verify;
+} Concurrent_Settings;
+
+
+static void
+execute_one_of_multiple_items(gpointer item, gpointer arg) {
+   Concurrent_Work *     work     = item;
+   Concurrent_Settings * settings = arg;
+
+   FILE * saved_fout = fout();
+   FILE * saved_ferr = ferr();
+   DDCA_Output_Level saved_ol = set_output_level(settings->output_level);
+   bool saved_verify = ddc_set_verify_setvcp(settings->verify);
+   FILE * outf = open_memstream(&work->output, &work->output_size);
+   set_fout(outf);
+   set_ferr(outf);
+
+   work->ok = settings->func(work->item, settings->arg);
+
+   fclose(outf);
+   set_fout(saved_fout);
+   set_ferr(saved_ferr);
+   ddc_set_verify_setvcp(saved_verify);
+   set_output_level(saved_ol);
+}
+
+
+/** Executes a function for each of several items concurrently.
+ *
+ *  \param  items         items
+ *  \param  func          function to execute for each item
+ *  \param  arg           passed to each execution of **func**
+ *  \param  heading_func  if non-NULL, writes a heading before the output for each item
+ *  \return true if **func** succeeded for all items, false if not
+ */
+bool
+app_execute_concurrently(
+      GPtrArray *                  items,
+      App_Concurrent_Func          func,
+      gpointer                     arg,
+      App_Concurrent_Heading_Func  heading_func)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "item ct=%d", items->len);
+
+   Concurrent_Settings settings;
+   settings.func         = func;
+   settings.arg          = arg;
+   settings.output_level = get_output_level();
+   settings.verify       = ddc_get_verify_setvcp();
+
+   GPtrArray * work_items = g_ptr_array_new_with_free_func(g_free);
+   for (int ndx = 0; ndx < items->len; ndx++) {
+      Concurrent_Work * work = g_new0(Concurrent_Work, 1);
+      work->item = g_ptr_array_index(items, ndx);
+      g_ptr_array_add(work_items, work);
+   }
+   run_in_worker_pool(work_items, execute_one_of_multiple_items, &settings);
+
+   bool ok = true;
+   for (int ndx = 0; ndx < work_items->len; ndx++) {
+      Concurrent_Work * work = g_ptr_array_index(work_items, ndx);
+      if (heading_func)
+         heading_func(work->item, fout());
+      if (work->output) {
+         if (work->output_size > 0)
+            fwrite(work->output, 1, work->output_size, fout());
+         free(work->output);
+      }
+      if (!work->ok)
+         ok = false;
+   }
+   g_ptr_array_free(work_items, true);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning: %s", sbool(ok));
+   return ok;
+}
+
+
+void init_app_concurrent() {
+   RTTI_ADD_FUNC(app_execute_concurrently);
+}
@@ -0,0 +1,40 @@
+/** @file app_concurrent.h
+ *
+ *  Execute a command function for several items concurrently,
+ *  reporting the output of each in order
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef APP_CONCURRENT_H_
+#define APP_CONCURRENT_H_
+
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/** Function executed for one item
+ *
+ *  \param  item  item
+ *  \param  arg   argument passed to #app_execute_concurrently()
+ *  \return true if successful, false if not
+ */
+typedef bool (*App_Concurrent_Func)(gpointer item, gpointer arg);
+
+/** Function that writes a heading for the output of one item
+ *
+ *  \param  item  item
+ *  \param  outf  destination
+ */
+typedef void (*App_Concurrent_Heading_Func)(gpointer item, FILE * outf);
+
+bool app_execute_concurrently(
+      GPtrArray *                  items,
+      App_Concurrent_Func          func,
+      gpointer                     arg,
+      App_Concurrent_Heading_Func  heading_func);
+
+void init_app_concurrent();
+
+#endif /* APP_CONCURRENT_H_ */
@@ -0,0 +1,613 @@
+/** \file app_daemon.c
+ *
+ *  Implement the DAEMON command, and forwarding of commands to a running daemon.
+ *
+ *  A daemon performs initialization and display detection once, then executes
+ *  commands received from other invocations of ddcutil over a Unix domain socket.
+ *  Detected displays, capabilities, cached feature values, and dynamic sleep
+ *  adjustments are retained from one command to the next.
+ *
+ *  The client sends its (configuration file expanded) argument list, the daemon
+ *  parses and executes it with output captured, and returns the exit code
+ *  and captured output.  Commands are executed serially.  Options that are
+ *  applied during initialization, e.g. --maxtries or --sleep-multiplier,
+ *  are those in effect when the daemon was started.  If a command specifies
+ *  different values, the client is told that they were ignored.
+ *
+ *  The socket is created in a directory that must be owned by, and accessible
+ *  only by, the user.  The client also checks that the daemon is running
+ *  as the same user before sending a command.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#define _GNU_SOURCE   // for struct ucred, accept4()
+
+/** \cond */
+#include <assert.h>
+#include <errno.h>
+#include <glib-2.0/glib.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "util/file_util.h"
+#include "util/glib_string_util.h"
+#include "util/report_util.h"
+#include "util/string_util.h"
+/** \endcond */
+
+#include "base/core.h"
+#include "base/rtti.h"
+
+#include "i2c/i2c_bus_core.h"
+
+#include "ddc/ddc_vcp.h"
+
+#include "cmdline/cmd_parser.h"
+#include "cmdline/parsed_cmd.h"
+
+#include "app_ddcutil/app_daemon.h"
+
+// Default trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_TOP;
+
+#define DAEMON_MAGIC             0x44444344     // "DDCD"
+#define DAEMON_PROTOCOL_VERSION  1
+#define DAEMON_MAX_REQUEST_SIZE  65536
+#define DAEMON_MAX_ARGC          1024
+#define DAEMON_IO_TIMEOUT_SECS   10             // for reading a request or writing a reply
+#define DAEMON_ACCEPT_RETRY_SECS 1              // after accept() fails for lack of resources
+
+/** Fixed portion of a request, followed by **args_len** bytes containing
+ *  **argc** null terminated strings */
+typedef struct {
+   uint32_t  magic;
+   uint32_t  version;
+   uint32_t  argc;
+   uint32_t  args_len;
+} Daemon_Request_Header;
+
+/** Fixed portion of a reply, followed by **out_len** bytes of standard output
+ *  and **err_len** bytes of error output */
+typedef struct {
+   uint32_t  magic;
+   int32_t   rc;
+   uint32_t  out_len;
+   uint32_t  err_len;
+} Daemon_Reply_Header;
+
+static volatile sig_atomic_t terminate_requested = 0;
+static Parsed_Cmd * daemon_parsed_cmd = NULL;    // command that started the daemon
+
+
+/** Returns the name of the socket on which the daemon listens.
+ *
+ *  The socket is $XDG_RUNTIME_DIR/ddcutil/ddcutil.sock, or if XDG_RUNTIME_DIR
+ *  is not set, /tmp/ddcutil-<uid>/ddcutil.sock
+ *
+ *  \return socket name, caller must free
+ */
+char * app_daemon_socket_name() {
+   char * result = NULL;
+   const char * runtime_dir = getenv("XDG_RUNTIME_DIR");
+   if (runtime_dir && strlen(runtime_dir) > 0)
+      result = g_strdup_printf("%s/ddcutil/ddcutil.sock", runtime_dir);
+   else
+      result = g_strdup_printf("/tmp/ddcutil-%d/ddcutil.sock", (int) getuid());
+   return result;
+}
+
+
+/** Checks that the directory containing the socket is private to the user,
+ *  optionally creating it.
+ *
+ *  \param  socket_name  socket name
+ *  \param  create       create the directory if it does not exist
+ *  \param  ferr         if non-null, destination for error messages
+ *  \return 0 if the directory can be trusted, -errno if not
+ */
+static int
+check_socket_dir(const char * socket_name, bool create, FILE * ferr) {
+   char * dir = g_path_get_dirname(socket_name);
+   int rc = private_directory_check(dir, create, ferr);
+   g_free(dir);
+   return rc;
+}
+
+
+static bool
+set_socket_addr(struct sockaddr_un * addr, const char * socket_name) {
+   memset(addr, 0, sizeof(*addr));
+   addr->sun_family = AF_UNIX;
+   if (strlen(socket_name) >= sizeof(addr->sun_path))
+      return false;
+   strcpy(addr->sun_path, socket_name);
+   return true;
+}
+
+
+static bool
+write_all(int fd, const void * buf, size_t len) {
+   const char * p = buf;
+   while (len > 0) {
+      ssize_t ct = write(fd, p, len);
+      if (ct < 0) {
+         if (errno == EINTR)
+            continue;
+         return false;
+      }
+      p   += ct;
+      len -= ct;
+   }
+   return true;
+}
+
+
+static bool
+read_all(int fd, void * buf, size_t len) {
+   char * p = buf;
+   while (len > 0) {
+      ssize_t ct = read(fd, p, len);
+      if (ct < 0) {
+         if (errno == EINTR)
+            continue;
+         return false;
+      }
+      if (ct == 0)      // premature end of file
+         return false;
+      p   += ct;
+      len -= ct;
+   }
+   return true;
+}
+
+
+//
+// Client side
+//
+
+/** Reports whether a command is one that can be executed by the daemon.
+ *
+ *  Commands that report statistics, enable tracing, or report settings
+ *  are always executed in process.
+ *
+ *  \param  parsed_cmd  parsed command line
+ *  \return true if the command can be forwarded, false if not
+ */
+bool
+app_daemon_is_forwardable(Parsed_Cmd * parsed_cmd) {
+   bool result = false;
+   switch(parsed_cmd->cmd_id) {
+   case CMDID_DETECT:
+   case CMDID_CAPABILITIES:
+   case CMDID_GETVCP:
+   case CMDID_SETVCP:
+   case CMDID_SAVE_SETTINGS:
+   case CMDID_PROBE:
+      result = true;
+      break;
+   default:
+      break;
+   }
+   if (result) {
+      if ( (parsed_cmd->flags & (CMD_FLAG_NODAEMON | CMD_FLAG_SHOW_SETTINGS | CMD_FLAG_F4)) ||
+           parsed_cmd->stats_types != DDCA_STATS_NONE ||
+           parsed_cmd->traced_groups                  ||
+           parsed_cmd->traced_functions               ||
+           parsed_cmd->traced_files                   ||
+           IS_TRACING() )
+         result = false;
+   }
+   return result;
+}
+
+
+/** Sends a command to a running daemon and reports its output.
+ *
+ *  \param  argc    number of arguments
+ *  \param  argv    arguments, including the program name
+ *  \param  rc_loc  where to return the command's exit code
+ *  \retval true    the command was sent to the daemon
+ *  \retval false   no daemon is running, the command must be executed in process
+ *
+ *  \remark
+ *  Once the request has been sent, the command is not retried in process
+ *  even if the reply cannot be read, since it may already have been executed.
+ */
+bool
+app_daemon_forward_cmd(int argc, char ** argv, int * rc_loc) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "argc=%d", argc);
+
+   bool sent = false;
+   *rc_loc = EXIT_FAILURE;
+   char * socket_name = app_daemon_socket_name();
+   struct sockaddr_un addr;
+   int fd = -1;
+   if (!set_socket_addr(&addr, socket_name))
+      goto bye;
+   int dirrc = check_socket_dir(socket_name, false, NULL);
+   if (dirrc != 0) {
+      // a directory created by another user is never trusted
+      if (dirrc == -EPERM)
+         f0printf(ferr(), "Not using ddcutil daemon, directory of %s is not private to the current user\n",
+                          socket_name);
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "check_socket_dir() returned %d", dirrc);
+      goto bye;
+   }
+   fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+   if (fd < 0)
+      goto bye;
+   if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "connect() failed, errno=%d", errno);
+      goto bye;
+   }
+   struct ucred cred;
+   socklen_t cred_len = sizeof(cred);
+   if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) < 0 || cred.uid != getuid()) {
+      f0printf(ferr(), "Not using ddcutil daemon, %s is owned by another user\n", socket_name);
+      goto bye;
+   }
+
+   GByteArray * args = g_byte_array_new();
+   for (int ndx = 0; ndx < argc; ndx++)
+      g_byte_array_append(args, (guint8*) argv[ndx], strlen(argv[ndx])+1);
+   Daemon_Request_Header request = {DAEMON_MAGIC, DAEMON_PROTOCOL_VERSION, argc, args->len};
+   struct sigaction old_action;
+   struct sigaction ignore_action = {.sa_handler = SIG_IGN};
+   sigaction(SIGPIPE, &ignore_action, &old_action);     // daemon may have terminated
+   bool write_ok = write_all(fd, &request, sizeof(request)) &&
+                   write_all(fd, args->data, args->len);
+   sigaction(SIGPIPE, &old_action, NULL);
+   g_byte_array_free(args, true);
+   if (!write_ok) {
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "write failed, errno=%d", errno);
+      goto bye;
+   }
+   sent = true;
+
+   Daemon_Reply_Header reply;
+   if (!read_all(fd, &reply, sizeof(reply)) || reply.magic != DAEMON_MAGIC) {
+      f0printf(ferr(), "Invalid reply from ddcutil daemon on %s\n", socket_name);
+      goto bye;
+   }
+   char * buf = malloc(reply.out_len + reply.err_len);
+   if (!read_all(fd, buf, reply.out_len + reply.err_len)) {
+      f0printf(ferr(), "Incomplete reply from ddcutil daemon on %s\n", socket_name);
+   }
+   else {
+      fwrite(buf, 1, reply.out_len, fout());
+      fwrite(buf + reply.out_len, 1, reply.err_len, ferr());
+      *rc_loc = reply.rc;
+   }
+   free(buf);
+
+bye:
+   if (fd >= 0)
+      close(fd);
+   free(socket_name);
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %s, *rc_loc=%d", sbool(sent), *rc_loc);
+   return sent;
+}
+
+
+//
+// Daemon side
+//
+
+static void
+terminate_signal_handler(int signum) {
+   terminate_requested = 1;
+}
+
+
+/** Returns the names of the initialization options for which a command
+ *  specifies values that differ from those the daemon was started with.
+ *
+ *  \param  parsed_cmd  parsed command
+ *  \return comma separated option names, NULL if none, caller must free
+ */
+static char *
+ignored_init_options(Parsed_Cmd * parsed_cmd) {
+   if (!daemon_parsed_cmd)
+      return NULL;
+   Parsed_Cmd * dcmd = daemon_parsed_cmd;
+   GPtrArray * names = g_ptr_array_new();
+
+   if (memcmp(parsed_cmd->max_tries, dcmd->max_tries, sizeof(dcmd->max_tries)) != 0)
+      g_ptr_array_add(names, "--maxtries");
+   if (parsed_cmd->sleep_multiplier != dcmd->sleep_multiplier)
+      g_ptr_array_add(names, "--sleep-multiplier");
+   if (parsed_cmd->edid_read_size != dcmd->edid_read_size)
+      g_ptr_array_add(names, "--edid-read-size");
+   if (parsed_cmd->worker_thread_ct != dcmd->worker_thread_ct)
+      g_ptr_array_add(names, "--worker-threads");
+
+   struct {
+      uint64_t          flag;
+      char *            name;
+   } init_flags[] = {
+      {CMD_FLAG_REDUCE_SLEEPS,    "--less-sleep"},
+      {CMD_FLAG_DEFER_SLEEPS,     "--lazy-sleep"},
+      {CMD_FLAG_DSA,              "--dsa"},
+      {CMD_FLAG_ASYNC,            "--async"},
+      {CMD_FLAG_ENABLE_UDF,       "--udf"},
+      {CMD_FLAG_TIMEOUT_I2C_IO,   "--timeout-i2c-io"},
+      {CMD_FLAG_ENABLE_BUS_LOCKS, "--enable-bus-locks"},
+   };
+   for (int ndx = 0; ndx < ARRAY_SIZE(init_flags); ndx++) {
+      if ((parsed_cmd->flags & init_flags[ndx].flag) != (dcmd->flags & init_flags[ndx].flag))
+         g_ptr_array_add(names, init_flags[ndx].name);
+   }
+
+   char * result = NULL;
+   if (names->len > 0)
+      result = join_string_g_ptr_array(names, ", ");
+   g_ptr_array_free(names, true);
+   return result;
+}
+
+
+/** Parses and executes a single request.
+ *
+ *  Output level and the settings that main() derives from the command line
+ *  for each command are applied for the duration of the request.
+ */
+static int
+execute_request(int argc, char ** argv, Daemon_Cmd_Executor executor, FILE * outf, FILE * errf) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "argc=%d", argc);
+
+   int rc = EXIT_FAILURE;
+   FILE * saved_fout = fout();
+   FILE * saved_ferr = ferr();
+   set_fout(outf);
+   set_ferr(errf);
+
+   // parser diagnostics are written to ferr(), i.e. returned to the client
+   Parsed_Cmd * parsed_cmd = parse_command(argc, argv, MODE_DDCUTIL);
+   if (!parsed_cmd) {
+      f0printf(errf, "Invalid command\n");
+   }
+   else if (!app_daemon_is_forwardable(parsed_cmd)) {
+      f0printf(errf, "Command %s is not executed by the ddcutil daemon\n",
+                     cmdid_name(parsed_cmd->cmd_id));
+   }
+   else {
+      char * ignored = ignored_init_options(parsed_cmd);
+      if (ignored) {
+         f0printf(errf, "Options ignored by the ddcutil daemon, which uses the values it was started with: %s\n",
+                        ignored);
+         free(ignored);
+      }
+
+      DDCA_Output_Level saved_ol = set_output_level(parsed_cmd->output_level);
+      bool saved_verify = ddc_get_verify_setvcp();
+      bool saved_report_errors = is_report_ddc_errors_enabled();
+      bool saved_force_slave_addr = i2c_force_slave_addr_flag;
+      ddc_set_verify_setvcp(parsed_cmd->flags & CMD_FLAG_VERIFY);
+      enable_report_ddc_errors(parsed_cmd->flags & CMD_FLAG_DDCDATA);
+      i2c_force_slave_addr_flag = parsed_cmd->flags & CMD_FLAG_FORCE_SLAVE_ADDR;
+
+      rc = executor(parsed_cmd);
+
+      i2c_force_slave_addr_flag = saved_force_slave_addr;
+      enable_report_ddc_errors(saved_report_errors);
+      ddc_set_verify_setvcp(saved_verify);
+      set_output_level(saved_ol);
+   }
+   if (parsed_cmd)
+      free_parsed_cmd(parsed_cmd);
+
+   set_fout(saved_fout);
+   set_ferr(saved_ferr);
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %d", rc);
+   return rc;
+}
+
+
+/** Reads a request from a client connection, executes it, and sends the reply.
+ *
+ *  \param  fd        connected socket
+ *  \param  executor  function that executes the parsed command
+ */
+static void
+handle_connection(int fd, Daemon_Cmd_Executor executor) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "fd=%d", fd);
+
+   struct ucred cred;
+   socklen_t cred_len = sizeof(cred);
+   if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) < 0 || cred.uid != getuid()) {
+      DBGTRC_DONE(debug, TRACE_GROUP, "Rejecting connection from another user");
+      return;
+   }
+
+   // a client that stalls must not block the clients that follow
+   struct timeval timeout = {.tv_sec = DAEMON_IO_TIMEOUT_SECS, .tv_usec = 0};
+   if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0 ||
+       setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) < 0)
+   {
+      DBGTRC_DONE(debug, TRACE_GROUP, "setsockopt() failed, errno=%d", errno);
+      return;
+   }
+
+   Daemon_Request_Header request;
+   if (!read_all(fd, &request, sizeof(request))  ||
+       request.magic    != DAEMON_MAGIC            ||
+       request.version  != DAEMON_PROTOCOL_VERSION ||
+       request.argc     == 0                       ||
+       request.argc     >  DAEMON_MAX_ARGC         ||
+       request.args_len >  DAEMON_MAX_REQUEST_SIZE)
+   {
+      DBGTRC_DONE(debug, TRACE_GROUP, "Invalid request header");
+      return;
+   }
+
+   char * args = calloc(1, request.args_len + 1);
+   if (!read_all(fd, args, request.args_len)) {
+      free(args);
+      DBGTRC_DONE(debug, TRACE_GROUP, "Incomplete request");
+      return;
+   }
+
+   char ** argv = calloc(request.argc + 1, sizeof(char*));
+   int argc = 0;
+   for (char * p = args; p < args + request.args_len && argc < request.argc; p += strlen(p)+1)
+      argv[argc++] = p;
+
+   char * out_buf = NULL;
+   size_t out_len = 0;
+   char * err_buf = NULL;
+   size_t err_len = 0;
+   FILE * outf = open_memstream(&out_buf, &out_len);
+   FILE * errf = open_memstream(&err_buf, &err_len);
+   int rc = EXIT_FAILURE;
+   if (argc != request.argc)
+      f0printf(errf, "Malformed request\n");
+   else
+      rc = execute_request(argc, argv, executor, outf, errf);
+   fclose(outf);
+   fclose(errf);
+
+   Daemon_Reply_Header reply = {DAEMON_MAGIC, rc, out_len, err_len};
+   bool ok = write_all(fd, &reply, sizeof(reply)) &&
+             write_all(fd, out_buf, out_len)      &&
+             write_all(fd, err_buf, err_len);
+
+   free(out_buf);
+   free(err_buf);
+   free(argv);
+   free(args);
+   DBGTRC_DONE(debug, TRACE_GROUP, "rc=%d, reply sent: %s", rc, sbool(ok));
+}
+
+
+/** Creates the listening socket, replacing a stale socket left by a daemon
+ *  that did not terminate normally.
+ *
+ *  \param  socket_name  socket name
+ *  \return socket file descriptor, -1 if error
+ */
+static int
+create_listen_socket(const char * socket_name) {
+   struct sockaddr_un addr;
+   if (!set_socket_addr(&addr, socket_name)) {
+      f0printf(ferr(), "Socket name too long: %s\n", socket_name);
+      return -1;
+   }
+
+   if (check_socket_dir(socket_name, true, ferr()) != 0) {
+      f0printf(ferr(), "Unable to use directory of %s\n", socket_name);
+      return -1;
+   }
+
+   int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+   if (fd < 0) {
+      f0printf(ferr(), "socket() failed: %s\n", strerror(errno));
+      return -1;
+   }
+
+   if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == 0) {
+      f0printf(ferr(), "A ddcutil daemon is already listening on %s\n", socket_name);
+      close(fd);
+      return -1;
+   }
+   unlink(socket_name);
+
+   mode_t saved_umask = umask(0077);
+   int rc = bind(fd, (struct sockaddr *) &addr, sizeof(addr));
+   umask(saved_umask);
+   if (rc < 0 || listen(fd, 16) < 0) {
+      f0printf(ferr(), "Unable to listen on %s: %s\n", socket_name, strerror(errno));
+      close(fd);
+      return -1;
+   }
+   return fd;
+}
+
+
+/** Executes the DAEMON command.
+ *
+ *  Serves requests until terminated by SIGINT or SIGTERM.
+ *
+ *  \param  parsed_cmd  command that started the daemon
+ *  \param  executor    function that executes a parsed command
+ *  \retval EXIT_SUCCESS normal termination
+ *  \retval EXIT_FAILURE unable to listen on socket, or unable to accept connections
+ */
+int
+app_daemon_serve(Parsed_Cmd * parsed_cmd, Daemon_Cmd_Executor executor) {
+   bool debug = false;
+   daemon_parsed_cmd = parsed_cmd;
+   char * socket_name = app_daemon_socket_name();
+   DBGTRC_STARTING(debug, TRACE_GROUP, "socket_name=%s", socket_name);
+
+   int listen_fd = create_listen_socket(socket_name);
+   if (listen_fd < 0) {
+      free(socket_name);
+      DBGTRC_DONE(debug, TRACE_GROUP, "Returning EXIT_FAILURE");
+      return EXIT_FAILURE;
+   }
+
+   // no SA_RESTART, so that accept() is interrupted
+   struct sigaction term_action = {.sa_handler = terminate_signal_handler};
+   sigaction(SIGINT,  &term_action, NULL);
+   sigaction(SIGTERM, &term_action, NULL);
+   struct sigaction ignore_action = {.sa_handler = SIG_IGN};
+   sigaction(SIGPIPE, &ignore_action, NULL);     // client may have terminated
+
+   if (get_output_level() >= DDCA_OL_NORMAL)
+      f0printf(fout(), "ddcutil daemon listening on %s\n", socket_name);
+
+   int rc = EXIT_SUCCESS;
+   while (!terminate_requested) {
+      int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+      if (fd < 0) {
+         int errsv = errno;
+         switch(errsv) {
+         case EINTR:             // signal, check whether to terminate
+         case ECONNABORTED:      // client gave up before connection accepted
+            break;
+         case EMFILE:
+         case ENFILE:
+         case ENOBUFS:
+         case ENOMEM:
+            // wait for resources to be released, rather than spin
+            f0printf(ferr(), "accept() failed: %s\n", strerror(errsv));
+            sleep(DAEMON_ACCEPT_RETRY_SECS);
+            break;
+         default:
+            f0printf(ferr(), "accept() failed: %s, terminating\n", strerror(errsv));
+            rc = EXIT_FAILURE;
+            terminate_requested = 1;
+         }
+         continue;
+      }
+      handle_connection(fd, executor);
+      close(fd);
+   }
+
+   close(listen_fd);
+   unlink(socket_name);
+   free(socket_name);
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %s", (rc == EXIT_SUCCESS) ? "EXIT_SUCCESS" : "EXIT_FAILURE");
+   return rc;
+}
+
+
+void init_app_daemon() {
+   RTTI_ADD_FUNC(app_daemon_forward_cmd);
+   RTTI_ADD_FUNC(app_daemon_serve);
+}
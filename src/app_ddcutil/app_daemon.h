@@ -0,0 +1,28 @@
+/** \file app_daemon.h
+  * Implement DAEMON command, and forwarding of commands to a running daemon
+  */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef APP_DAEMON_H_
+#define APP_DAEMON_H_
+
+#include <stdbool.h>
+
+#include "cmdline/parsed_cmd.h"
+
+/** Signature of function that executes a command received by the daemon
+ *
+ *  \param  parsed_cmd  parsed command
+ *  \return EXIT_SUCCESS or EXIT_FAILURE
+ */
+typedef int (*Daemon_Cmd_Executor)(Parsed_Cmd * parsed_cmd);
+
+char * app_daemon_socket_name();
+bool   app_daemon_is_forwardable(Parsed_Cmd * parsed_cmd);
+bool   app_daemon_forward_cmd(int argc, char ** argv, int * rc_loc);
+int    app_daemon_serve(Parsed_Cmd * parsed_cmd, Daemon_Cmd_Executor executor);
+void   init_app_daemon();
+
+#endif /* APP_DAEMON_H_ */
@@ -49,6 +49,7 @@
 #include "ddc/ddc_read_capabilities.h"
 #include "ddc/ddc_vcp.h"
 
+#include "app_ddcutil/app_concurrent.h"
 #include "app_ddcutil/app_dumpload.h"
 
 
@@ -234,6 +235,45 @@ read_vcp_file(const char * fn)
 }
 
 
+/* Apply the VCP settings read from a file.
+ *
+ * \param   fn          file name
+ * \param   pdata       data read from the file
+ * \param   dh          handle for open display, if NULL the display
+ *                      indicated in the data
+ * \return  true if load succeeded, false if not
+ */
+static bool loadvcp_by_file_data(const char * fn, Dumpload_Data * pdata, Display_Handle * dh) {
+   FILE * outf = fout();
+   bool debug = false;
+   DBGMSF(debug, "Starting. fn=%s, dh=%p %s", fn, dh, (dh) ? dh_repr(dh):"");
+
+   DDCA_Output_Level output_level = get_output_level();
+   bool verbose = (output_level >= DDCA_OL_VERBOSE);
+   Status_Errno_DDC ddcrc = 0;
+   Error_Info * ddc_excp = NULL;
+
+   if (verbose || debug) {
+      f0printf(outf, "Loading VCP settings for monitor \"%s\", sn \"%s\" from file: %s\n",
+                     pdata->model, pdata->serial_ascii, fn);
+      if (debug) {
+         rpt_push_output_dest(outf);
+         dbgrpt_dumpload_data(pdata, 0);
+         rpt_pop_output_dest();
+      }
+   }
+   ddc_excp = loadvcp_by_dumpload_data(pdata, dh);
+   if (ddc_excp) {
+      ddcrc = ddc_excp->status_code;
+      ERRINFO_FREE_WITH_REPORT(ddc_excp, debug || report_freed_exceptions);
+   }
+   bool ok = (ddcrc == 0);
+
+   DBGMSF(debug, "Returning: %s", sbool(ok));
+   return ok;
+}
+
+
 /* Apply the VCP settings stored in a file to the monitor
  * indicated in that file.
  *
@@ -243,45 +283,123 @@ read_vcp_file(const char * fn)
  */
 // TODO: convert to Status_Errno_DDC
 bool loadvcp_by_file(const char * fn, Display_Handle * dh) {
-   FILE * fout = stdout;
-   // FILE * ferr = stderr;
    bool debug = false;
    DBGMSF(debug, "Starting. fn=%s, dh=%p %s", fn, dh, (dh) ? dh_repr(dh):"");
 
-   DDCA_Output_Level output_level = get_output_level();
-   bool verbose = (output_level >= DDCA_OL_VERBOSE);
    bool ok = false;
-   Status_Errno_DDC ddcrc = 0;
-   Error_Info * ddc_excp = NULL;
-
    Dumpload_Data * pdata = read_vcp_file(fn);
    if (!pdata) {
       // Redundant, read_vcp_file() issues message:
       // f0printf(ferr, "Unable to load VCP data from file: %s\n", fn);
    }
    else {
-      if (verbose || debug) {
-           f0printf(fout, "Loading VCP settings for monitor \"%s\", sn \"%s\" from file: %s\n",
-                           pdata->model, pdata->serial_ascii, fn);
-           if (debug) {
-              rpt_push_output_dest(fout);
-              dbgrpt_dumpload_data(pdata, 0);
-              rpt_pop_output_dest();
-           }
-      }
-      ddc_excp = loadvcp_by_dumpload_data(pdata, dh);
-      if (ddc_excp) {
-         ddcrc = ddc_excp->status_code;
-         ERRINFO_FREE_WITH_REPORT(ddc_excp, debug || report_freed_exceptions);
-      }
+      ok = loadvcp_by_file_data(fn, pdata, dh);
       free_dumpload_data(pdata);
-      ok = (ddcrc == 0);
    }
 
    DBGMSF(debug, "Returning: %s", sbool(ok));
    return ok;
 }
 
+
+/** Files to be loaded to the same monitor, in the order specified */
+typedef struct {
+   Display_Ref *     dref;          // NULL if the monitor was not found
+   GPtrArray *       fns;
+   GPtrArray *       datas;         // Dumpload_Data read from each file
+} Loadvcp_Group;
+
+
+static void free_loadvcp_group(gpointer data) {
+   Loadvcp_Group * group = data;
+   g_ptr_array_free(group->fns, true);
+   g_ptr_array_free(group->datas, true);
+   free(group);
+}
+
+
+static bool loadvcp_group(gpointer item, gpointer arg) {
+   Loadvcp_Group * group = item;
+   bool ok = true;
+   for (int ndx = 0; ndx < group->fns->len; ndx++) {
+      if (!loadvcp_by_file_data(g_ptr_array_index(group->fns, ndx),
+                                g_ptr_array_index(group->datas, ndx),
+                                NULL))
+         ok = false;
+   }
+   return ok;
+}
+
+
+/** Returns the detected display to which the data in a file applies,
+ *  NULL if it is not connected.
+ */
+static Display_Ref * find_dumpload_data_dref(Dumpload_Data * pdata) {
+   // if the identifiers are all missing, loadvcp_by_dumpload_data() reports the error
+   if ( strlen(pdata->mfg_id) + strlen(pdata->model) + strlen(pdata->serial_ascii) == 0)
+      return NULL;
+   Display_Identifier * did = create_mfg_model_sn_display_identifier(
+                          pdata->mfg_id,
+                          pdata->model,
+                          pdata->serial_ascii);
+   Display_Ref * dref = get_display_ref_for_display_identifier(did, CALLOPT_NONE);
+   free_display_identifier(did);
+   return dref;
+}
+
+
+/** Applies the VCP settings stored in multiple files, each to the monitor
+ *  indicated in that file.
+ *
+ *  The files are grouped by monitor.  The groups are loaded concurrently
+ *  using the worker pool, while the files for a single monitor are loaded
+ *  in the order specified, so that the values in the last file prevail.
+ *  Messages are reported by group once all have been loaded.
+ *
+ * \param   fns   array of file names
+ * \param   fnct  number of file names
+ * \return  true if all loads succeeded, false if not
+ */
+bool loadvcp_by_files(char ** fns, int fnct) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "fnct=%d", fnct);
+
+   bool ok = true;
+   GPtrArray * groups = g_ptr_array_new_with_free_func(free_loadvcp_group);
+   for (int ndx = 0; ndx < fnct; ndx++) {
+      Dumpload_Data * pdata = read_vcp_file(fns[ndx]);   // reports any error
+      if (!pdata) {
+         ok = false;
+         continue;
+      }
+      Display_Ref * dref = find_dumpload_data_dref(pdata);
+      Loadvcp_Group * group = NULL;
+      for (int gndx = 0; dref && gndx < groups->len; gndx++) {
+         Loadvcp_Group * cur = g_ptr_array_index(groups, gndx);
+         if (cur->dref == dref)
+            group = cur;
+      }
+      if (!group) {
+         group = calloc(1, sizeof(Loadvcp_Group));
+         group->dref  = dref;
+         group->fns   = g_ptr_array_new();
+         group->datas = g_ptr_array_new_with_free_func((GDestroyNotify) free_dumpload_data);
+         g_ptr_array_add(groups, group);
+      }
+      g_ptr_array_add(group->fns, fns[ndx]);
+      g_ptr_array_add(group->datas, pdata);
+   }
+   DBGTRC_NOPREFIX(debug, TRACE_GROUP, "%d groups", groups->len);
+
+   if (!app_execute_concurrently(groups, loadvcp_group, NULL, NULL))
+      ok = false;
+   g_ptr_array_free(groups, true);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning: %s", sbool(ok));
+   return ok;
+}
+
+
 #ifdef UNUSED
 bool app_loadvcp(const char * fn, Display_Identifier * pdid) {
    bool debug = false;
@@ -317,5 +435,6 @@ bool app_loadvcp(const char * fn, Display_Identifier * pdid) {
 
 void init_app_dumpload() {
    RTTI_ADD_FUNC(dumpvcp_as_file);
+   RTTI_ADD_FUNC(loadvcp_by_files);
 }
 
@@ -13,6 +13,7 @@
 #include <base/status_code_mgt.h>
 
 bool loadvcp_by_file(const char * fn, Display_Handle * dh);
+bool loadvcp_by_files(char ** fns, int fnct);
 
 Status_Errno_DDC dumpvcp_as_file(Display_Handle * dh, const char * optional_filename);
 
@@ -204,6 +204,7 @@ void test_display_detection_variants() {
        I2C_Read_Bytewise        = false;       //      cur.i2c_read_bytewise;
        EDID_Read_Bytewise       = cur.edid_read_bytewise;
        EDID_Read_Size           = cur.edid_read_size;
+       EDID_Read_Uses_Sysfs     = false;   // measure the I2C read strategy
        assert(EDID_Read_Size == 128 || EDID_Read_Size == 256 || EDID_Read_Size == 0);
 
        // discard existing detected monitors
@@ -76,10 +76,10 @@ app_show_single_vcp_value_by_feature_table_entry(
       char * feature_name =  get_version_sensitive_feature_name(entry, vspec);
       DDCA_Version_Feature_Flags vflags = get_version_sensitive_feature_flags(entry, vspec);
       if (vflags & DDCA_DEPRECATED)
-         printf("Feature %02x (%s) is deprecated in MCCS %d.%d\n",
+         f0printf(fout(), "Feature %02x (%s) is deprecated in MCCS %d.%d\n",
                 feature_id, feature_name, vspec.major, vspec.minor);
       else
-         printf("Feature %02x (%s) is not readable\n", feature_id, feature_name);
+         f0printf(fout(), "Feature %02x (%s) is not readable\n", feature_id, feature_name);
       psc = DDCRC_INVALID_OPERATION;
    }
 
@@ -91,9 +91,9 @@ app_show_single_vcp_value_by_feature_table_entry(
                false,      /* suppress_unsupported */
                true,       /* prefix_value_with_feature_code */
                &formatted_value,
-               stdout);    /* msg_fh */
+               fout());    /* msg_fh */
       if (formatted_value) {
-         printf("%s\n", formatted_value);
+         f0printf(fout(), "%s\n", formatted_value);
          free(formatted_value);
       }
    }
@@ -133,10 +133,10 @@ app_show_single_vcp_value_by_dfm(
       DDCA_Feature_Flags vflags = dfm->feature_flags;
       // should get vcp version from metadata
       if (vflags & DDCA_DEPRECATED)
-         printf("Feature %02x (%s) is deprecated in MCCS %d.%d\n",
+         f0printf(fout(), "Feature %02x (%s) is deprecated in MCCS %d.%d\n",
                 feature_id, feature_name, vspec.major, vspec.minor);
       else
-         printf("Feature %02x (%s) is not readable\n", feature_id, feature_name);
+         f0printf(fout(), "Feature %02x (%s) is not readable\n", feature_id, feature_name);
       ddcrc = DDCRC_INVALID_OPERATION;
    }
 
@@ -148,9 +148,9 @@ app_show_single_vcp_value_by_dfm(
                false,      /* suppress_unsupported */
                true,       /* prefix_value_with_feature_code */
                &formatted_value,
-               stdout);    /* msg_fh */
+               fout());    /* msg_fh */
       if (formatted_value) {
-         printf("%s\n", formatted_value);
+         f0printf(fout(), "%s\n", formatted_value);
          free(formatted_value);
       }
    }
@@ -196,7 +196,7 @@ app_show_single_vcp_value_by_feature_id(
          );
 
    if (!dfm) {
-      printf("Unrecognized VCP feature code: 0x%02x\n", feature_id);
+      f0printf(fout(), "Unrecognized VCP feature code: 0x%02x\n", feature_id);
       psc = DDCRC_UNKNOWN_FEATURE;
    }
    else {
@@ -27,6 +27,7 @@
 #include "util/failsim.h"
 #include "util/file_util.h"
 #include "util/glib_string_util.h"
+#include "util/glib_util.h"
 #include "util/linux_util.h"
 #include "util/report_util.h"
 #include "util/simple_ini_file.h"
@@ -74,6 +75,7 @@
 #endif
 
 #include "ddc/ddc_displays.h"
+#include "ddc/ddc_dumpload.h"
 #include "ddc/ddc_multi_part_io.h"
 #include "ddc/ddc_output.h"
 #include "ddc/ddc_packet_io.h"
@@ -90,6 +92,8 @@
 #include "test/testcases.h"
 
 #include "app_ddcutil/app_capabilities.h"
+#include "app_ddcutil/app_concurrent.h"
+#include "app_ddcutil/app_daemon.h"
 #include "app_ddcutil/app_dynamic_features.h"
 #include "app_ddcutil/app_dumpload.h"
 #include "app_ddcutil/app_experimental.h"
@@ -287,7 +291,7 @@ ensure_vcp_version_set(Display_Handle * dh)
    DBGMSF(debug, "Starting. dh=%s", dh_repr(dh));
    DDCA_MCCS_Version_Spec vspec = get_vcp_version_by_dh(dh);
    if (vspec.major < 2 && get_output_level() >= DDCA_OL_NORMAL) {
-      f0printf(stdout, "VCP (aka MCCS) version for display is undetected or less than 2.0. "
+      f0printf(fout(), "VCP (aka MCCS) version for display is undetected or less than 2.0. "
             "Output may not be accurate.\n");
    }
    DBGMSF(debug, "Done");
@@ -453,10 +457,17 @@ execute_cmd_with_optional_display_handle(
          // ensure_vcp_version_set();
 
          tsd_dsa_enable(parsed_cmd->flags & CMD_FLAG_DSA);
+         ddc_enable_differential_loadvcp(parsed_cmd->flags & CMD_FLAG_DIFFERENTIAL);
          // loadvcp will search monitors to find the one matching the
          // identifiers in the record
          ddc_ensure_displays_detected();
-         bool loadvcp_ok = loadvcp_by_file(parsed_cmd->args[0], dh);
+         bool loadvcp_ok = false;
+         if (parsed_cmd->argct == 1)
+            loadvcp_ok = loadvcp_by_file(parsed_cmd->args[0], dh);
+         else if (dh)
+            f0printf(ferr(), "Only one file can be loaded when a display is specified\n");
+         else
+            loadvcp_ok = loadvcp_by_files(parsed_cmd->args, parsed_cmd->argct);
          main_rc = (loadvcp_ok) ? EXIT_SUCCESS : EXIT_FAILURE;
          break;
       }
@@ -564,6 +575,213 @@ execute_cmd_with_optional_display_handle(
 }
 
 
+/** Command executed on each of several displays */
+typedef struct {
+   Parsed_Cmd *      parsed_cmd;
+   Call_Options      callopts;
+} Multi_Display_Cmd;
+
+
+static bool
+execute_cmd_on_one_of_multiple_displays(gpointer item, gpointer arg) {
+   bool debug = false;
+   Display_Ref *       dref = item;
+   Multi_Display_Cmd * cmd  = arg;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dref=%s", dref_repr_t(dref));
+
+   int main_rc = EXIT_FAILURE;
+   Display_Handle * dh = NULL;
+   Status_Errno_DDC ddcrc = ddc_open_display(dref, cmd->callopts | CALLOPT_ERR_MSG, &dh);
+   if (!dh) {
+      f0printf(ferr(), "Error %s opening display ref %s\n", psc_desc(ddcrc), dref_repr_t(dref));
+   }
+   else {
+      main_rc = execute_cmd_with_optional_display_handle(cmd->parsed_cmd, dh);
+      ddc_close_display(dh);
+   }
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %d", main_rc);
+   return (main_rc == EXIT_SUCCESS);
+}
+
+
+static void
+report_display_heading(gpointer item, FILE * outf) {
+   Display_Ref * dref = item;
+   f0printf(outf, "Display %d\n", dref->dispno);
+}
+
+
+/** Executes a command on each display selected by option --display, when
+ *  it specifies a list of display numbers or "all".
+ *
+ *  The command is executed concurrently on the displays, each with its own
+ *  display handle.  The output for each display is reported in display
+ *  number order once all have completed.
+ *
+ *  \param parsed_cmd  parsed command line
+ *  \param callopts    call options
+ *  \retval EXIT_SUCCESS command succeeded on all displays
+ *  \retval EXIT_FAILURE otherwise
+ */
+static int
+execute_cmd_with_multiple_display_refs(
+      Parsed_Cmd *     parsed_cmd,
+      Call_Options     callopts)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "%s", cmdid_name(parsed_cmd->cmd_id));
+   int main_rc = EXIT_SUCCESS;
+
+   switch(parsed_cmd->cmd_id) {
+   case CMDID_GETVCP:
+   case CMDID_SETVCP:
+   case CMDID_CAPABILITIES:
+   case CMDID_SAVE_SETTINGS:
+      break;
+   default:
+      f0printf(ferr(), "Command %s cannot be executed on multiple displays\n",
+                       cmdid_name(parsed_cmd->cmd_id));
+      main_rc = EXIT_FAILURE;
+   }
+
+   GPtrArray * drefs = NULL;
+   if (main_rc == EXIT_SUCCESS) {
+      ddc_ensure_displays_detected();
+      if (parsed_cmd->flags & CMD_FLAG_ALL_DISPLAYS) {
+         drefs = ddc_get_display_refs_for_display_identifier(parsed_cmd->pdid);
+         if (drefs->len == 0) {
+            f0printf(ferr(), "No matching displays found\n");
+            main_rc = EXIT_FAILURE;
+         }
+      }
+      else {
+         drefs = g_ptr_array_new();
+         for (int ndx = 0; ndx < parsed_cmd->dispnos->len; ndx++) {
+            int dispno = g_array_index(parsed_cmd->dispnos, int, ndx);
+            Display_Identifier * did = create_dispno_display_identifier(dispno);
+            Display_Ref * dref = get_display_ref_for_display_identifier(did, CALLOPT_NONE);
+            free_display_identifier(did);
+            if (!dref) {
+               f0printf(ferr(), "Display %d not found\n", dispno);
+               main_rc = EXIT_FAILURE;
+            }
+            // a display specified more than once is only used once
+            else if (!gaux_ptr_array_find_with_equal_func(drefs, dref, NULL, NULL))
+               g_ptr_array_add(drefs, dref);
+         }
+      }
+   }
+
+   if (main_rc == EXIT_SUCCESS) {
+      // affects all current threads and new threads
+      tsd_dsa_enable_globally(parsed_cmd->flags & CMD_FLAG_DSA);
+
+      Multi_Display_Cmd cmd = {parsed_cmd, callopts};
+      bool ok = app_execute_concurrently(
+                   drefs, execute_cmd_on_one_of_multiple_displays, &cmd, report_display_heading);
+      if (!ok)
+         main_rc = EXIT_FAILURE;
+   }
+   if (drefs)
+      g_ptr_array_free(drefs, true);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %d", main_rc);
+   return main_rc;
+}
+
+
+/** Locates the display specified on the command line, opens it, and executes
+ *  a command that requires a display or for which a display is optional.
+ *
+ *  \param parsed_cmd  parsed command line
+ *  \param callopts    call options
+ *  \retval EXIT_SUCCESS
+ *  \retval EXIT_FAILURE
+ */
+static int
+execute_cmd_with_display_ref(
+      Parsed_Cmd *     parsed_cmd,
+      Call_Options     callopts)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "%s", cmdid_name(parsed_cmd->cmd_id));
+   int main_rc = EXIT_SUCCESS;
+
+   if ( (parsed_cmd->flags & CMD_FLAG_ALL_DISPLAYS) || parsed_cmd->dispnos) {
+      main_rc = execute_cmd_with_multiple_display_refs(parsed_cmd, callopts);
+      DBGTRC_DONE(debug, TRACE_GROUP, "Returning %d", main_rc);
+      return main_rc;
+   }
+
+   Display_Ref * dref = NULL;
+   Status_Errno_DDC  rc =
+   find_dref(parsed_cmd,
+            (parsed_cmd->cmd_id == CMDID_LOADVCP) ? DISPLAY_ID_OPTIONAL : DISPLAY_ID_REQUIRED,
+            &dref);
+   if (rc != DDCRC_OK) {
+      main_rc = EXIT_FAILURE;
+   }
+   else {
+      Display_Handle * dh = NULL;
+      if (dref) {
+         DBGMSF(debug,
+                "display detection complete, about to call ddc_open_display() for dref" );
+         Status_Errno_DDC ddcrc = ddc_open_display(dref, callopts |CALLOPT_ERR_MSG, &dh);
+         ASSERT_IFF( (ddcrc==0), dh);
+         if (!dh) {
+            f0printf(ferr(), "Error %s opening display ref %s", psc_desc(ddcrc), dref_repr_t(dref));
+            main_rc = EXIT_FAILURE;
+         }
+      }  // dref
+
+      if (main_rc == EXIT_SUCCESS) {
+         // affects all current threads and new threads
+         tsd_dsa_enable_globally(parsed_cmd->flags & CMD_FLAG_DSA);
+         main_rc = execute_cmd_with_optional_display_handle(parsed_cmd, dh);
+      }
+
+      if (dh)
+            ddc_close_display(dh);
+      if (dref && (dref->flags & DREF_TRANSIENT))
+         free_display_ref(dref);
+   }
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %d", main_rc);
+   return main_rc;
+}
+
+
+/** Executes a command received by the DAEMON command.
+ *
+ *  Displays are detected when the daemon starts.  The DETECT command
+ *  repeats detection, so that displays connected or disconnected since
+ *  are recognized.
+ *
+ *  \param parsed_cmd  parsed command
+ *  \retval EXIT_SUCCESS
+ *  \retval EXIT_FAILURE
+ */
+static int
+execute_daemon_request(Parsed_Cmd * parsed_cmd) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "%s", cmdid_name(parsed_cmd->cmd_id));
+   int main_rc = EXIT_SUCCESS;
+
+   if (parsed_cmd->cmd_id == CMDID_DETECT) {
+      ddc_redetect_displays();
+      ddc_report_displays(/*include_invalid_displays=*/ true, 0);
+   }
+   else {
+      Call_Options callopts = (parsed_cmd->flags & CMD_FLAG_FORCE) ? CALLOPT_FORCE : CALLOPT_NONE;
+      main_rc = execute_cmd_with_display_ref(parsed_cmd, callopts);
+   }
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %d", main_rc);
+   return main_rc;
+}
+
+
 //
 // Mainline
 //
@@ -636,6 +854,13 @@ main(int argc, char *argv[]) {
 
    parsed_cmd = parse_command(new_argc, new_argv, MODE_DDCUTIL);
    DBGMSF(main_debug, "parse_command() returned %p", parsed_cmd);
+   if (parsed_cmd && app_daemon_is_forwardable(parsed_cmd) &&
+       app_daemon_forward_cmd(new_argc, new_argv, &main_rc))
+   {
+      // executed by a running daemon, skip initialization
+      ntsa_free(new_argv, true);
+      goto bye;
+   }
    ntsa_free(new_argv, true);
 
    if (!parsed_cmd) {
@@ -775,42 +1000,17 @@ main(int argc, char *argv[]) {
    }
 #endif
 
+   else if (parsed_cmd->cmd_id == CMDID_DAEMON) {
+      DBGTRC_NOPREFIX(main_debug, TRACE_GROUP, "Processing command DAEMON...");
+      detect_ddcci(parsed_cmd);
+      ddc_ensure_displays_detected();
+      main_rc = app_daemon_serve(parsed_cmd, execute_daemon_request);
+   }
+
    // *** Commands that may require Display Identifier ***
    else {
       detect_ddcci(parsed_cmd);
-
-      Display_Ref * dref = NULL;
-      Status_Errno_DDC  rc =
-      find_dref(parsed_cmd,
-               (parsed_cmd->cmd_id == CMDID_LOADVCP) ? DISPLAY_ID_OPTIONAL : DISPLAY_ID_REQUIRED,
-               &dref);
-      if (rc != DDCRC_OK) {
-         main_rc = EXIT_FAILURE;
-      }
-      else {
-         Display_Handle * dh = NULL;
-         if (dref) {
-            DBGMSF(main_debug,
-                   "mainline - display detection complete, about to call ddc_open_display() for dref" );
-            Status_Errno_DDC ddcrc = ddc_open_display(dref, callopts |CALLOPT_ERR_MSG, &dh);
-            ASSERT_IFF( (ddcrc==0), dh);
-            if (!dh) {
-               f0printf(ferr(), "Error %s opening display ref %s", psc_desc(ddcrc), dref_repr_t(dref));
-               main_rc = EXIT_FAILURE;
-            }
-         }  // dref
-
-         if (main_rc == EXIT_SUCCESS) {
-            // affects all current threads and new threads
-            tsd_dsa_enable_globally(parsed_cmd->flags & CMD_FLAG_DSA);
-            main_rc = execute_cmd_with_optional_display_handle(parsed_cmd, dh);
-         }
-
-         if (dh)
-               ddc_close_display(dh);
-         if (dref && (dref->flags & DREF_TRANSIENT))
-            free_display_ref(dref);
-      }
+      main_rc = execute_cmd_with_display_ref(parsed_cmd, callopts);
    }
 
    if (parsed_cmd->stats_types != DDCA_STATS_NONE
@@ -837,6 +1037,7 @@ bye:
 
    if (parsed_cmd)
       free_parsed_cmd(parsed_cmd);
+   release_ddc_services();
    release_base_services();
    if (trace_to_syslog) {
       syslog(LOG_INFO, "Terminating. Returning %d", main_rc);
@@ -850,9 +1051,15 @@ static void add_rtti_functions() {
    RTTI_ADD_FUNC(main);
    RTTI_ADD_FUNC(execute_cmd_with_optional_display_handle);
    RTTI_ADD_FUNC(find_dref);
+   RTTI_ADD_FUNC(execute_cmd_with_display_ref);
+   RTTI_ADD_FUNC(execute_cmd_with_multiple_display_refs);
+   RTTI_ADD_FUNC(execute_cmd_on_one_of_multiple_displays);
+   RTTI_ADD_FUNC(execute_daemon_request);
 #ifdef ENABLE_ENVCMDS
    RTTI_ADD_FUNC(interrogate);
 #endif
    init_app_capabilities();
+   init_app_concurrent();
+   init_app_daemon();
    init_app_dumpload();
 }
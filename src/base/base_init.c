@@ -13,7 +13,9 @@
 #include "execution_stats.h"
 #include "linux_errno.h"
 #include "per_thread_data.h"
+#include "persistent_sleep_data.h"
 #include "sleep.h"
+#include "worker_pool.h"
 
 #include "base_init.h"
 
@@ -32,10 +34,13 @@ void init_base_services() {
    init_thread_data_module();
    init_displays();
    init_ddc_packets();
+   init_persistent_sleep_data();
+   init_worker_pool();
    if (debug)
       printf("(%s) Done\n", __func__);
 }
 
 void release_base_services() {
+   terminate_worker_pool();
    release_thread_data_module();
 }
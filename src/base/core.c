@@ -180,6 +180,20 @@ DDCA_Trace_Group trace_class_name_to_value(char * name) {
 
 static DDCA_Trace_Group trace_levels = DDCA_TRC_NONE;   // 0x00
 
+static GPtrArray  * traced_function_table = NULL;
+static GPtrArray  * traced_file_table     = NULL;
+
+/** Set if any trace group, function, or file is being traced.
+ *  Tested by the DBGTRC macros before evaluating their arguments.
+ */
+bool dbgtrc_any_active = false;
+
+static void set_dbgtrc_any_active() {
+   dbgtrc_any_active = trace_levels != DDCA_TRC_NONE ||
+                       (traced_function_table && traced_function_table->len > 0) ||
+                       (traced_file_table     && traced_file_table->len     > 0);
+}
+
 /** Replaces the groups to be traced.
  *
  * @param trace_flags bit flags indicating groups to trace
@@ -191,6 +205,7 @@ void set_trace_groups(DDCA_Trace_Group trace_flags) {
    DBGMSF(debug, "trace_flags=0x%04x\n", trace_flags);
 
    trace_levels = trace_flags;
+   set_dbgtrc_any_active();
 }
 
 
@@ -205,6 +220,7 @@ void add_trace_groups(DDCA_Trace_Group trace_flags) {
    DBGMSF(debug, "trace_flags=0x%04x\n", trace_flags);
 
    trace_levels |= trace_flags;
+   set_dbgtrc_any_active();
 }
 
 
@@ -213,8 +229,24 @@ void add_trace_groups(DDCA_Trace_Group trace_flags) {
 // are used only for testing and (b) there will be at most a handful of entries in the
 // tables, a simpler GPtrArray implementation is used.
 
-static GPtrArray  * traced_function_table = NULL;
-static GPtrArray  * traced_file_table     = NULL;
+// Results of looking up function and file names in traced_function_table and
+// traced_file_table, keyed by the address of the __func__ or __FILE__ string
+// passed to is_tracing().  Values are LOOKUP_TRACED or LOOKUP_NOT_TRACED.
+// The caches are discarded whenever a function or file is added to the tables.
+static GHashTable * traced_function_cache = NULL;
+static GHashTable * traced_file_cache     = NULL;
+static GMutex       traced_cache_mutex;
+#define LOOKUP_NOT_TRACED GINT_TO_POINTER(1)
+#define LOOKUP_TRACED     GINT_TO_POINTER(2)
+
+static void clear_traced_caches() {
+   g_mutex_lock(&traced_cache_mutex);
+   if (traced_function_cache)
+      g_hash_table_remove_all(traced_function_cache);
+   if (traced_file_cache)
+      g_hash_table_remove_all(traced_file_cache);
+   g_mutex_unlock(&traced_cache_mutex);
+}
 
 
 /** Adds a function to the list of functions to be traced.
@@ -232,6 +264,8 @@ void add_traced_function(const char * funcname) {
    bool missing = (gaux_string_ptr_array_find(traced_function_table, funcname) < 0);
    if (missing)
       g_ptr_array_add(traced_function_table, g_strdup(funcname));
+   clear_traced_caches();
+   set_dbgtrc_any_active();
 
    if (debug)
       printf("(%s) Done. funcname=|%s|, missing=%s\n",
@@ -272,6 +306,8 @@ void add_traced_file(const char * filename) {
       g_ptr_array_add(traced_file_table, bname);
    else
       free(bname);
+   clear_traced_caches();
+   set_dbgtrc_any_active();
    if (debug)
       printf("(%s) Done. filename=|%s|, bname=|%s|, missing=%s\n",
              __func__, filename, bname, SBOOL(missing));
@@ -404,6 +440,41 @@ void close_syslog() {
 
 
 
+// Looks up the result for a name in a cache, computing it if necessary.
+// must be called with traced_cache_mutex held
+static bool cached_lookup(GHashTable ** cache_loc, const char * name, bool (*lookup_func)(const char *)) {
+   if (!name)
+      return false;
+   if (!*cache_loc)
+      *cache_loc = g_hash_table_new(g_direct_hash, g_direct_equal);
+   gpointer val = g_hash_table_lookup(*cache_loc, name);
+   if (!val) {
+      val = (lookup_func(name)) ? LOOKUP_TRACED : LOOKUP_NOT_TRACED;
+      g_hash_table_insert(*cache_loc, (gpointer) name, val);
+   }
+   return val == LOOKUP_TRACED;
+}
+
+
+/** Checks if a function, or the file containing it, is being traced.
+ *
+ *  Unlike #is_traced_function() and #is_traced_file(), results are cached
+ *  by string address, so the names should be the __func__ and __FILE__ values
+ *  of a call site, whose addresses do not change.
+ *
+ *  @param funcname function name
+ *  @param filename file name
+ *  @return **true** if the function or file is being traced, **false** if not
+ */
+static bool is_traced_function_or_file_cached(const char * funcname, const char * filename) {
+   g_mutex_lock(&traced_cache_mutex);
+   bool result = cached_lookup(&traced_function_cache, funcname, is_traced_function) ||
+                 cached_lookup(&traced_file_cache,     filename, is_traced_file);
+   g_mutex_unlock(&traced_cache_mutex);
+   return result;
+}
+
+
 /** Checks if a tracing is to be performed.
  *
  * Tracing is enabled if any of the following tests pass:
@@ -425,6 +496,8 @@ void close_syslog() {
  *   Commonly, if debugging is active in a given location, the trace_group value
  *   being checked can be set to TRC_ALWAYS, so a site can have a single debug/trace
  *   function call.
+ * - Function and file name lookups are cached by string address, so **filename**
+ *   and **funcname** should be the __FILE__ and __func__ values of the caller.
  *
  * @ingroup dbgtrace
  *
@@ -437,7 +510,8 @@ bool is_tracing(DDCA_Trace_Group trace_group, const char * filename, const char
 
    bool result =  (trace_group == DDCA_TRC_ALL) || (trace_levels & trace_group); // is trace_group being traced?
 
-   result = result || is_traced_function(funcname) || is_traced_file(filename);
+   if (!result && (traced_function_table || traced_file_table))
+      result = is_traced_function_or_file_cached(funcname, filename);
 
    if (debug)
       printf("(%s) Done.     trace_group=0x%04x, filename=%s, funcname=%s, trace_levels=0x%04x, returning %d\n",
@@ -85,6 +85,7 @@ typedef struct {
 extern bool dbgtrc_show_time;       // prefix debug/trace messages with elapsed time
 extern bool dbgtrc_show_wall_time;  // prefix debug/trace messages with wall time
 extern bool dbgtrc_show_thread_id;  // prefix debug/trace messages with thread id
+extern bool dbgtrc_any_active;      // any trace group, function, or file is traced
 
 void set_libddcutil_output_destination(const char * filename, const char * traced_unit);
 void add_traced_function(const char * funcname);
@@ -109,14 +110,17 @@ bool is_tracing(DDCA_Trace_Group trace_group, const char * filename, const char
  *  Wrappers call to **is_tracing()**, using the current **TRACE_GROUP** value,
  *  filename, and function as implicit arguments.
  */
-#define IS_TRACING() is_tracing(TRACE_GROUP, __FILE__, __func__)
+#define IS_TRACING() \
+    ( dbgtrc_any_active && is_tracing(TRACE_GROUP, __FILE__, __func__) )
 
-#define IS_TRACING_GROUP(grp) is_tracing((grp), __FILE__, __func__)
+#define IS_TRACING_GROUP(grp) \
+    ( dbgtrc_any_active && is_tracing((grp), __FILE__, __func__) )
 
-#define IS_TRACING_BY_FUNC_OR_FILE() is_tracing(DDCA_TRC_NONE, __FILE__, __func__)
+#define IS_TRACING_BY_FUNC_OR_FILE() \
+    ( dbgtrc_any_active && is_tracing(DDCA_TRC_NONE, __FILE__, __func__) )
 
 #define IS_DBGTRC(debug_flag, group) \
-    ( (debug_flag)  || is_tracing((group), __FILE__, __func__) )
+    ( (debug_flag)  || IS_TRACING_GROUP(group) )
 
 typedef uint16_t Dbgtrc_Options;
 #define DBGTRC_OPTIONS_NONE   0
@@ -298,39 +302,50 @@ bool dbgtrc_returning_expression(
 
 // For messages that are issued either if tracing is enabled for the appropriate trace group or
 // if a debug flag is set.
+// Unless the debug flag is set or some tracing is active, the message arguments are not evaluated
+// and dbgtrc() is not called.
+#define DBGTRC_MAYBE(debug_flag) ( (debug_flag) || dbgtrc_any_active )
+
 #define DBGTRC(debug_flag, trace_group, format, ...) \
-    dbgtrc( ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), DBGTRC_OPTIONS_NONE, __func__, __LINE__, __FILE__, format, ##__VA_ARGS__)
+    do { if (DBGTRC_MAYBE(debug_flag)) \
+    dbgtrc( ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), DBGTRC_OPTIONS_NONE, __func__, __LINE__, __FILE__, format, ##__VA_ARGS__); } while(0)
 
 #define DBGTRC_SYSLOG(debug_flag, trace_group, format, ...) \
     dbgtrc( ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), DBGTRC_OPTIONS_SYSLOG, __func__, __LINE__, __FILE__, format, ##__VA_ARGS__)
 
 #define DBGTRC_STARTING(debug_flag, trace_group, format, ...) \
-    dbgtrc( ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), DBGTRC_OPTIONS_NONE, __func__, __LINE__, __FILE__, "Starting  "format, ##__VA_ARGS__)
+    do { if (DBGTRC_MAYBE(debug_flag)) \
+    dbgtrc( ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), DBGTRC_OPTIONS_NONE, __func__, __LINE__, __FILE__, "Starting  "format, ##__VA_ARGS__); } while(0)
 
 #define DBGTRC_DONE(debug_flag, trace_group, format, ...) \
-    dbgtrc( ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), DBGTRC_OPTIONS_NONE, __func__, __LINE__, __FILE__, "Done      "format, ##__VA_ARGS__)
+    do { if (DBGTRC_MAYBE(debug_flag)) \
+    dbgtrc( ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), DBGTRC_OPTIONS_NONE, __func__, __LINE__, __FILE__, "Done      "format, ##__VA_ARGS__); } while(0)
 
 #define DBGTRC_NOPREFIX(debug_flag, trace_group, format, ...) \
-    dbgtrc( ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), DBGTRC_OPTIONS_NONE, __func__, __LINE__, __FILE__, "          "format, ##__VA_ARGS__)
+    do { if (DBGTRC_MAYBE(debug_flag)) \
+    dbgtrc( ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), DBGTRC_OPTIONS_NONE, __func__, __LINE__, __FILE__, "          "format, ##__VA_ARGS__); } while(0)
 
 #define DBGTRC_RETURNING(debug_flag, trace_group, rc, format, ...) \
+    do { if (DBGTRC_MAYBE(debug_flag)) \
     dbgtrc_returning( \
           ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), \
           DBGTRC_OPTIONS_NONE, \
           __func__, __LINE__, __FILE__, \
-          rc, format, ##__VA_ARGS__)
+          rc, format, ##__VA_ARGS__); } while(0)
 
 #define DBGTRC_RET_BOOL(debug_flag, trace_group, bool_result, format, ...) \
+    do { if (DBGTRC_MAYBE(debug_flag)) \
     dbgtrc_returning_expression( \
           ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), \
           DBGTRC_OPTIONS_NONE, \
-          __func__, __LINE__, __FILE__, SBOOL(bool_result), format, ##__VA_ARGS__)
+          __func__, __LINE__, __FILE__, SBOOL(bool_result), format, ##__VA_ARGS__); } while(0)
 
 #define DBGTRC_RET_ERRINFO(debug_flag, trace_group, errinfo_result, format, ...) \
+    do { if (DBGTRC_MAYBE(debug_flag)) \
     dbgtrc_returning_errinfo( \
           ( (debug_flag) ) ? DDCA_TRC_ALL : (trace_group), \
           DBGTRC_OPTIONS_NONE, \
-          __func__, __LINE__, __FILE__, errinfo_result, format, ##__VA_ARGS__)
+          __func__, __LINE__, __FILE__, errinfo_result, format, ##__VA_ARGS__); } while(0)
 
 
 // typedef (*dbg_struct_func)(void * structptr, int depth);
@@ -345,7 +360,7 @@ if (_flag) { \
 }
 
 #define DBGTRC_RET_STRUCT(_flag, _trace_group, _structname, _dbgfunc, _structptr) \
-if ( (_flag) || (is_tracing(_trace_group, __FILE__, __func__)) ) { \
+if ( IS_DBGTRC(_flag, _trace_group) ) { \
    dbgtrc(DDCA_TRC_ALL, DBGTRC_OPTIONS_NONE, \
           __func__, __LINE__, __FILE__, \
           "Returning %s at %p", #_structname, _structptr); \
@@ -60,6 +60,7 @@ static Status_Code_Info ddcrc_info[] = {
       EDENTRY(DDCRC_BAD_DATA                 , "invalid data"),
    // EDENTRY(DDCRC_CAP_FATAL                , "incorrect, unusable capabilities string"),
    // EDENTRY(DDCRC_CAP_WARNING              , "errors in capabilities string, but usable")
+      EDENTRY(DDCRC_PENDING                  , "asynchronous operation not complete"),
     };
 
 #undef EDENTRY
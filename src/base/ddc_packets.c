@@ -9,6 +9,7 @@
 #include <config.h>
 
 #include <assert.h>
+#include <glib-2.0/glib.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,6 +22,7 @@
 #include "base/core.h"
 #include "base/ddc_errno.h"
 #include "base/execution_stats.h"
+#include "base/parms.h"
 #include "base/rtti.h"
 
 #include "base/ddc_packets.h"
@@ -201,6 +203,44 @@ bool isNullPacket(DDC_Packet * packet) {
 }
 
 
+//
+// Packet pool
+//
+// Each get or set VCP value operation creates a request packet and usually a
+// response packet.  Rather than allocating each packet and its buffer, and
+// freeing them again, a few freed packets are kept on a per-thread list for
+// reuse, so that steady state packet I/O performs no heap allocation.
+//
+
+typedef struct {
+   int          ct;
+   DDC_Packet * packets[DDC_PACKET_POOL_SIZE];
+} Packet_Pool;
+
+static void free_packet_memory(DDC_Packet * packet) {
+   buffer_free(packet->raw_bytes, "free DDC packet");
+   free(packet);
+}
+
+static void free_packet_pool(gpointer data) {
+   Packet_Pool * pool = data;
+   for (int ndx = 0; ndx < pool->ct; ndx++)
+      free_packet_memory(pool->packets[ndx]);
+   free(pool);
+}
+
+static Packet_Pool * get_thread_packet_pool() {
+   static GPrivate packet_pool_key = G_PRIVATE_INIT(free_packet_pool);
+
+   Packet_Pool * pool = g_private_get(&packet_pool_key);
+   if (!pool) {
+      pool = calloc(1, sizeof(Packet_Pool));
+      g_private_set(&packet_pool_key, pool);
+   }
+   return pool;
+}
+
+
 void free_ddc_packet(DDC_Packet * packet) {
    bool debug = false;
    DBGMSF(debug, "packet=%p", packet);
@@ -208,16 +248,19 @@ void free_ddc_packet(DDC_Packet * packet) {
    // dump_packet(packet);
 
    if (packet) {
-      if (packet->parsed.raw_parsed) {
-         DBGMSF(debug, "freeing packet->parsed.raw=%p", packet->parsed.raw_parsed);
-         free(packet->parsed.raw_parsed);
+      // parsed data, if any, is in packet->parsed_storage
+      Packet_Pool * pool = get_thread_packet_pool();
+      if (packet->raw_bytes->buffer_size == DDC_PACKET_POOL_BUFFER_SIZE &&
+          packet->raw_bytes->size_increment == 0 &&
+          pool->ct < DDC_PACKET_POOL_SIZE)
+      {
+         DBGMSF(debug, "returning packet=%p to pool", packet);
+         pool->packets[pool->ct++] = packet;
+      }
+      else {
+         DBGMSF(debug, "freeing packet=%p", packet);
+         free_packet_memory(packet);
       }
-
-      DBGMSF(debug, "calling free_buffer() for packet->buf=%p", packet->raw_bytes);
-      buffer_free(packet->raw_bytes, "free DDC packet");
-
-      DBGMSF(debug, "freeing packet=%p", packet);
-      free(packet);
    }
    DBGMSF(debug, "Done" );
 }
@@ -234,8 +277,24 @@ create_empty_ddc_packet(int max_size, const char * tag) {
    bool debug = false;
    DBGMSF(debug, "Starting. max_size=%d, tag=%s", max_size, (tag) ? tag : "(nil)");
 
-   DDC_Packet * packet = malloc(sizeof(DDC_Packet));
-   packet->raw_bytes = buffer_new(max_size, "empty DDC packet");
+   DDC_Packet * packet = NULL;
+   if (max_size <= DDC_PACKET_POOL_BUFFER_SIZE) {
+      Packet_Pool * pool = get_thread_packet_pool();
+      if (pool->ct > 0) {
+         packet = pool->packets[--pool->ct];
+         memset(packet->raw_bytes->bytes, 0, DDC_PACKET_POOL_BUFFER_SIZE);
+         packet->raw_bytes->len = 0;
+      }
+      else {
+         // allocate the pool size so the packet can be reused
+         packet = malloc(sizeof(DDC_Packet));
+         packet->raw_bytes = buffer_new(DDC_PACKET_POOL_BUFFER_SIZE, "empty DDC packet");
+      }
+   }
+   else {
+      packet = malloc(sizeof(DDC_Packet));
+      packet->raw_bytes = buffer_new(max_size, "empty DDC packet");
+   }
    if (tag) {
       strncpy(packet->tag, tag, sizeof(packet->tag));  // no need to check if packet->tag truncated
       packet->tag[sizeof(packet->tag)-1] = '\0';
@@ -915,7 +974,8 @@ create_ddc_typed_response_packet(
       case DDC_PACKET_TYPE_CAPABILITIES_RESPONSE:
       case DDC_PACKET_TYPE_TABLE_READ_RESPONSE:
          {
-            Interpreted_Multi_Part_Read_Fragment * aux_data = calloc(1, sizeof(Interpreted_Multi_Part_Read_Fragment));
+            Interpreted_Multi_Part_Read_Fragment * aux_data = &packet->parsed_storage.multi_part_read_fragment;
+            memset(aux_data, 0, sizeof(Interpreted_Multi_Part_Read_Fragment));
             packet->parsed.multi_part_read_fragment = aux_data;
             rc = interpret_multi_part_read_response(
                    expected_type,
@@ -927,7 +987,8 @@ create_ddc_typed_response_packet(
 
       case DDC_PACKET_TYPE_QUERY_VCP_RESPONSE:
          {
-            Parsed_Nontable_Vcp_Response * aux_data = calloc(1, sizeof(Parsed_Nontable_Vcp_Response));
+            Parsed_Nontable_Vcp_Response * aux_data = &packet->parsed_storage.nontable_response;
+            memset(aux_data, 0, sizeof(Parsed_Nontable_Vcp_Response));
             packet->parsed.nontable_response = aux_data;
             rc = interpret_vcp_feature_response_std(
                     get_data_start(packet),
@@ -993,7 +1054,8 @@ create_ddc_multi_part_read_response_packet(
          rc = COUNT_STATUS_CODE(DDCRC_DDC_DATA);    // was DDCRC_INVALID_DATA
       }
       else {
-         Interpreted_Multi_Part_Read_Fragment * aux_data = calloc(1, sizeof(Interpreted_Multi_Part_Read_Fragment));
+         Interpreted_Multi_Part_Read_Fragment * aux_data = &packet->parsed_storage.multi_part_read_fragment;
+         memset(aux_data, 0, sizeof(Interpreted_Multi_Part_Read_Fragment));
          packet->parsed.multi_part_read_fragment = aux_data;
 
          rc = interpret_multi_part_read_response(
@@ -1052,7 +1114,8 @@ create_ddc_getvcp_response_packet(
          rc = COUNT_STATUS_CODE(DDCRC_DDC_DATA);     // was DDCRC_INVALID_DATA
       }
       else {
-         Parsed_Nontable_Vcp_Response * aux_data = calloc(1, sizeof(Parsed_Nontable_Vcp_Response));
+         Parsed_Nontable_Vcp_Response * aux_data = &packet->parsed_storage.nontable_response;
+         memset(aux_data, 0, sizeof(Parsed_Nontable_Vcp_Response));
          packet->parsed.nontable_response = aux_data;
 
          rc =  interpret_vcp_feature_response_std(
@@ -34,6 +34,9 @@
 
 #define MAX_DDC_TAG 39
 
+// size of the byte buffer of packets kept for reuse, sufficient for any DDC packet
+#define DDC_PACKET_POOL_BUFFER_SIZE (MAX_DDC_PACKET_INC_CHECKSUM+1)
+
 #ifdef NEW
 // apparently unused
 typedef struct {
@@ -115,6 +118,12 @@ struct {
       void *                                 raw_parsed;
    } parsed;
 
+   // storage to which parsed points, avoiding a separate allocation
+   union {
+      Parsed_Nontable_Vcp_Response           nontable_response;
+      Interpreted_Multi_Part_Read_Fragment   multi_part_read_fragment;
+   } parsed_storage;
+
    // additional fields for new way of parsing result data
    // Parsed_Response_Data * parsed_response;
 } DDC_Packet;
@@ -29,7 +29,9 @@
 #include "public/ddcutil_status_codes.h"
 
 #include "core.h"
+#include "dynamic_sleep.h"
 #include "monitor_model_key.h"
+#include "per_display_data.h"
 #include "rtti.h"
 #include "vcp_version.h"
 
@@ -131,20 +133,34 @@ Display_Async_Rec * display_async_rec_new(DDCA_IO_Path dpath) {
    // g_mutex_init(&newrec->thread_lock);
    // newrec->owning_thread = NULL;
 
+   g_mutex_init(&newrec->display_lock);
+
    newrec->request_queue = g_queue_new();
    g_mutex_init(&newrec->request_queue_lock);
-#ifdef FUTURE
-   newrec->request_execution_thread =
-         g_thread_new(
-               strdup(dpath_repr_t(dref)),       // thread name
-               NULL,                             // GThreadFunc    *** TEMP ***
-               dref->request_queue);             // or just dref?, how to pass dh?
-#endif
+   g_cond_init(&newrec->request_queue_cond);
+   // request_execution_thread is started when the first request is queued
+   newrec->dsa_tuner = dsa_tuner_new();
+   newrec->pdd = pdd_new(dpath);
 
    return newrec;
 }
 
 
+/** Applies a function to every #Display_Async_Rec.
+ *
+ *  \param func  function to apply
+ *  \param arg   argument passed to the function
+ */
+void apply_all_display_async_recs(Display_Async_Func func, void * arg) {
+   g_mutex_lock(&displays_master_list_mutex);
+   if (displays_master_list) {
+      for (int ndx = 0; ndx < displays_master_list->len; ndx++)
+         func(g_ptr_array_index(displays_master_list, ndx), arg);
+   }
+   g_mutex_unlock(&displays_master_list_mutex);
+}
+
+
 Display_Async_Rec * find_display_async_rec(DDCA_IO_Path dpath) {
    bool debug = false;
    assert(displays_master_list);
@@ -196,8 +212,14 @@ Display_Async_Rec * get_display_async_rec(DDCA_IO_Path dpath) {
 
 
 
-/** Acquired at display open time.
- *  Only 1 thread can open
+/** Acquires the lock that serializes I/O on a display between the threads
+ *  using its display handles and the display's request executor thread.
+ *  It is held for a single DDC transaction, or by the executor thread for
+ *  the duration of a queued request.
+ *
+ *  \param  async_rec  display's #Display_Async_Rec
+ *  \param  wait       if true, wait for the lock to become available
+ *  \return true if the lock was acquired, false if not
  */
 bool lock_display_lock(Display_Async_Rec * async_rec, bool wait) {
    assert(async_rec && memcmp(async_rec->marker, DISPLAY_ASYNC_REC_MARKER, 4) == 0);
@@ -218,6 +240,11 @@ bool lock_display_lock(Display_Async_Rec * async_rec, bool wait) {
 }
 
 
+/** Releases the lock acquired by #lock_display_lock(), if held by the
+ *  current thread.
+ *
+ *  \param  async_rec  display's #Display_Async_Rec
+ */
 void unlock_display_lock(Display_Async_Rec * async_rec) {
    assert(async_rec && memcmp(async_rec->marker, DISPLAY_ASYNC_REC_MARKER, 4) == 0);
 
@@ -727,6 +754,19 @@ Display_Ref * clone_display_ref(Display_Ref * old) {
 #endif
 
 
+// Set by the layer that parses capabilities, which base cannot reference directly
+static Dref_Pcaps_Release_Func dref_pcaps_release_func = NULL;
+
+/** Sets the function used by free_display_ref() to release a
+ *  #Display_Ref's reference to its parsed capabilities.
+ *
+ *  \param func  release function
+ */
+void set_dref_pcaps_release_func(Dref_Pcaps_Release_Func func) {
+   dref_pcaps_release_func = func;
+}
+
+
 /** Free a display reference.
  *
  *  \param dref  display reference to free
@@ -755,8 +795,12 @@ DDCA_Status free_display_ref(Display_Ref * dref) {
             free(dref->usb_hiddev_name);
          if (dref->capabilities_string)   // always a private copy
             free(dref->capabilities_string);
+         if (dref->pcaps && dref_pcaps_release_func)
+            dref_pcaps_release_func(dref->pcaps);
          if (dref->mmid)                  // always a private copy
             free(dref->mmid);
+         if (dref->vcp_value_cache)
+            free(dref->vcp_value_cache);
          // 9/2017: what about pedid, detail2?
          // what to do with gdl, request_queue?
          if (dref->dfr)
@@ -993,6 +1037,7 @@ Display_Handle * create_base_display_handle(int fd, Display_Ref * dref) {
    memcpy(dh->marker, DISPLAY_HANDLE_MARKER, 4);
    dh->fd = fd;
    dh->dref = dref;
+   dh->bus_lockfd = -1;
    if (dref->io_path.io_mode == DDCA_IO_I2C) {
       dh->repr = g_strdup_printf(
                      "Display_Handle[i2c: fd=%d, busno=%d @%p]",
@@ -1153,6 +1198,8 @@ void   free_display_handle(Display_Handle * dh) {
    if (dh && memcmp(dh->marker, DISPLAY_HANDLE_MARKER, 4) == 0) {
       dh->marker[3] = 'x';
       free(dh->repr);
+      if (dh->pending_verifies)
+         g_ptr_array_free(dh->pending_verifies, true);
       free(dh);
    }
    DBGTRC_DONE(debug, DDCA_TRC_BASE, "");
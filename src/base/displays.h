@@ -63,6 +63,11 @@ char *  dpath_repr_t(DDCA_IO_Path * dpath);  // value valid until next call
 // *** Display_Async ***
 
 
+struct Dsa_Tuner;
+struct Per_Display_Data;
+struct Parsed_Capabilities;
+struct Vcp_Value_Cache_Entry;
+
 #define DISPLAY_ASYNC_REC_MARKER "DSNC"
 /** Async processing  for display */
 typedef struct Display_Async {
@@ -72,14 +77,23 @@ typedef struct Display_Async {
    // Global_Display_Lock gdl;
 
    GThread *     thread_owning_display_lock;     // id of thread owning lock (type int is placeholder)
-   GMutex        display_lock;
+   GMutex        display_lock;                   // serializes I/O with request_execution_thread
 
-   // for future request queue structure
+   // request queue, serviced by request_execution_thread (see ddc_request_queue.c)
    GQueue *      request_queue;
    GMutex        request_queue_lock;
-   GThread *     request_execution_thread;  // or in DH?
+   GCond         request_queue_cond;        // signaled when a request is queued or completes
+   GThread *     request_execution_thread;  // started on first queued request
+   void *        active_request;            // request currently being executed, if any
+   bool          request_thread_terminate;
+
+   struct Dsa_Tuner * dsa_tuner;            // dynamic sleep adjustment state, see dynamic_sleep.c
+   struct Per_Display_Data * pdd;           // sleep and retry data, see per_display_data.c
 } Display_Async_Rec;
 
+typedef void (*Display_Async_Func)(Display_Async_Rec * async_rec, void * arg);
+void apply_all_display_async_recs(Display_Async_Func func, void * arg);
+
 
 // *** Display_Identifier ***
 
@@ -200,6 +214,7 @@ typedef struct _display_ref {
    DDCA_MCCS_Version_Spec   vcp_version_cmdline;
    Dref_Flags               flags;
    char *                   capabilities_string;    // added 4/2017, private copy
+   struct Parsed_Capabilities * pcaps;              // shared, holds a reference
    Parsed_Edid *            pedid;                  // added 4/2017
    DDCA_Monitor_Model_Key * mmid;                   // will be set iff pedid
    int                      dispno;
@@ -208,6 +223,7 @@ typedef struct _display_ref {
    Dynamic_Features_Rec *   dfr;                   // user defined feature metadata
    uint64_t                 next_i2c_io_after;     // nanosec
    struct _display_ref *    actual_display;        // if dispno == -2
+   struct Vcp_Value_Cache_Entry * vcp_value_cache; // 256 entries, allocated on first use
 } Display_Ref;
 
 #define ASSERT_DREF_IO_MODE(_dref, _mode)  \
@@ -225,6 +241,10 @@ char *        dref_repr_t(Display_Ref * dref);  // value valid until next call
 // Display_Ref * clone_display_ref(Display_Ref * old);
 DDCA_Status   free_display_ref(Display_Ref * dref);
 
+/** Function used to release the #Display_Ref reference to its parsed capabilities */
+typedef void (*Dref_Pcaps_Release_Func)(struct Parsed_Capabilities * pcaps);
+void          set_dref_pcaps_release_func(Dref_Pcaps_Release_Func func);
+
 // Do two Display_Ref's identify the same device?
 bool dref_eq(Display_Ref* this, Display_Ref* that);
 
@@ -241,6 +261,9 @@ typedef struct {
    Display_Ref* dref;
    int          fd;     // Linux file descriptor if ddc_io_mode == DDC_IO_DEVI2C or USB_IO                           // added 7/2016
    char *       repr;
+   bool         defer_sleeps;  // defer post-command sleeps while executing a batch of operations
+   int          bus_lockfd;    // cross-process I2C bus lock, -1 if none
+   GPtrArray *  pending_verifies;  // values written whose verification is deferred
 } Display_Handle;
 
 #ifdef OLD
@@ -135,6 +135,25 @@ get_dynamic_feature_metadata(
 }
 
 
+/** Returns the volatility class specified for a feature in a
+ *  feature definition file.
+ *
+ *  @param  dfr           pointer to #Dynamic_Features_Rec, may be NULL
+ *  @param  feature_code  VCP feature code
+ *  @return volatility class, VCP_VOLATILITY_UNSET if not specified
+ */
+Vcp_Volatility
+get_dynamic_feature_volatility(
+      Dynamic_Features_Rec * dfr,
+      uint8_t                feature_code)
+{
+   Vcp_Volatility result = VCP_VOLATILITY_UNSET;
+   if (dfr)
+      result = dfr->volatility[feature_code];
+   return result;
+}
+
+
 void
 free_feature_metadata(
       gpointer data)    // i.e. DDCA_Feature_Metadata *
@@ -465,6 +484,19 @@ create_monitor_dynamic_features(
                }
             }
 
+            else if (streq(t1.word, "VOLATILITY")) {
+               if (!cur_feature_metadata) {
+                  ADD_ERROR(linectr, "VOLATILITY before FEATURE_CODE");
+               }
+               else {
+                  Vcp_Volatility volatility = vcp_volatility_from_keyword(t2.word);
+                  if (volatility == VCP_VOLATILITY_UNSET)
+                     ADD_ERROR(linectr, "Invalid volatility \"%s\"", t2.word);
+                  else
+                     frec->volatility[cur_feature_metadata->feature_code] = volatility;
+               }
+            }
+
             else if (streq(t1.word, "FEATURE_CODE")) {
                // n. cur_feature_metadata saved in frec
                if (cur_feature_metadata) {
@@ -19,6 +19,8 @@
 
 #include "util/error_info.h"
 
+#include "base/feature_metadata.h"
+
 
 typedef enum {
    DFR_FLAGS_NONE      = 0,
@@ -35,6 +37,7 @@ typedef struct {
    DDCA_MCCS_Version_Spec     vspec;
    DFR_Flags                  flags;
    GHashTable *               features;     // hash table of DDCA_Feature_Metadata
+   Byte                       volatility[256];  // Vcp_Volatility overrides, indexed by feature code
 } Dynamic_Features_Rec;
 
 // value valid until next call:
@@ -67,6 +70,11 @@ get_dynamic_feature_metadata(
       Dynamic_Features_Rec *  dfr,
       uint8_t                 feature_code);
 
+Vcp_Volatility
+get_dynamic_feature_volatility(
+      Dynamic_Features_Rec *  dfr,
+      uint8_t                 feature_code);
+
 // satisfies glib signature
 void
 free_feature_metadata(
@@ -1,9 +1,9 @@
 /** @file dynamic_sleep.c
  *
- *  Experimental dynamic sleep adjustment
+ *  Dynamic sleep adjustment
  */
 
-// Copyright (C) 2020 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2020-2022 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 
@@ -27,20 +27,110 @@
 #include "base/parms.h"
 #include "base/ddc_errno.h"
 #include "base/linux_errno.h"
+#include "base/persistent_sleep_data.h"
 #include "base/thread_sleep_data.h"
 
 #include "base/dynamic_sleep.h"
 
 
 
-void dsa_record_ddcrw_status_code(int rc) {
+//
+// Dynamic sleep adjustment is performed per display, by an adaptive
+// controller maintained in the display's #Display_Async_Rec.
+//
+// The controller maintains an exponentially weighted moving average of the
+// DDC error rate.  It is an AIMD (additive increase/multiplicative decrease)
+// scheme applied to throughput, i.e. to the inverse of the sleep time:
+//
+// - When an error occurs and the average error rate exceeds
+//   dsa_increase_threshold, the sleep adjustment factor is multiplied by
+//   dsa_increase_multiplier.  A single transient error following a run
+//   of successful operations does not exceed the threshold.
+// - After dsa_decrease_interval consecutive successful operations, if the
+//   average error rate is below dsa_decrease_threshold, the factor is
+//   reduced by dsa_decrease_step, so that it can fall below 1.0.
+//
+// The factor is constrained to the range [dsa_min_factor, max], where max
+// is the larger of dsa_max_factor and twice the sleep multiplier factor.
+//
+
+static const double dsa_ewma_alpha          = 0.1;
+static const double dsa_increase_threshold  = 0.1;
+static const double dsa_increase_multiplier = 1.5;
+static const double dsa_decrease_threshold  = 0.02;
+static const double dsa_decrease_step       = 0.1;
+static const int    dsa_decrease_interval   = 10;
+static const double dsa_min_factor          = 0.1;
+static const double dsa_max_factor          = 3.0;
+
+
+Dsa_Tuner * dsa_tuner_new() {
+   Dsa_Tuner * tuner = calloc(1, sizeof(Dsa_Tuner));
+   memcpy(tuner->marker, DSA_TUNER_MARKER, 4);
+   g_mutex_init(&tuner->tuner_mutex);
+   tuner->current_factor = 1.0;
+   tuner->lowest_factor  = 1.0;
+   tuner->highest_factor = 1.0;
+   return tuner;
+}
+
+
+static Dsa_Tuner * get_dsa_tuner(Display_Ref * dref) {
+   assert(dref->async_rec);
+   Dsa_Tuner * tuner = dref->async_rec->dsa_tuner;
+   assert(memcmp(tuner->marker, DSA_TUNER_MARKER, 4) == 0);
+   return tuner;
+}
+
+
+static void set_factor(Dsa_Tuner * tuner, double factor) {
+   tuner->current_factor = factor;
+   if (factor < tuner->lowest_factor)
+      tuner->lowest_factor = factor;
+   if (factor > tuner->highest_factor)
+      tuner->highest_factor = factor;
+}
+
+
+// Returns the upper bound of the adjustment factor for the current thread
+static double dsa_max_factor_for_thread(Per_Thread_Data * tsd) {
+   double max_factor = dsa_max_factor;
+   if (max_factor < 2 * tsd->sleep_multiplier_factor)
+      max_factor = 2 * tsd->sleep_multiplier_factor;
+   return max_factor;
+}
+
+
+/** Records the status code of a DDC write/read operation for use
+ *  in dynamic sleep adjustment.
+ *
+ *  \param  dh  display handle
+ *  \param  rc  status code
+ */
+void dsa_record_ddcrw_status_code(Display_Handle * dh, int rc) {
    bool debug = false;
-   DBGMSF(debug, "rc=%s", psc_desc(rc));
+   DBGMSF(debug, "dh=%s, rc=%s", dh_repr_t(dh), psc_desc(rc));
+   Dsa_Tuner * tuner = get_dsa_tuner(dh->dref);
    Per_Thread_Data * tsd = tsd_get_thread_sleep_data();
 
+   g_mutex_lock(&tuner->tuner_mutex);
    if (rc == DDCRC_OK) {
-      tsd->current_ok_status_count++;
-      tsd->total_ok_status_count++;
+      tuner->total_ok_status_ct++;
+      tuner->ok_streak++;
+      tuner->error_rate = (1.0 - dsa_ewma_alpha) * tuner->error_rate;
+      if (tsd->dynamic_sleep_enabled &&
+          tuner->ok_streak >= dsa_decrease_interval &&
+          tuner->error_rate < dsa_decrease_threshold &&
+          tuner->current_factor > dsa_min_factor)
+      {
+         double next_factor = tuner->current_factor - dsa_decrease_step;
+         if (next_factor < dsa_min_factor)
+            next_factor = dsa_min_factor;
+         set_factor(tuner, next_factor);
+         tuner->decrease_ct++;
+         tuner->ok_streak = 0;
+         DBGMSF(debug, "Decreased sleep adjustment factor to %5.2f", tuner->current_factor);
+      }
    }
    else if (rc == DDCRC_DDC_DATA ||
             rc == DDCRC_READ_ALL_ZERO ||
@@ -49,124 +139,172 @@ void dsa_record_ddcrw_status_code(int rc) {
             rc == DDCRC_NULL_RESPONSE  // can be either a valid "No Value" response, or indicate a display error
            )
    {
-      tsd->current_error_status_count++;
-      tsd->total_error_status_count++;
+      tuner->total_error_status_ct++;
+      tuner->ok_streak = 0;
+      tuner->error_rate = (1.0 - dsa_ewma_alpha) * tuner->error_rate + dsa_ewma_alpha;
+      if (tsd->dynamic_sleep_enabled && tuner->error_rate > dsa_increase_threshold) {
+         double max_factor = dsa_max_factor_for_thread(tsd);
+         double next_factor = tuner->current_factor * dsa_increase_multiplier;
+         if (next_factor > max_factor)
+            next_factor = max_factor;
+         if (next_factor > tuner->current_factor) {
+            set_factor(tuner, next_factor);
+            tuner->increase_ct++;
+            DBGMSF(debug, "Increased sleep adjustment factor to %5.2f", tuner->current_factor);
+         }
+      }
    }
    else {
       DBGMSF(debug, "other status code: %s", psc_desc(rc));
-      tsd->total_other_status_ct++;
+      tuner->total_other_status_ct++;
    }
-   DBGMSF(debug, "Done. current_ok_status_count=%d, current_error_status_count=%d",
-                 tsd->current_ok_status_count, tsd->current_error_status_count);
+   DBGMSF(debug, "Done. error_rate=%5.3f, current_factor=%5.2f",
+                 tuner->error_rate, tuner->current_factor);
+   g_mutex_unlock(&tuner->tuner_mutex);
 }
 
 
-void dsa_reset_counts() {
+/** Returns the dynamic sleep adjustment factor for a display.
+ *
+ *  \param  dh  display handle
+ *  \return adjustment factor, 1.0 if dynamic sleep adjustment is not
+ *          enabled for the current thread
+ */
+double dsa_get_sleep_adjustment(Display_Handle * dh) {
    bool debug = false;
-   DBGMSF(debug, "Executing");
-   Per_Thread_Data * data = tsd_get_thread_sleep_data();
-
-   data->current_ok_status_count = 0;
-   data->current_error_status_count = 0;
+   Per_Thread_Data * tsd = tsd_get_thread_sleep_data();
+   double result = 1.0;
+   if (tsd->dynamic_sleep_enabled) {
+      Dsa_Tuner * tuner = get_dsa_tuner(dh->dref);
+      g_mutex_lock(&tuner->tuner_mutex);
+      result = tuner->current_factor;
+      g_mutex_unlock(&tuner->tuner_mutex);
+   }
+   DBGMSF(debug, "dh=%s, dynamic_sleep_enabled=%s, returning %5.2f",
+                 dh_repr_t(dh), sbool(tsd->dynamic_sleep_enabled), result);
+   return result;
 }
 
 
-bool error_rate_is_high(Per_Thread_Data * tsd) {
-   bool debug = false;
-   bool result = false;
-   DBGMSF(debug, "Starting");
-   assert(tsd);
-
-   double dsa_error_rate_threshold = .1;
-   int    dsa_required_status_sample_size = 3;
+/** Reports the dynamic sleep adjustment state for a display.
+ *
+ *  \param  async_rec  per-display record
+ *  \param  depth      logical indentation depth
+ */
+void report_dsa_tuner(Display_Async_Rec * async_rec, int depth) {
+   int d1 = depth+1;
+   Dsa_Tuner * tuner = async_rec->dsa_tuner;
+   g_mutex_lock(&tuner->tuner_mutex);
+   rpt_vstring(depth, "Dynamic sleep adjustment for display %s:", dpath_repr_t(&async_rec->dpath));
+   rpt_vstring(d1, "Total successful reads:          %5d",   tuner->total_ok_status_ct);
+   rpt_vstring(d1, "Total reads with DDC error:      %5d",   tuner->total_error_status_ct);
+   rpt_vstring(d1, "Total ignored status codes:      %5d",   tuner->total_other_status_ct);
+   rpt_vstring(d1, "Average error rate:              %5.3f", tuner->error_rate);
+   rpt_vstring(d1, "Current successful streak:       %5d",   tuner->ok_streak);
+   rpt_vstring(d1, "Number of increases:             %5d",   tuner->increase_ct);
+   rpt_vstring(d1, "Number of decreases:             %5d",   tuner->decrease_ct);
+   rpt_vstring(d1, "Lowest sleep adjustment:         %5.2f", tuner->lowest_factor);
+   rpt_vstring(d1, "Highest sleep adjustment:        %5.2f", tuner->highest_factor);
+   rpt_vstring(d1, "Current sleep adjustment:        %5.2f", tuner->current_factor);
+   if (tuner->prior_ok_status_ct + tuner->prior_error_status_ct > 0) {
+      rpt_vstring(d1, "Prior successful reads (saved):  %5d", tuner->prior_ok_status_ct);
+      rpt_vstring(d1, "Prior reads with DDC error:      %5d", tuner->prior_error_status_ct);
+   }
+   g_mutex_unlock(&tuner->tuner_mutex);
+}
 
-   double error_rate = 0.0;    // outside of loop for final debug message
 
-   int current_total_count = tsd->current_ok_status_count + tsd->current_error_status_count;
+static void wrap_report_dsa_tuner(Display_Async_Rec * async_rec, void * arg) {
+   int depth = GPOINTER_TO_INT(arg);
+   Dsa_Tuner * tuner = async_rec->dsa_tuner;
+   if (tuner->total_ok_status_ct + tuner->total_error_status_ct + tuner->total_other_status_ct > 0)
+      report_dsa_tuner(async_rec, depth);
+}
 
-   if ( (current_total_count) > dsa_required_status_sample_size) {
-      if (current_total_count <= 4) {
-         dsa_error_rate_threshold = .5;
-         // adjustment_check_interval = 3;
-      }
-      else if (current_total_count <= 10) {
-         dsa_error_rate_threshold = .3;
-         // adjustment_check_interval = 4;
-      }
-      else {
-         dsa_error_rate_threshold = .1;
-         // adjustment_check_interval = 5;
-      }
 
-      error_rate = (1.0 * tsd->current_error_status_count) / (current_total_count);
-      DBGMSF(debug, "ok_status_count=%d, error_status_count=%d,"
-                    " error_rate = %7.2f, error_rate_threshold= %7.2f",
-                    tsd->current_ok_status_count, tsd->current_error_status_count,
-                    error_rate, dsa_error_rate_threshold);
-      result = (error_rate > dsa_error_rate_threshold);
-   }
-   // DBGMSF(debug, "%s", sbool(result));
-   DBGMSF(debug, "total_count=%d, error_rate=%4.2f, returning %s",
-                 current_total_count, error_rate, sbool(result));
-   return result;
+/** Reports the dynamic sleep adjustment state for all displays on
+ *  which DDC operations have been performed.
+ *
+ *  \param  depth  logical indentation depth
+ */
+void report_all_dsa_tuners(int depth) {
+   apply_all_display_async_recs(wrap_report_dsa_tuner, GINT_TO_POINTER(depth));
 }
 
 
-// This function is a swamp - refactor
+// Minimum number of status codes recorded before learned data is saved
+static const int dsa_persistence_min_sample_size = 4;
+
 
-double dsa_get_sleep_adjustment() {
+/** Initializes a display's dynamic sleep adjustment from the value
+ *  learned for its monitor model by prior processes.
+ *
+ *  Has no effect if dynamic sleep adjustment is not enabled for the
+ *  current thread, or if status codes have already been recorded
+ *  for the display.  A saved value outside the range the tuner can
+ *  reach, e.g. from a hand edited file, is clamped to that range.
+ *
+ *  \param dref  display reference
+ */
+void dsa_load_persistent_adjustment(Display_Ref * dref) {
    bool debug = false;
    Per_Thread_Data * tsd = tsd_get_thread_sleep_data();
-   DBGMSF(debug, "global_dynamic_sleep_enabled for current thread = %s", sbool(tsd->dynamic_sleep_enabled));
-   if (!tsd->dynamic_sleep_enabled) {
-      double result = 1.0;
-      DBGMSF(debug, "Returning %3.1f" ,result);
-      return result;
+   if (!tsd->dynamic_sleep_enabled || !dref->mmid)
+      return;
+
+   Dsa_Tuner * tuner = get_dsa_tuner(dref);
+   Persistent_Sleep_Data data;
+   if (tuner->total_ok_status_ct + tuner->total_error_status_ct == 0 &&
+       get_persistent_sleep_data(dref->mmid, &data))
+   {
+      double factor = data.sleep_adjustment_factor;
+      double max_factor = dsa_max_factor_for_thread(tsd);
+      if (!(factor >= dsa_min_factor))     // also catches NaN
+         factor = dsa_min_factor;
+      else if (factor > max_factor)
+         factor = max_factor;
+      DBGMSF(debug, "dref=%s, saved factor = %5.2f, setting current_factor = %5.2f",
+                    dref_repr_t(dref), data.sleep_adjustment_factor, factor);
+      g_mutex_lock(&tuner->tuner_mutex);
+      tuner->current_factor = factor;
+      tuner->lowest_factor  = factor;
+      tuner->highest_factor = factor;
+      tuner->prior_ok_status_ct    = data.ok_status_count;
+      tuner->prior_error_status_ct = data.error_status_count;
+      g_mutex_unlock(&tuner->tuner_mutex);
    }
+}
 
-   // double dsa_increment = .5;                      // a constant, for now
-   // int adjustment_check_interval = 2;    //  move to Thread_Sleep_Data  ??
-
-   tsd->calls_since_last_check++;
-
-   if (tsd->calls_since_last_check > tsd->adjustment_check_interval) {
-      DBGMSF(debug, "calls_since_last_check = %d, adjustment_check_interval = %d, performing check",
-                    tsd->calls_since_last_check, tsd->adjustment_check_interval);
-      tsd->calls_since_last_check = 0;
-      tsd->total_adjustment_checks++;
-
-      if (error_rate_is_high(tsd)) {
-         double max_sleep_adjustment_factor = 3.0;
-         if (max_sleep_adjustment_factor < 2 * tsd->sleep_multiplier_factor)
-            max_sleep_adjustment_factor = 2 * tsd->sleep_multiplier_factor;
-
-         double next_sleep_adjustment_factor =
-             tsd->current_sleep_adjustment_factor + tsd->thread_adjustment_increment;
-
-         if (next_sleep_adjustment_factor <= max_sleep_adjustment_factor) {
-            tsd->adjustment_ct++;
-            tsd->current_sleep_adjustment_factor = next_sleep_adjustment_factor;
-            tsd->thread_adjustment_increment = 2.0 * tsd->thread_adjustment_increment;
-            tsd->adjustment_check_interval = 2 * tsd->adjustment_check_interval;
-            DBGMSF(debug, "Increasing sleep_adjustment_factor to %5.2f,"
-                          " thread_adjustment_increment to %5.2f",
-                          tsd->current_sleep_adjustment_factor,
-                          tsd->thread_adjustment_increment);
-         }
-         else {
-            tsd->non_adjustment_ct++;
-            tsd->adjustment_check_interval = 999;   // no more checks
 
-            DBGMSF(debug, "Max sleep adjustment factor reached.  Returning %5.2f",
-                          tsd->current_sleep_adjustment_factor);
-         }
-         dsa_reset_counts();
-      }
+/** Saves the display's dynamic sleep adjustment as the learned
+ *  value for its monitor model, adding the status counts recorded
+ *  since the last save to the saved counts.
+ *
+ *  \param dref  display reference
+ */
+void dsa_save_persistent_adjustment(Display_Ref * dref) {
+   bool debug = false;
+   Per_Thread_Data * tsd = tsd_get_thread_sleep_data();
+   if (!tsd->dynamic_sleep_enabled || !dref->mmid)
+      return;
+
+   Dsa_Tuner * tuner = get_dsa_tuner(dref);
+   g_mutex_lock(&tuner->tuner_mutex);
+   Persistent_Sleep_Data data;
+   data.sleep_adjustment_factor = tuner->current_factor;
+   data.ok_status_count         = tuner->total_ok_status_ct    - tuner->saved_ok_status_ct;
+   data.error_status_count      = tuner->total_error_status_ct - tuner->saved_error_status_ct;
+   bool save = tuner->total_ok_status_ct + tuner->total_error_status_ct >= dsa_persistence_min_sample_size &&
+               data.ok_status_count + data.error_status_count > 0;
+   if (save) {
+      tuner->saved_ok_status_ct    = tuner->total_ok_status_ct;
+      tuner->saved_error_status_ct = tuner->total_error_status_ct;
    }
-   float result = tsd->current_sleep_adjustment_factor;
+   g_mutex_unlock(&tuner->tuner_mutex);
 
-   DBGMSF(debug, "current_ok_status_count=%d, current_error_status_count=%d, returning %5.2f",
-           tsd->current_ok_status_count, tsd->current_error_status_count, result);
-   return result;
+   if (save) {
+      DBGMSF(debug, "dref=%s, saving sleep_adjustment_factor = %5.2f",
+                    dref_repr_t(dref), data.sleep_adjustment_factor);
+      update_persistent_sleep_data(dref->mmid, &data);
+   }
 }
-
@@ -1,6 +1,6 @@
 /** @file dynamic_sleep.h
  *
- *  Experimental dynamic sleep adjustment
+ *  Dynamic sleep adjustment
  */
 
 // Copyright (C) 2020 Sanford Rockowitz <rockowitz@minsoft.com>
@@ -10,6 +10,7 @@
 #define DYNAMIC_SLEEP_H_
 
 /** \cond */
+#include <glib-2.0/glib.h>
 #include <inttypes.h>
 #include <stdbool.h>
 /** \endcond */
@@ -19,7 +20,33 @@
 #include "base/displays.h"
 #include "base/status_code_mgt.h"
 
-void   dsa_record_ddcrw_status_code(int rc);
-double dsa_get_sleep_adjustment();
+#define DSA_TUNER_MARKER "DSAT"
+/** Dynamic sleep adjustment state for a display */
+typedef struct Dsa_Tuner {
+   char   marker[4];
+   GMutex tuner_mutex;
+   double current_factor;          ///< multiplier applied to sleep time
+   double error_rate;              ///< exponentially weighted moving average
+   int    ok_streak;               ///< consecutive successful operations
+   int    total_ok_status_ct;
+   int    total_error_status_ct;
+   int    total_other_status_ct;
+   int    increase_ct;
+   int    decrease_ct;
+   double lowest_factor;
+   double highest_factor;
+   int    prior_ok_status_ct;      ///< saved by prior processes for the monitor model
+   int    prior_error_status_ct;
+   int    saved_ok_status_ct;      ///< portion of total_ok_status_ct already saved
+   int    saved_error_status_ct;
+} Dsa_Tuner;
+
+Dsa_Tuner * dsa_tuner_new();
+void   dsa_record_ddcrw_status_code(Display_Handle * dh, int rc);
+double dsa_get_sleep_adjustment(Display_Handle * dh);
+void   report_dsa_tuner(Display_Async_Rec * async_rec, int depth);
+void   report_all_dsa_tuners(int depth);
+void   dsa_load_persistent_adjustment(Display_Ref * dref);
+void   dsa_save_persistent_adjustment(Display_Ref * dref);
 
 #endif /* DYNAMIC_SLEEP_H_ */
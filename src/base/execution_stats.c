@@ -39,6 +39,7 @@ typedef struct {
    const char *   desc;
    uint64_t       call_nanosec;
    int            call_count;
+   Latency_Histogram histogram;
 } IO_Event_Type_Stats;
 
 
@@ -91,21 +92,121 @@ IO_Event_Type_Stats io_event_stats[] = {
       {IE_CLOSE,      "IE_CLOSE",      "close file calls",  0, 0},
       {IE_OTHER,      "IE_OTHER",      "other I/O calls",   0, 0},
 };
-#define IO_EVENT_TYPE_CT (sizeof(io_event_stats)/sizeof(IO_Event_Type_Stats))
-static GMutex io_event_stats_mutex;
+static GMutex io_event_stats_mutex;      // for all_thread_io_event_stats, not taken by log_io_call()
 static bool   debug_io_event_stats_mutex;
 
+// IO events are counted in per-thread instances, so that threads recording
+// events do not contend with each other.  The instances are summed when
+// statistics are reported.  Each instance has its own mutex, which is
+// contended only while a report takes a snapshot.  When a thread terminates
+// its counts are added to retired_io_event_stats and its instance is freed.
+typedef struct {
+   GMutex             mutex;
+   int                generation;       // value of io_event_stats_generation when counting began
+   int                call_count[IO_EVENT_TYPE_CT];
+   uint64_t           call_nanosec[IO_EVENT_TYPE_CT];
+   Latency_Histogram  histogram[IO_EVENT_TYPE_CT];
+} Thread_IO_Event_Stats;
+
+static void retire_thread_io_event_stats(gpointer data);
+
+static GPtrArray * all_thread_io_event_stats = NULL;
+static GPrivate    thread_io_event_stats_key = G_PRIVATE_INIT(retire_thread_io_event_stats);
+static gint        io_event_stats_generation = 0;   // incremented by reset
+static Thread_IO_Event_Stats retired_io_event_stats;   // counts of terminated threads
+
+// Adds the counts in src to dest, if both are of the current generation.
+// Clears dest first if its counts predate the most recent reset.
+static void accumulate_thread_io_event_stats(
+      Thread_IO_Event_Stats * dest, Thread_IO_Event_Stats * src, int generation)
+{
+   if (dest->generation != generation) {
+      memset(dest->call_count,   0, sizeof(dest->call_count));
+      memset(dest->call_nanosec, 0, sizeof(dest->call_nanosec));
+      memset(dest->histogram,    0, sizeof(dest->histogram));
+      dest->generation = generation;
+   }
+   if (src->generation == generation) {
+      for (int ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++) {
+         dest->call_count[ndx]   += src->call_count[ndx];
+         dest->call_nanosec[ndx] += src->call_nanosec[ndx];
+         latency_histogram_merge(&dest->histogram[ndx], &src->histogram[ndx]);
+      }
+   }
+}
+
+
+// Destroy notify for thread_io_event_stats_key, called when a thread terminates
+static void retire_thread_io_event_stats(gpointer data) {
+   Thread_IO_Event_Stats * stats = data;
+   int generation = g_atomic_int_get(&io_event_stats_generation);
+   g_mutex_lock(&io_event_stats_mutex);
+   g_ptr_array_remove_fast(all_thread_io_event_stats, stats);
+   accumulate_thread_io_event_stats(&retired_io_event_stats, stats, generation);
+   g_mutex_unlock(&io_event_stats_mutex);
+   g_mutex_clear(&stats->mutex);
+   free(stats);
+}
+
+
+// Returns the current thread's instance, with its mutex locked
+static Thread_IO_Event_Stats * lock_thread_io_event_stats() {
+   Thread_IO_Event_Stats * stats = g_private_get(&thread_io_event_stats_key);
+   int generation = g_atomic_int_get(&io_event_stats_generation);
+   if (!stats) {
+      stats = calloc(1, sizeof(Thread_IO_Event_Stats));
+      g_mutex_init(&stats->mutex);
+      stats->generation = generation;
+      g_private_set(&thread_io_event_stats_key, stats);
+      g_mutex_lock(&io_event_stats_mutex);
+      if (!all_thread_io_event_stats)
+         all_thread_io_event_stats = g_ptr_array_new();
+      g_ptr_array_add(all_thread_io_event_stats, stats);
+      g_mutex_unlock(&io_event_stats_mutex);
+   }
+   g_mutex_lock(&stats->mutex);
+   if (stats->generation != generation) {
+      // statistics were reset since this thread last recorded an event
+      memset(stats->call_count,   0, sizeof(stats->call_count));
+      memset(stats->call_nanosec, 0, sizeof(stats->call_nanosec));
+      memset(stats->histogram,    0, sizeof(stats->histogram));
+      stats->generation = generation;
+   }
+   return stats;
+}
+
+
+// Sums the per-thread statistics for the current generation
+static void get_io_event_stats_snapshot(IO_Event_Type_Stats snapshot[IO_EVENT_TYPE_CT]) {
+   memcpy(snapshot, io_event_stats, IO_EVENT_TYPE_CT*sizeof(IO_Event_Type_Stats));
+   int generation = g_atomic_int_get(&io_event_stats_generation);
+   Thread_IO_Event_Stats totals = {.generation = generation};
+   g_mutex_lock(&io_event_stats_mutex);
+   accumulate_thread_io_event_stats(&totals, &retired_io_event_stats, generation);
+   if (all_thread_io_event_stats) {
+      for (int thread_ndx = 0; thread_ndx < all_thread_io_event_stats->len; thread_ndx++) {
+         Thread_IO_Event_Stats * stats = g_ptr_array_index(all_thread_io_event_stats, thread_ndx);
+         g_mutex_lock(&stats->mutex);
+         accumulate_thread_io_event_stats(&totals, stats, generation);
+         g_mutex_unlock(&stats->mutex);
+      }
+   }
+   g_mutex_unlock(&io_event_stats_mutex);
+   for (int ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++) {
+      snapshot[ndx].call_count   += totals.call_count[ndx];
+      snapshot[ndx].call_nanosec += totals.call_nanosec[ndx];
+      latency_histogram_merge(&snapshot[ndx].histogram, &totals.histogram[ndx]);
+   }
+}
+
+
 static
 void reset_io_event_stats() {
    bool debug = false || debug_io_event_stats_mutex;
    DBGMSF(debug, "Starting");
 
-   g_mutex_lock(&io_event_stats_mutex);
-   for (int ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++) {
-      io_event_stats[ndx].call_count   = 0;
-      io_event_stats[ndx].call_nanosec = 0;
-   }
-   g_mutex_unlock(&io_event_stats_mutex);
+   // each thread clears its own counts when it next records an event
+   g_atomic_int_inc(&io_event_stats_generation);
 
    DBGMSF(debug, "Done");
 }
@@ -137,19 +238,23 @@ int max_event_name_length() {
 
 
 static int total_io_event_count() {
+   IO_Event_Type_Stats snapshot[IO_EVENT_TYPE_CT];
+   get_io_event_stats_snapshot(snapshot);
    int total = 0;
    int ndx = 0;
    for (;ndx < IO_EVENT_TYPE_CT; ndx++)
-      total += io_event_stats[ndx].call_count;
+      total += snapshot[ndx].call_count;
    return total;
 }
 
 // unused
 uint64_t total_io_event_nanosec() {
+   IO_Event_Type_Stats snapshot[IO_EVENT_TYPE_CT];
+   get_io_event_stats_snapshot(snapshot);
    uint64_t total = 0;
    int ndx = 0;
    for (;ndx < IO_EVENT_TYPE_CT; ndx++)
-      total += io_event_stats[ndx].call_nanosec;
+      total += snapshot[ndx].call_nanosec;
    return total;
 }
 
@@ -163,6 +268,9 @@ uint64_t normalize_timestamp(uint64_t timestamp) {
 /** Called immediately after an I2C IO call, this function updates the total
  *  number of calls and elapsed time for categories of calls.
  *
+ *  Statistics are recorded in the current thread's instance, whose mutex
+ *  is contended only while statistics are being reported.
+ *
  *  @param  event_type        e.g. IE_WRITE
  *  @param  location          function name
  *  @param  start_time_nanos  starting time of the event in nanoseconds
@@ -180,15 +288,15 @@ void log_io_call(
    DBGMSF(debug, "event_type=%d %-10s, elapsed_nanos=%"PRIu64", as millis=%"PRIu64,
                   event_type, io_event_name(event_type), elapsed_nanos, elapsed_nanos/(1000*1000) );
 
-   g_mutex_lock(&io_event_stats_mutex);
-
-   io_event_stats[event_type].call_count++;
-   io_event_stats[event_type].call_nanosec += elapsed_nanos;
-
-   g_mutex_unlock(&io_event_stats_mutex);
+   Thread_IO_Event_Stats * stats = lock_thread_io_event_stats();
+   stats->call_count[event_type]++;
+   stats->call_nanosec[event_type] += elapsed_nanos;
+   latency_histogram_record(&stats->histogram[event_type], elapsed_nanos);
+   uint64_t thread_nanosec = stats->call_nanosec[event_type];
+   g_mutex_unlock(&stats->mutex);
 
-   DBGMSF(debug, "Updated total nanosec = %"PRIu64", as millis=%"PRIu64,
-                  io_event_stats[event_type].call_nanosec, io_event_stats[event_type].call_nanosec /(1000*1000) );
+   DBGMSF(debug, "Updated thread total nanosec = %"PRIu64", as millis=%"PRIu64,
+                  thread_nanosec, thread_nanosec /(1000*1000) );
 }
 
 
@@ -199,6 +307,8 @@ void log_io_call(
 void report_io_call_stats(int depth) {
    int d1 = depth+1;
    rpt_title("Call Stats:", depth);
+   IO_Event_Type_Stats snapshot[IO_EVENT_TYPE_CT];
+   get_io_event_stats_snapshot(snapshot);
    int total_ct = 0;
    uint64_t total_nanos = 0;
    int ndx = 0;
@@ -207,8 +317,8 @@ void report_io_call_stats(int depth) {
    // DBGMSG("max_name_length=%d", max_name_length);
    rpt_vstring(d1, "%-40s Count    Millisec  (      Nanosec)", "Type");
    for (;ndx < IO_EVENT_TYPE_CT; ndx++) {
-      if (io_event_stats[ndx].call_count > 0) {
-         IO_Event_Type_Stats* curstat = &io_event_stats[ndx];
+      if (snapshot[ndx].call_count > 0) {
+         IO_Event_Type_Stats* curstat = &snapshot[ndx];
          char buf[100];
          snprintf(buf, 100, "%-17s (%s)", curstat->desc, curstat->name);
          rpt_vstring(d1, "%-40s  %4d  %10" PRIu64 "  (%13" PRIu64 ")",
@@ -227,6 +337,160 @@ void report_io_call_stats(int depth) {
                total_nanos / (1000*1000),
                total_nanos
               );
+
+   if (total_ct > 0) {
+      Latency_Histogram histograms[IO_EVENT_TYPE_CT];
+      for (int ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++)
+         histograms[ndx] = snapshot[ndx].histogram;
+      rpt_nl();
+      report_latency_histograms(histograms, depth);
+   }
+}
+
+
+//
+// Latency Histograms
+//
+
+static int latency_bucket_index(uint64_t nanos) {
+   if (nanos < LATENCY_HISTOGRAM_SUB_BUCKETS)
+      return nanos;
+   int msb = 63 - __builtin_clzll(nanos);
+   int shift = msb - LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+   int sub_bucket = (nanos >> shift) & (LATENCY_HISTOGRAM_SUB_BUCKETS-1);
+   int index = (shift+1) * LATENCY_HISTOGRAM_SUB_BUCKETS + sub_bucket;
+   if (index >= LATENCY_HISTOGRAM_BUCKET_CT)
+      index = LATENCY_HISTOGRAM_BUCKET_CT-1;
+   return index;
+}
+
+
+// highest value that maps to a bucket
+static uint64_t latency_bucket_limit(int index) {
+   if (index < LATENCY_HISTOGRAM_SUB_BUCKETS)
+      return index;
+   int shift = index/LATENCY_HISTOGRAM_SUB_BUCKETS - 1;
+   int sub_bucket = index % LATENCY_HISTOGRAM_SUB_BUCKETS;
+   uint64_t lower = (uint64_t) (LATENCY_HISTOGRAM_SUB_BUCKETS + sub_bucket) << shift;
+   return lower + ((uint64_t)1 << shift) - 1;
+}
+
+
+/** Records an event in a latency histogram.
+ *
+ *  \param  histogram  histogram to update
+ *  \param  nanos      elapsed time of the event
+ *
+ *  \remark
+ *  The caller is responsible for any locking.
+ */
+void latency_histogram_record(Latency_Histogram * histogram, uint64_t nanos) {
+   histogram->counts[latency_bucket_index(nanos)]++;
+   histogram->total_ct++;
+   histogram->total_nanos += nanos;
+   if (nanos > histogram->max_nanos)
+      histogram->max_nanos = nanos;
+}
+
+
+/** Adds the counts in one latency histogram to another.
+ *
+ *  \param  dest  histogram to update
+ *  \param  src   histogram to add
+ */
+void latency_histogram_merge(Latency_Histogram * dest, Latency_Histogram * src) {
+   if (src->total_ct == 0)
+      return;
+   for (int ndx = 0; ndx < LATENCY_HISTOGRAM_BUCKET_CT; ndx++)
+      dest->counts[ndx] += src->counts[ndx];
+   dest->total_ct    += src->total_ct;
+   dest->total_nanos += src->total_nanos;
+   if (src->max_nanos > dest->max_nanos)
+      dest->max_nanos = src->max_nanos;
+}
+
+
+/** Returns the approximate value at a percentile of a latency histogram.
+ *
+ *  \param  histogram   histogram to examine
+ *  \param  percentile  0..100
+ *  \return value in nanoseconds, never greater than the maximum recorded
+ */
+uint64_t latency_histogram_percentile(Latency_Histogram * histogram, double percentile) {
+   if (histogram->total_ct == 0)
+      return 0;
+   uint64_t threshold = (uint64_t) (histogram->total_ct * percentile / 100.0 + 0.5);
+   if (threshold == 0)
+      threshold = 1;
+   uint64_t cumulative = 0;
+   uint64_t result = histogram->max_nanos;
+   for (int ndx = 0; ndx < LATENCY_HISTOGRAM_BUCKET_CT; ndx++) {
+      cumulative += histogram->counts[ndx];
+      if (cumulative >= threshold) {
+         result = latency_bucket_limit(ndx);
+         break;
+      }
+   }
+   if (result > histogram->max_nanos)
+      result = histogram->max_nanos;
+   return result;
+}
+
+
+/** Fills in a #DDCA_IO_Latency_Stats from a latency histogram.
+ *
+ *  \param  histogram  histogram to summarize
+ *  \param  stats_loc  where to return summary
+ */
+void latency_histogram_summarize(Latency_Histogram * histogram, DDCA_IO_Latency_Stats * stats_loc) {
+   stats_loc->event_ct      = histogram->total_ct;
+   stats_loc->total_nanosec = histogram->total_nanos;
+   stats_loc->p50_nanosec   = latency_histogram_percentile(histogram, 50);
+   stats_loc->p90_nanosec   = latency_histogram_percentile(histogram, 90);
+   stats_loc->p99_nanosec   = latency_histogram_percentile(histogram, 99);
+   stats_loc->max_nanosec   = histogram->max_nanos;
+}
+
+
+/** Reports the percentiles of a set of latency histograms, one per
+ *  #IO_Event_Type.  Event types without events are not reported.
+ *
+ *  \param  histograms  array of histograms, indexed by event type
+ *  \param  depth       logical indentation depth
+ */
+void report_latency_histograms(Latency_Histogram histograms[IO_EVENT_TYPE_CT], int depth) {
+   int d1 = depth+1;
+   rpt_title("Latency (millisec):", depth);
+   rpt_vstring(d1, "%-40s Count       p50       p90       p99       max", "Type");
+   for (int ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++) {
+      Latency_Histogram * h = &histograms[ndx];
+      if (h->total_ct > 0) {
+         DDCA_IO_Latency_Stats stats;
+         latency_histogram_summarize(h, &stats);
+         char buf[100];
+         snprintf(buf, 100, "%-17s (%s)", io_event_stats[ndx].desc, io_event_stats[ndx].name);
+         rpt_vstring(d1, "%-40s  %4d  %8.3f  %8.3f  %8.3f  %8.3f",
+                     buf,
+                     stats.event_ct,
+                     stats.p50_nanosec / (1000.0*1000),
+                     stats.p90_nanosec / (1000.0*1000),
+                     stats.p99_nanosec / (1000.0*1000),
+                     stats.max_nanosec / (1000.0*1000));
+      }
+   }
+}
+
+
+/** Returns a copy of the global latency histogram for an event type.
+ *
+ *  \param  event_type     IO event type
+ *  \param  histogram_loc  where to return the copy
+ */
+void get_io_event_latency(IO_Event_Type event_type, Latency_Histogram * histogram_loc) {
+   assert(event_type >= 0 && event_type < IO_EVENT_TYPE_CT);
+   IO_Event_Type_Stats snapshot[IO_EVENT_TYPE_CT];
+   get_io_event_stats_snapshot(snapshot);
+   *histogram_loc = snapshot[event_type].histogram;
 }
 
 
@@ -242,10 +506,12 @@ get_non_sleep_call_totals () {
    totals.nanos = 0;
     int ndx = 0;
     // int max_name_length = max_event_name_length();
+    IO_Event_Type_Stats snapshot[IO_EVENT_TYPE_CT];
+    get_io_event_stats_snapshot(snapshot);
 
     for (;ndx < IO_EVENT_TYPE_CT; ndx++) {
-       if (io_event_stats[ndx].call_count > 0) {
-          IO_Event_Type_Stats* curstat = &io_event_stats[ndx];
+       if (snapshot[ndx].call_count > 0) {
+          IO_Event_Type_Stats* curstat = &snapshot[ndx];
 
           totals.count += curstat->call_count;
           totals.nanos += curstat->call_nanosec;
@@ -2,7 +2,8 @@
  *
  * Record the count and elapsed time of system calls.
  *
- * These stats are global, not per thread
+ * These stats are global, not per thread.  Latency histograms
+ * are also maintained per display, see per_display_data.c
  */
 
 // Copyright (C) 2014-2020 Sanford Rockowitz <rockowitz@minsoft.com>
@@ -50,6 +51,7 @@ typedef enum {
    IE_CLOSE,               ///< device file close
    IE_OTHER                ///< other IO event
 } IO_Event_Type;
+#define IO_EVENT_TYPE_CT (IE_OTHER+1)
 
 
 const char * io_event_name(IO_Event_Type event_type);
@@ -70,6 +72,30 @@ void log_io_call(
 void report_io_call_stats(int depth);
 
 
+// Latency Histograms
+
+// Log-linear buckets: each power of 2 is divided into 8 sub-buckets,
+// so a reported percentile is within 12.5% of the actual value.
+#define LATENCY_HISTOGRAM_SUB_BUCKET_BITS 3
+#define LATENCY_HISTOGRAM_SUB_BUCKETS     (1<<LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+#define LATENCY_HISTOGRAM_BUCKET_CT       (40*LATENCY_HISTOGRAM_SUB_BUCKETS)   // to 2**42 nanosec
+
+/** Latency histogram for a single event type */
+typedef struct {
+   uint32_t counts[LATENCY_HISTOGRAM_BUCKET_CT];
+   uint32_t total_ct;
+   uint64_t total_nanos;
+   uint64_t max_nanos;
+} Latency_Histogram;
+
+void     latency_histogram_record(Latency_Histogram * histogram, uint64_t nanos);
+void     latency_histogram_merge(Latency_Histogram * dest, Latency_Histogram * src);
+uint64_t latency_histogram_percentile(Latency_Histogram * histogram, double percentile);
+void     latency_histogram_summarize(Latency_Histogram * histogram, DDCA_IO_Latency_Stats * stats_loc);
+void     report_latency_histograms(Latency_Histogram histograms[IO_EVENT_TYPE_CT], int depth);
+void     get_io_event_latency(IO_Event_Type event_type, Latency_Histogram * histogram_loc);
+
+
 // Record Status Code Occurrence
 
 Public_Status_Code log_status_code(Public_Status_Code rc, const char * caller_name);
@@ -242,6 +242,48 @@ sl_value_table_lookup(
 }
 
 
+// Feature value volatility
+
+/** Returns the symbolic name of a #Vcp_Volatility value.
+ *
+ *  @param  volatility  volatility class
+ *  @return name, do not free
+ */
+char *
+vcp_volatility_name(Vcp_Volatility volatility) {
+   char * result = NULL;
+   switch(volatility) {
+   case VCP_VOLATILITY_UNSET:             result = "VCP_VOLATILITY_UNSET";             break;
+   case VCP_VOLATILITY_LIVE:              result = "VCP_VOLATILITY_LIVE";              break;
+   case VCP_VOLATILITY_TTL:               result = "VCP_VOLATILITY_TTL";               break;
+   case VCP_VOLATILITY_WRITE_INVALIDATED: result = "VCP_VOLATILITY_WRITE_INVALIDATED"; break;
+   case VCP_VOLATILITY_STATIC:            result = "VCP_VOLATILITY_STATIC";            break;
+   }
+   return result;
+}
+
+
+/** Converts a volatility keyword, as used in feature definition files,
+ *  to a #Vcp_Volatility value.
+ *
+ *  @param  keyword  one of LIVE, TTL, WRITE, STATIC (case insensitive)
+ *  @return volatility class, VCP_VOLATILITY_UNSET if keyword invalid
+ */
+Vcp_Volatility
+vcp_volatility_from_keyword(const char * keyword) {
+   Vcp_Volatility result = VCP_VOLATILITY_UNSET;
+   if (g_ascii_strcasecmp(keyword, "LIVE") == 0)
+      result = VCP_VOLATILITY_LIVE;
+   else if (g_ascii_strcasecmp(keyword, "TTL") == 0)
+      result = VCP_VOLATILITY_TTL;
+   else if (g_ascii_strcasecmp(keyword, "WRITE") == 0)
+      result = VCP_VOLATILITY_WRITE_INVALIDATED;
+   else if (g_ascii_strcasecmp(keyword, "STATIC") == 0)
+      result = VCP_VOLATILITY_STATIC;
+   return result;
+}
+
+
 // DDCA_Feature_Metadata
 
 /** Output a debug report of a #DDCA_Feature_Metadata instance
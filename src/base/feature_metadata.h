@@ -96,6 +96,24 @@ char *
 interpret_feature_flags_t(DDCA_Version_Feature_Flags flags);
 
 
+// Feature value volatility
+
+/** How long a non-table feature value read from a display remains valid */
+typedef enum {
+   VCP_VOLATILITY_UNSET = 0,           ///< not specified, treated as VCP_VOLATILITY_LIVE
+   VCP_VOLATILITY_LIVE,                ///< always read from the display
+   VCP_VOLATILITY_TTL,                 ///< cached for a limited time
+   VCP_VOLATILITY_WRITE_INVALIDATED,   ///< cached until written or a change is reported
+   VCP_VOLATILITY_STATIC               ///< does not change during a session
+} Vcp_Volatility;
+
+char *
+vcp_volatility_name(Vcp_Volatility volatility);
+
+Vcp_Volatility
+vcp_volatility_from_keyword(const char * keyword);
+
+
 // DDCA_Feature_Metadata
 
 void
@@ -9,6 +9,8 @@
 #include <string.h>
 #include <glib-2.0/glib.h>
 
+#include "per_display_data.h"
+
 #include "last_io_event.h"
 
 
@@ -19,7 +21,15 @@ static gsize leave_event_initialized = 0;
 G_LOCK_DEFINE_STATIC(timestamps_lock);
 
 // Maintain timestamps
-
+//
+// Timestamp records for file descriptors less than FD_TABLE_SIZE are found
+// by direct index without locking, since they are looked up on every I/O
+// operation.  A slot is filled by atomic compare and exchange.  Records for
+// larger file descriptors are kept in array timestamps, protected by
+// timestamps_lock.
+
+#define FD_TABLE_SIZE 1024
+static IO_Event_Timestamp * timestamps_by_fd[FD_TABLE_SIZE];
 static GPtrArray * timestamps = NULL;
 
 
@@ -59,41 +69,79 @@ static void ensure_initialized() {
 }
 
 
+static IO_Event_Timestamp * new_io_event_timestamp(int fd) {
+   IO_Event_Timestamp * ts = calloc(1, sizeof(IO_Event_Timestamp));
+   memcpy(ts->marker, IO_EVENT_TIMESTAMP_MARKER, 4);
+   ts->fd = fd;
+   return ts;
+}
+
+
 IO_Event_Timestamp * get_io_event_timestamp(int fd)
 {
-   ensure_initialized();
-   G_LOCK(timestamps_lock);
-   IO_Event_Timestamp * ts = find_io_event_timestamp(fd);
-   if (!ts) {
-      ts = calloc(1, sizeof(IO_Event_Timestamp));
-      memcpy(ts->marker, IO_EVENT_TIMESTAMP_MARKER, 4);
-      ts->fd = fd;
-      g_ptr_array_add(timestamps, ts);
+   IO_Event_Timestamp * ts = NULL;
+   if (fd >= 0 && fd < FD_TABLE_SIZE) {
+      ts = g_atomic_pointer_get(&timestamps_by_fd[fd]);
+      if (!ts) {
+         IO_Event_Timestamp * newts = new_io_event_timestamp(fd);
+         if (g_atomic_pointer_compare_and_exchange(&timestamps_by_fd[fd], NULL, newts)) {
+            ts = newts;
+         }
+         else {   // another thread filled the slot
+            free_io_event_timestamp_internal(newts);
+            ts = g_atomic_pointer_get(&timestamps_by_fd[fd]);
+         }
+      }
+   }
+   else {
+      ensure_initialized();
+      G_LOCK(timestamps_lock);
+      ts = find_io_event_timestamp(fd);
+      if (!ts) {
+         ts = new_io_event_timestamp(fd);
+         g_ptr_array_add(timestamps, ts);
+      }
+      G_UNLOCK(timestamps_lock);
    }
-   G_UNLOCK(timestamps_lock);
    assert(ts);
    return ts;
 }
 
 
-// IO_Event_Timestamp * new_io_event_timestamp(int fd);
+void free_io_event_timestamp(int fd) {
+   if (fd >= 0 && fd < FD_TABLE_SIZE) {
+      IO_Event_Timestamp * ts = g_atomic_pointer_get(&timestamps_by_fd[fd]);
+      if (ts && g_atomic_pointer_compare_and_exchange(&timestamps_by_fd[fd], ts, NULL))
+         free_io_event_timestamp_internal(ts);
+   }
+   else {
+      ensure_initialized();
+      assert(timestamps);
+      G_LOCK(timestamps_lock);
+      IO_Event_Timestamp * ts = find_io_event_timestamp(fd);
+      if (ts)
+         g_ptr_array_remove(timestamps, ts);
+      G_UNLOCK(timestamps_lock);
+   }
+}
 
 
-void free_io_event_timestamp(int fd) {
-   ensure_initialized();
-   assert(timestamps);
-   G_LOCK(timestamps_lock);
-   IO_Event_Timestamp * ts = find_io_event_timestamp(fd);
-   if (ts)
-      g_ptr_array_remove(timestamps, ts);
-   G_UNLOCK(timestamps_lock);
+/** Associates the per-display data for a display with the file descriptor
+ *  on which it is open, so that I/O latency can be recorded by display.
+ *
+ *  \param  fd   Linux file descriptor
+ *  \param  pdd  per-display data, NULL when the display is closed
+ */
+void set_io_event_display_data(int fd, struct Per_Display_Data * pdd) {
+   IO_Event_Timestamp * tsrec = get_io_event_timestamp(fd);
+   g_atomic_pointer_set(&tsrec->pdd, pdd);
 }
 
 
 // *** Last IO
 
-void record_io_finish(
-      int           fd,
+static void record_io_finish_by_tsrec(
+      IO_Event_Timestamp * tsrec,
       uint64_t      finish_time,
       IO_Event_Type event_type,
       char *        filename,
@@ -101,9 +149,7 @@ void record_io_finish(
       char *        function)
 {
    bool debug = false;
-
-   IO_Event_Timestamp * tsrec = get_io_event_timestamp(fd);
-   assert(tsrec);
+   int fd = tsrec->fd;
 
    uint64_t prior_nanos = 0;
    uint64_t cur_nanos = 0;
@@ -142,6 +188,19 @@ void record_io_finish(
 }
 
 
+void record_io_finish(
+      int           fd,
+      uint64_t      finish_time,
+      IO_Event_Type event_type,
+      char *        filename,
+      int           lineno,
+      char *        function)
+{
+   IO_Event_Timestamp * tsrec = get_io_event_timestamp(fd);
+   record_io_finish_by_tsrec(tsrec, finish_time, event_type, filename, lineno, function);
+}
+
+
 // I2C_RECORD_IO_EVENT(
 //       IE_OPEN,
 //       ( fd = open(filename, (callopts & CALLOPT_RDONLY) ? O_RDONLY : O_RDWR) ),
@@ -151,3 +210,31 @@ void record_io_finish(
 // if (fd >= 0)
 // I2C_RECORD_IO_FINISH_NOW(busno, IE_OPEN, fd);
 
+
+/** Records the elapsed time of an I/O event, both globally and for the
+ *  display open on the file descriptor, and records its finish time.
+ *
+ *  \param  fd           Linux file descriptor
+ *  \param  start_time   start time of the event, in nanoseconds
+ *  \param  finish_time  finish time of the event, in nanoseconds
+ *  \param  event_type   e.g. IE_WRITE
+ *  \param  filename     file from which the event is recorded
+ *  \param  lineno       line number in file
+ *  \param  function     function name
+ */
+void record_io_event(
+      int           fd,
+      uint64_t      start_time,
+      uint64_t      finish_time,
+      IO_Event_Type event_type,
+      char *        filename,
+      int           lineno,
+      char *        function)
+{
+   log_io_call(event_type, function, start_time, finish_time);
+   IO_Event_Timestamp * tsrec = get_io_event_timestamp(fd);
+   record_io_finish_by_tsrec(tsrec, finish_time, event_type, filename, lineno, function);
+   struct Per_Display_Data * pdd = g_atomic_pointer_get(&tsrec->pdd);
+   if (pdd)
+      pdd_record_io_event(pdd, event_type, finish_time - start_time);
+}
@@ -11,6 +11,8 @@
 
 #include "execution_stats.h"
 
+struct Per_Display_Data;
+
 #define IO_EVENT_TIMESTAMP_MARKER "IOET"
 typedef
 struct {
@@ -21,11 +23,13 @@ struct {
    int           lineno;
    char *        function;
    int           fd;       // Linux file descriptor
+   struct Per_Display_Data * pdd;   // display open on fd, if any
 } IO_Event_Timestamp;
 
 IO_Event_Timestamp * get_io_event_timestamp(int fd);
 // IO_Event_Timestamp * new_io_event_timestamp(int fd);
 void free_io_event_timestamp(int fd);
+void set_io_event_display_data(int fd, struct Per_Display_Data * pdd);
 
 void record_io_finish(
       int              fd,
@@ -45,13 +49,21 @@ void record_io_finish(
    record_io_finish(_fd, cur_realtime_nanosec() , _event_type, (char*) __FILE__, __LINE__, (char*) __func__); \
    while(0)
 
-// combines log_io_call() with recrod_io_finish():
+void record_io_event(
+      int              fd,
+      uint64_t         start_time,
+      uint64_t         finish_time,
+      IO_Event_Type    event_type,
+      char *           filename,
+      int              lineno,
+      char *           function);
+
+// combines log_io_call() with record_io_finish(), and records per-display latency:
 #define RECORD_IO_EVENTX(_fd, _event_type, _cmd_to_time)  { \
    uint64_t _start_time = cur_realtime_nanosec(); \
    _cmd_to_time; \
    uint64_t  end_time = cur_realtime_nanosec(); \
-   log_io_call(_event_type, __func__, _start_time, end_time); \
-   record_io_finish(_fd, end_time, _event_type, __FILE__, __LINE__, (char *)__func__); \
+   record_io_event(_fd, _start_time, end_time, _event_type, __FILE__, __LINE__, (char *)__func__); \
 }
 
 #endif /* LAST_IO_EVENT_H_ */
@@ -49,6 +49,7 @@
 
 #define DEFAULT_EDID_READ_USES_I2C_LAYER  false
 #define DEFAULT_EDID_READ_BYTEWISE        false
+#define DEFAULT_EDID_READ_USES_SYSFS      true                  ///< try DRM connector before I2C
 
 
 // Strategy    Bytewise    read edid uses local i2c call                      read edid uses i2c layer
@@ -108,7 +109,11 @@
 // on banner with 4 displays, async  detect: 1.7 sec, non-async 3.4 sec
 #define DISPLAY_CHECK_ASYNC_NEVER    0xff
 #define DISPLAY_CHECK_ASYNC_THRESHOLD_STANDARD  3
-#define DISPLAY_CHECK_ASYNC_THRESHOLD_DEFAULT   DISPLAY_CHECK_ASYNC_NEVER
+#define DISPLAY_CHECK_ASYNC_THRESHOLD_DEFAULT   DISPLAY_CHECK_ASYNC_THRESHOLD_STANDARD
+
+/** Maximum number of threads in the worker pool used for detection and initial checks */
+#define WORKER_POOL_SIZE_DEFAULT   0     // number of processors
+#define WORKER_POOL_MAX_SIZE      32
 
 #define DEFAULT_SLEEP_LESS true
 
@@ -119,7 +124,18 @@
 #endif
 
 #define DEFAULT_ENABLE_CACHED_CAPABILITIES true
+#define DEFAULT_ENABLE_DETECTION_CACHE     false               ///< cached results skip the live DDC check
+#define DEFAULT_ENABLE_VCP_VALUE_CACHE     false
+#define DEFAULT_VCP_VALUE_CACHE_TTL_MILLIS 1000                ///< lifetime of VCP_VOLATILITY_TTL values
+#define DEFAULT_ENABLE_SETVCP_COALESCING   false               ///< queued set requests replace earlier ones
+#define DEFERRED_VERIFY_MAX_PENDING        16                  ///< deferred verifications are performed when this many are pending
+#define DEFAULT_DIFFERENTIAL_LOADVCP       false               ///< loadvcp writes only values that differ
+#define DDC_PACKET_POOL_SIZE               4                   ///< per-thread number of freed DDC packets kept for reuse
 #define DEFAULT_ENABLE_UDF true
 
+/** Use flock() based locks to serialize access to an I2C bus by multiple processes */
+#define DEFAULT_ENABLE_I2C_BUS_LOCKS       true
+#define I2C_BUS_LOCK_TIMEOUT_MILLIS        5000    ///< wait for lock held by another process
+
 
 #endif /* PARMS_H_ */
@@ -0,0 +1,393 @@
+/** @file per_display_data.c
+ *
+ *  Maintains sleep and retry data for each display, so that retries
+ *  caused by one display do not lengthen the sleeps performed for
+ *  other displays serviced by the same thread.
+ *
+ *  A #Per_Display_Data struct is allocated when the display's
+ *  #Display_Async_Rec is created, and persists for the life of the
+ *  program.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/report_util.h"
+#include "util/string_util.h"
+
+#include "base/core.h"
+#include "base/ddc_errno.h"
+#include "base/parms.h"
+#include "base/thread_retry_data.h"
+
+#include "base/per_display_data.h"
+
+
+/** Allocates and initializes a #Per_Display_Data struct.
+ *
+ *  \param  dpath  display identifier
+ *  \return newly allocated struct
+ */
+Per_Display_Data * pdd_new(DDCA_IO_Path dpath) {
+   Per_Display_Data * pdd = calloc(1, sizeof(Per_Display_Data));
+   memcpy(pdd->marker, PER_DISPLAY_DATA_MARKER, 4);
+   g_mutex_init(&pdd->pdd_mutex);
+   pdd->dpath = dpath;
+   pdd->sleep_multiplier_ct = 1;
+   pdd->highest_sleep_multiplier_value = 1;
+   return pdd;
+}
+
+
+static Per_Display_Data * get_pdd(Display_Handle * dh) {
+   assert(dh->dref->async_rec);
+   Per_Display_Data * pdd = dh->dref->async_rec->pdd;
+   assert(memcmp(pdd->marker, PER_DISPLAY_DATA_MARKER, 4) == 0);
+   return pdd;
+}
+
+
+//
+// Sleep multiplier count
+//
+
+/** Gets the sleep multiplier count for a display.
+ *
+ *  \param  dh  display handle
+ *  \return multiplier count
+ */
+int pdd_get_sleep_multiplier_ct(Display_Handle * dh) {
+   Per_Display_Data * pdd = get_pdd(dh);
+   g_mutex_lock(&pdd->pdd_mutex);
+   int result = pdd->sleep_multiplier_ct;
+   g_mutex_unlock(&pdd->pdd_mutex);
+   return result;
+}
+
+
+/** Sets the sleep multiplier count for a display.
+ *
+ *  \param  dh             display handle
+ *  \param  multiplier_ct  value to set
+ */
+void pdd_set_sleep_multiplier_ct(Display_Handle * dh, int multiplier_ct) {
+   bool debug = false;
+   DBGMSF(debug, "dh=%s, multiplier_ct=%d", dh_repr_t(dh), multiplier_ct);
+   assert(multiplier_ct > 0 && multiplier_ct < 100);
+   Per_Display_Data * pdd = get_pdd(dh);
+   g_mutex_lock(&pdd->pdd_mutex);
+   pdd->sleep_multiplier_ct = multiplier_ct;
+   if (multiplier_ct > pdd->highest_sleep_multiplier_value)
+      pdd->highest_sleep_multiplier_value = multiplier_ct;
+   g_mutex_unlock(&pdd->pdd_mutex);
+}
+
+
+/** Increments the number of function executions on a display
+ *  that changed the sleep multiplier count.
+ *
+ *  \param  dh  display handle
+ */
+void pdd_bump_sleep_multiplier_changer_ct(Display_Handle * dh) {
+   Per_Display_Data * pdd = get_pdd(dh);
+   g_mutex_lock(&pdd->pdd_mutex);
+   pdd->sleep_multiplier_changer_ct++;
+   g_mutex_unlock(&pdd->pdd_mutex);
+}
+
+
+//
+// Statistics
+//
+
+/** Records a sleep performed, or deferred, for a display.
+ *
+ *  \param  dh            display handle
+ *  \param  sleep_millis  sleep time in milliseconds
+ *  \param  deferred      true if the sleep was deferred
+ */
+void pdd_record_sleep(Display_Handle * dh, int sleep_millis, bool deferred) {
+   Per_Display_Data * pdd = get_pdd(dh);
+   g_mutex_lock(&pdd->pdd_mutex);
+   pdd->sleep_event_ct++;
+   if (deferred)
+      pdd->deferred_sleep_event_ct++;
+   pdd->total_sleep_millis += sleep_millis;
+   g_mutex_unlock(&pdd->pdd_mutex);
+}
+
+
+/** Records the number of tries for an operation on a display.
+ *
+ *  \param  dh          display handle
+ *  \param  retry_type  operation type
+ *  \param  rc          status code of the operation
+ *  \param  tryct       number of tries
+ *
+ *  \remark
+ *  Counters are indexed as for per-thread retry data: 0 for fatal
+ *  failure, 1 for failure after max tries, tryct+1 for success.
+ */
+void pdd_record_tries(Display_Handle * dh, Retry_Operation retry_type, int rc, int tryct) {
+   bool debug = false;
+   DBGMSF(debug, "dh=%s, retry_type=%s, rc=%d, tryct=%d",
+                 dh_repr_t(dh), retry_type_name(retry_type), rc, tryct);
+   int index = 0;
+   if (rc == 0)
+      index = tryct+1;
+   else if (rc == DDCRC_RETRIES || rc == DDCRC_ALL_TRIES_ZERO)
+      index = 1;
+   assert(index <= MAX_MAX_TRIES+1);
+
+   Per_Display_Data * pdd = get_pdd(dh);
+   g_mutex_lock(&pdd->pdd_mutex);
+   pdd->try_stats[retry_type].counters[index]++;
+   g_mutex_unlock(&pdd->pdd_mutex);
+}
+
+
+//
+// I/O latency
+//
+
+// I/O latency is recorded in per-thread instances, keyed by display, so that
+// recording an I/O event does not take the display's mutex.  The instances
+// are merged when latency is reported.  When a thread terminates its
+// histograms are added to Per_Display_Data.io_latency and its instance
+// is freed.
+//
+// Lock order: all_thread_io_latency_mutex, then a thread's mutex or
+// a display's pdd_mutex.  The latter two are never held together.
+typedef struct {
+   GMutex       mutex;        // contended only while latency is merged or reset
+   GHashTable * io_latency;   // Per_Display_Data * -> Latency_Histogram[IO_EVENT_TYPE_CT]
+} Thread_IO_Latency;
+
+static void retire_thread_io_latency(gpointer data);
+
+static GPtrArray * all_thread_io_latency = NULL;
+static GMutex      all_thread_io_latency_mutex;
+static GPrivate    thread_io_latency_key = G_PRIVATE_INIT(retire_thread_io_latency);
+
+
+// Destroy notify for thread_io_latency_key, called when a thread terminates
+static void retire_thread_io_latency(gpointer data) {
+   Thread_IO_Latency * thread_latency = data;
+   g_mutex_lock(&all_thread_io_latency_mutex);
+   g_ptr_array_remove_fast(all_thread_io_latency, thread_latency);
+   GHashTableIter iter;
+   gpointer key, value;
+   g_hash_table_iter_init(&iter, thread_latency->io_latency);
+   while (g_hash_table_iter_next(&iter, &key, &value)) {
+      Per_Display_Data * pdd = key;
+      Latency_Histogram * histograms = value;
+      g_mutex_lock(&pdd->pdd_mutex);
+      for (int ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++)
+         latency_histogram_merge(&pdd->io_latency[ndx], &histograms[ndx]);
+      g_mutex_unlock(&pdd->pdd_mutex);
+   }
+   g_mutex_unlock(&all_thread_io_latency_mutex);
+   g_hash_table_destroy(thread_latency->io_latency);
+   g_mutex_clear(&thread_latency->mutex);
+   free(thread_latency);
+}
+
+
+/** Records the elapsed time of an I/O event on a display.
+ *
+ *  \param  pdd         per-display data
+ *  \param  event_type  I/O event type
+ *  \param  nanos       elapsed time
+ *
+ *  \remark
+ *  The event is recorded in the current thread's instance, whose mutex is
+ *  contended only while latency is being reported or reset.
+ */
+void pdd_record_io_event(Per_Display_Data * pdd, IO_Event_Type event_type, uint64_t nanos) {
+   assert(memcmp(pdd->marker, PER_DISPLAY_DATA_MARKER, 4) == 0);
+   Thread_IO_Latency * thread_latency = g_private_get(&thread_io_latency_key);
+   if (!thread_latency) {
+      thread_latency = calloc(1, sizeof(Thread_IO_Latency));
+      g_mutex_init(&thread_latency->mutex);
+      thread_latency->io_latency = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free);
+      g_private_set(&thread_io_latency_key, thread_latency);
+      g_mutex_lock(&all_thread_io_latency_mutex);
+      if (!all_thread_io_latency)
+         all_thread_io_latency = g_ptr_array_new();
+      g_ptr_array_add(all_thread_io_latency, thread_latency);
+      g_mutex_unlock(&all_thread_io_latency_mutex);
+   }
+   g_mutex_lock(&thread_latency->mutex);
+   Latency_Histogram * histograms = g_hash_table_lookup(thread_latency->io_latency, pdd);
+   if (!histograms) {
+      histograms = calloc(IO_EVENT_TYPE_CT, sizeof(Latency_Histogram));
+      g_hash_table_insert(thread_latency->io_latency, pdd, histograms);
+   }
+   latency_histogram_record(&histograms[event_type], nanos);
+   g_mutex_unlock(&thread_latency->mutex);
+}
+
+
+// Merges the latency histograms for a display recorded by all threads
+static void get_io_latency_snapshot(Per_Display_Data * pdd, Latency_Histogram snapshot[IO_EVENT_TYPE_CT]) {
+   memset(snapshot, 0, IO_EVENT_TYPE_CT*sizeof(Latency_Histogram));
+   g_mutex_lock(&all_thread_io_latency_mutex);
+   if (all_thread_io_latency) {
+      for (int thread_ndx = 0; thread_ndx < all_thread_io_latency->len; thread_ndx++) {
+         Thread_IO_Latency * thread_latency = g_ptr_array_index(all_thread_io_latency, thread_ndx);
+         g_mutex_lock(&thread_latency->mutex);
+         Latency_Histogram * histograms = g_hash_table_lookup(thread_latency->io_latency, pdd);
+         if (histograms) {
+            for (int ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++)
+               latency_histogram_merge(&snapshot[ndx], &histograms[ndx]);
+         }
+         g_mutex_unlock(&thread_latency->mutex);
+      }
+   }
+   g_mutex_lock(&pdd->pdd_mutex);
+   for (int ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++)
+      latency_histogram_merge(&snapshot[ndx], &pdd->io_latency[ndx]);
+   g_mutex_unlock(&pdd->pdd_mutex);
+   g_mutex_unlock(&all_thread_io_latency_mutex);
+}
+
+
+/** Returns a copy of the latency histogram for an event type on a display.
+ *
+ *  \param  pdd            per-display data
+ *  \param  event_type     I/O event type
+ *  \param  histogram_loc  where to return the copy
+ */
+void pdd_get_io_latency(Per_Display_Data * pdd, IO_Event_Type event_type, Latency_Histogram * histogram_loc) {
+   assert(event_type >= 0 && event_type < IO_EVENT_TYPE_CT);
+   Latency_Histogram snapshot[IO_EVENT_TYPE_CT];
+   get_io_latency_snapshot(pdd, snapshot);
+   *histogram_loc = snapshot[event_type];
+}
+
+
+static void reset_pdd(Display_Async_Rec * async_rec, void * arg) {
+   Per_Display_Data * pdd = async_rec->pdd;
+   g_mutex_lock(&all_thread_io_latency_mutex);
+   if (all_thread_io_latency) {
+      for (int thread_ndx = 0; thread_ndx < all_thread_io_latency->len; thread_ndx++) {
+         Thread_IO_Latency * thread_latency = g_ptr_array_index(all_thread_io_latency, thread_ndx);
+         g_mutex_lock(&thread_latency->mutex);
+         g_hash_table_remove(thread_latency->io_latency, pdd);
+         g_mutex_unlock(&thread_latency->mutex);
+      }
+   }
+   g_mutex_lock(&pdd->pdd_mutex);
+   pdd->highest_sleep_multiplier_value = pdd->sleep_multiplier_ct;
+   pdd->sleep_multiplier_changer_ct = 0;
+   pdd->sleep_event_ct = 0;
+   pdd->deferred_sleep_event_ct = 0;
+   pdd->total_sleep_millis = 0;
+   memset(pdd->try_stats, 0, sizeof(pdd->try_stats));
+   memset(pdd->io_latency, 0, sizeof(pdd->io_latency));
+   g_mutex_unlock(&pdd->pdd_mutex);
+   g_mutex_unlock(&all_thread_io_latency_mutex);
+}
+
+
+/** Resets the statistics for all displays. */
+void pdd_reset_all() {
+   apply_all_display_async_recs(reset_pdd, NULL);
+}
+
+
+//
+// Reporting
+//
+
+static bool pdd_has_data(Per_Display_Data * pdd, Latency_Histogram io_latency[IO_EVENT_TYPE_CT]) {
+   if (pdd->sleep_event_ct > 0)
+      return true;
+   for (int ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++) {
+      if (io_latency[ndx].total_ct > 0)
+         return true;
+   }
+   for (int typendx = 0; typendx < RETRY_OP_COUNT; typendx++) {
+      for (int ndx = 0; ndx < MAX_MAX_TRIES+2; ndx++) {
+         if (pdd->try_stats[typendx].counters[ndx] > 0)
+            return true;
+      }
+   }
+   return false;
+}
+
+
+static void report_pdd(Per_Display_Data * pdd, Latency_Histogram io_latency[IO_EVENT_TYPE_CT], int depth) {
+   int d1 = depth+1;
+   int d2 = depth+2;
+   g_mutex_lock(&pdd->pdd_mutex);
+   rpt_vstring(depth, "Display %s:", dpath_repr_t(&pdd->dpath));
+   rpt_label(  d1,    "Sleep multiplier adjustment:");
+   rpt_vstring(d2,    "Current adjustment:                %d", pdd->sleep_multiplier_ct);
+   rpt_vstring(d2,    "Highest adjustment:                %d", pdd->highest_sleep_multiplier_value);
+   rpt_label(  d2,    "Number of function calls");
+   rpt_vstring(d2,    "   that performed adjustment:      %d", pdd->sleep_multiplier_changer_ct);
+   rpt_label(  d1,    "Sleeps:");
+   rpt_vstring(d2,    "Total sleep events:                %d", pdd->sleep_event_ct);
+   rpt_vstring(d2,    "Deferred sleep events:             %d", pdd->deferred_sleep_event_ct);
+   rpt_vstring(d2,    "Total sleep time (millis):         %"PRIu64, pdd->total_sleep_millis);
+   rpt_label(  d1,    "Tries:");
+   for (int typendx = 0; typendx < RETRY_OP_COUNT; typendx++) {
+      uint16_t * counters = pdd->try_stats[typendx].counters;
+      int highest_ndx = 1;
+      for (int ndx = MAX_MAX_TRIES+1; ndx > 1; ndx--) {
+         if (counters[ndx] > 0) {
+            highest_ndx = ndx;
+            break;
+         }
+      }
+      if (highest_ndx == 1 && counters[0] == 0 && counters[1] == 0)
+         continue;
+      char * buf = int_array_to_string(counters+2, highest_ndx-1);
+      rpt_vstring(d2, "%-27s successes by try: %s, failed max tries: %d, failed fatally: %d",
+                      retry_type_name(typendx), buf, counters[1], counters[0]);
+      free(buf);
+   }
+   report_latency_histograms(io_latency, d1);
+   g_mutex_unlock(&pdd->pdd_mutex);
+}
+
+
+/** Reports the sleep and retry data for a display.
+ *
+ *  \param  pdd    pointer to #Per_Display_Data
+ *  \param  depth  logical indentation depth
+ */
+void report_per_display_data(Per_Display_Data * pdd, int depth) {
+   Latency_Histogram io_latency[IO_EVENT_TYPE_CT];
+   get_io_latency_snapshot(pdd, io_latency);
+   report_pdd(pdd, io_latency, depth);
+}
+
+
+static void wrap_report_per_display_data(Display_Async_Rec * async_rec, void * arg) {
+   int depth = GPOINTER_TO_INT(arg);
+   Latency_Histogram io_latency[IO_EVENT_TYPE_CT];
+   get_io_latency_snapshot(async_rec->pdd, io_latency);
+   if (pdd_has_data(async_rec->pdd, io_latency)) {
+      report_pdd(async_rec->pdd, io_latency, depth);
+      rpt_nl();
+   }
+}
+
+
+/** Reports the sleep and retry data for all displays on which
+ *  DDC operations have been performed.
+ *
+ *  \param  depth  logical indentation depth
+ */
+void report_all_per_display_data(int depth) {
+   rpt_label(depth, "Sleep and retry data by display:");
+   rpt_nl();
+   apply_all_display_async_recs(wrap_report_per_display_data, GINT_TO_POINTER(depth+1));
+}
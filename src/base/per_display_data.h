@@ -0,0 +1,60 @@
+/** @file per_display_data.h
+ *
+ *  Maintains per-display sleep, retry, and I/O latency data
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef PER_DISPLAY_DATA_H_
+#define PER_DISPLAY_DATA_H_
+
+#include <glib-2.0/glib.h>
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "public/ddcutil_types.h"
+
+#include "base/displays.h"
+#include "base/execution_stats.h"
+#include "base/per_thread_data.h"
+
+#define PER_DISPLAY_DATA_MARKER "PDDT"
+/** Sleep and retry data for a display */
+typedef struct Per_Display_Data {
+   char           marker[4];
+   GMutex         pdd_mutex;
+   DDCA_IO_Path   dpath;
+
+   // Sleep adjustment
+   int            sleep_multiplier_ct;             // can be changed by retry logic
+   int            highest_sleep_multiplier_value;  // high water mark
+   int            sleep_multiplier_changer_ct;     // number of function calls that adjusted multiplier ct
+
+   // Sleep statistics
+   int            sleep_event_ct;
+   int            deferred_sleep_event_ct;
+   uint64_t       total_sleep_millis;              // includes deferred sleeps
+
+   // Retry statistics
+   Per_Thread_Try_Stats try_stats[RETRY_OP_COUNT];
+
+   // I/O latency recorded by terminated threads, see pdd_record_io_event()
+   Latency_Histogram    io_latency[IO_EVENT_TYPE_CT];
+} Per_Display_Data;
+
+Per_Display_Data * pdd_new(DDCA_IO_Path dpath);
+
+int    pdd_get_sleep_multiplier_ct(Display_Handle * dh);
+void   pdd_set_sleep_multiplier_ct(Display_Handle * dh, int multiplier_ct);
+void   pdd_bump_sleep_multiplier_changer_ct(Display_Handle * dh);
+void   pdd_record_sleep(Display_Handle * dh, int sleep_millis, bool deferred);
+void   pdd_record_tries(Display_Handle * dh, Retry_Operation retry_type, int rc, int tryct);
+void   pdd_record_io_event(Per_Display_Data * pdd, IO_Event_Type event_type, uint64_t nanos);
+void   pdd_get_io_latency(Per_Display_Data * pdd, IO_Event_Type event_type, Latency_Histogram * histogram_loc);
+
+void   pdd_reset_all();
+void   report_per_display_data(Per_Display_Data * pdd, int depth);
+void   report_all_per_display_data(int depth);
+
+#endif /* PER_DISPLAY_DATA_H_ */
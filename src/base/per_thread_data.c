@@ -308,26 +308,6 @@ void dbgrpt_per_thread_data(Per_Thread_Data * data, int depth) {
 
    rpt_vstring(d1, "sleep-multiplier value:           %15.2f", data->sleep_multiplier_factor);
 
-   // Sleep multiplier adjustment:
-   rpt_int("sleep_multiplier_ct",         NULL, data->sleep_multiplier_ct,        d1);
-   rpt_vstring(d1, "sleep_multiplier_changer_ct:      %15d",   data->sleep_multipler_changer_ct);
-   rpt_vstring(d1, "highest_sleep_multiplier_ct:      %15d",   data->highest_sleep_multiplier_value);
-
-   // Dynamic sleep adjustment:
-   rpt_int("current_ok_status_count",     NULL, data->current_ok_status_count,    d1);
-   rpt_int("current_error_status_count",  NULL, data->current_error_status_count, d1);
-   rpt_int("total_ok_status_count",       NULL, data->total_ok_status_count,      d1);
-   rpt_int("total_error",                 NULL, data->total_error_status_count,   d1);
-   rpt_int("other_status_ct",             NULL, data->total_other_status_ct,      d1);
-   rpt_int("calls_since_last_check",      NULL, data->calls_since_last_check,     d1);
-   rpt_int("total_adjustment_checks",     NULL, data->total_adjustment_checks,    d1);
-   rpt_int("adjustment_ct",               NULL, data->adjustment_ct,              d1);
-   rpt_int("max_adjustment_ct",           NULL, data->max_adjustment_ct,          d1);
-   rpt_int("non_adjustment_ct",           NULL, data->non_adjustment_ct,          d1);
-   rpt_vstring(d1, "current_sleep_adjustmet_factor     %15.2f", data->current_sleep_adjustment_factor);
-   rpt_vstring(d1, "thread_adjustment_increment        %15.2f", data->thread_adjustment_increment);
-   rpt_int("adjustment_check_interval",   NULL, data->adjustment_check_interval, d1);
-
    // Maxtries history
    rpt_bool("retry data initialized"    , NULL, data->thread_retry_data_defined, d1);
 
@@ -59,25 +59,6 @@ typedef struct {
    bool   thread_sleep_data_defined;
    double sleep_multiplier_factor;         // initially set by user
 
-   int    sleep_multiplier_ct    ;         // can be changed by retry logic
-   int    highest_sleep_multiplier_value;  // high water mark
-   int    sleep_multipler_changer_ct;      // number of function calls that adjusted multiplier ct
-
-   // For Dynamic Sleep Adjustment
-   int    current_ok_status_count;
-   int    current_error_status_count;
-   int    total_ok_status_count;
-   int    total_error_status_count;
-   int    total_other_status_ct;
-   int    calls_since_last_check;
-   int    total_adjustment_checks;
-   int    adjustment_ct;
-   int    non_adjustment_ct;
-   int    max_adjustment_ct;
-   double current_sleep_adjustment_factor;
-   double thread_adjustment_increment;
-   int    adjustment_check_interval;
-
    // Retry management
    bool thread_retry_data_defined;
    Retry_Op_Value current_maxtries[4];
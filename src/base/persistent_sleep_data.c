@@ -0,0 +1,329 @@
+/** \file persistent_sleep_data.c
+ *
+ *  Saves the dynamic sleep adjustment learned for each monitor model,
+ *  so that a new process starts from the tuned value instead of the
+ *  sleep times specified by DDC/CI.
+ *
+ *  Data is stored in file $HOME/.cache/ddcutil/dsa, one line per
+ *  monitor model, of the form:
+ *     <monitor model string>:<sleep adjustment factor> <ok count> <error count>
+ *
+ *  The counts are totals over all processes that have saved data for the
+ *  model.  Each process adds the counts it has recorded since it last saved,
+ *  rereading the file holding an exclusive lock on $HOME/.cache/ddcutil/dsa.lock
+ *  so that updates made by concurrent processes are not lost.  The file is
+ *  rewritten atomically, and read holding a shared lock.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <assert.h>
+#include <errno.h>
+#include <glib-2.0/glib.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "public/ddcutil_types.h"
+#include "public/ddcutil_status_codes.h"
+
+#include "util/error_info.h"
+#include "util/file_util.h"
+#include "util/report_util.h"
+#include "util/string_util.h"
+#include "util/xdg_util.h"
+
+#include "base/core.h"
+#include "base/monitor_model_key.h"
+#include "base/rtti.h"
+
+#include "base/persistent_sleep_data.h"
+
+static DDCA_Trace_Group TRACE_GROUP  = DDCA_TRC_SLEEP;
+
+static bool persistent_sleep_data_enabled = false;
+static GHashTable *  sleep_data_hash = NULL;     // monitor model string -> Persistent_Sleep_Data *
+static GMutex persistent_sleep_data_mutex;
+
+
+static void dbgrpt_sleep_data_hash0(int depth, const char * msg) {
+   int d = depth;
+   if (msg) {
+      rpt_label(depth, msg);
+      d = depth+1;
+   }
+   if (!sleep_data_hash)
+      rpt_label(d, "No sleep data hash table");
+   else {
+      if (g_hash_table_size(sleep_data_hash) == 0)
+         rpt_label(d, "Empty sleep data hash table");
+      else {
+         GHashTableIter iter;
+         gpointer key, value;
+         g_hash_table_iter_init(&iter, sleep_data_hash);
+         while (g_hash_table_iter_next(&iter, &key, &value)) {
+            Persistent_Sleep_Data * data = value;
+            rpt_vstring(d, "%s : factor=%5.2f, ok_status_count=%d, error_status_count=%d",
+                           (char *) key, data->sleep_adjustment_factor,
+                           data->ok_status_count, data->error_status_count);
+         }
+      }
+   }
+}
+
+
+static char * get_persistent_sleep_data_lock_file_name() {
+   return xdg_cache_home_file("ddcutil", "dsa.lock");
+}
+
+
+// Reads the file into sleep_data_hash.
+// The caller must hold the sleep data lock file.
+static Error_Info * load_persistent_sleep_data_file() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "");
+
+   Error_Info * errs = NULL;
+   if (sleep_data_hash)
+      g_hash_table_destroy(sleep_data_hash);
+   sleep_data_hash = g_hash_table_new_full(g_str_hash, g_str_equal, free, free);
+
+   char * data_file_name = get_persistent_sleep_data_file_name();
+   DBGTRC_NOPREFIX(debug, TRACE_GROUP, "data_file_name: %s", data_file_name);
+   GPtrArray * linearray = g_ptr_array_new_with_free_func(g_free);
+   errs = file_getlines_errinfo(data_file_name, linearray);
+   free(data_file_name);
+   if (!errs) {
+      for (int ndx = 0; ndx < linearray->len; ndx++) {
+         char * aline = strtrim(g_ptr_array_index(linearray, ndx));
+         if (strlen(aline) > 0 && aline[0] != '*' && aline[0] != '#') {
+            Persistent_Sleep_Data data;
+            char * colon = strchr(aline, ':');
+            if (!colon ||
+                sscanf(colon+1, "%lf %d %d", &data.sleep_adjustment_factor,
+                                             &data.ok_status_count,
+                                             &data.error_status_count) != 3 ||
+                !isfinite(data.sleep_adjustment_factor) ||
+                data.sleep_adjustment_factor <= 0)
+            {
+               if (!errs)
+                  errs = errinfo_new(DDCRC_BAD_DATA, __func__);
+               errinfo_add_cause(errs, errinfo_new2(DDCRC_BAD_DATA, __func__,
+                                                    "Line %d, invalid data: %s",
+                                                     ndx+1, aline));
+            }
+            else {
+               *colon = '\0';
+               Persistent_Sleep_Data * newdata = calloc(1, sizeof(Persistent_Sleep_Data));
+               *newdata = data;
+               g_hash_table_insert(sleep_data_hash, strdup(aline), newdata);
+            }
+         }
+         free(aline);
+      }
+   }
+   g_ptr_array_free(linearray, true);
+
+   if (debug || IS_TRACING())
+      dbgrpt_sleep_data_hash0(2, "sleep_data_hash:");
+   DBGTRC_RET_ERRINFO(debug, TRACE_GROUP, errs, "");
+   return errs;
+}
+
+
+static bool write_sleep_data_lines(FILE * fp, void * arg) {
+   bool ok = true;
+   GHashTableIter iter;
+   gpointer key, value;
+   g_hash_table_iter_init(&iter, sleep_data_hash);
+   while (g_hash_table_iter_next(&iter, &key, &value)) {
+      Persistent_Sleep_Data * data = value;
+      int ct = fprintf(fp, "%s:%.2f %d %d\n", (char *) key,
+                           data->sleep_adjustment_factor,
+                           data->ok_status_count,
+                           data->error_status_count);
+      if (ct < 0) {
+         ok = false;
+         break;
+      }
+   }
+   return ok;
+}
+
+
+// Rewrites the file from sleep_data_hash.
+// The caller must hold the sleep data lock file exclusively.
+static void save_persistent_sleep_data_file() {
+   bool debug = false;
+   char * data_file_name = get_persistent_sleep_data_file_name();
+   DBGTRC_STARTING(debug, TRACE_GROUP, "data_file_name=%s", data_file_name);
+
+   write_file_atomically(data_file_name, write_sleep_data_lines, NULL, ferr());
+
+   free(data_file_name);
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+// (Re)loads the file, reporting any errors.
+// The caller must hold the mutex and the sleep data lock file.
+static void reload_sleep_data() {
+   Error_Info * errs = load_persistent_sleep_data_file();
+   if (errs) {
+      if (ERRINFO_STATUS(errs) == -ENOENT)
+         errinfo_free(errs);
+      else
+         ERRINFO_FREE_WITH_REPORT(errs,true);
+   }
+}
+
+
+// loads the file if not already loaded, must be called with mutex held
+static void ensure_sleep_data_loaded() {
+   if (!sleep_data_hash) {
+      char * lockfn = get_persistent_sleep_data_lock_file_name();
+      int lockfd = file_lock(lockfn, false, ferr());
+      free(lockfn);
+      reload_sleep_data();
+      file_unlock(lockfd);
+   }
+}
+
+
+// Publicly visible functions
+
+/** Emit a debug report of the persistent sleep data hash table
+ *
+ *  \param depth  logical indentation depth
+ *  \param msg    if non-null, emit this message before the report
+ */
+void dbgrpt_persistent_sleep_data_hash(int depth, const char * msg) {
+   g_mutex_lock(&persistent_sleep_data_mutex);
+   dbgrpt_sleep_data_hash0(depth, msg);
+   g_mutex_unlock(&persistent_sleep_data_mutex);
+}
+
+
+/** Returns the name of the file that stores learned sleep data
+ *
+ *  \return name of file, normally $HOME/.cache/ddcutil/dsa
+ */
+/* caller is responsible for freeing returned value */
+char * get_persistent_sleep_data_file_name() {
+   return xdg_cache_home_file("ddcutil", "dsa");
+}
+
+
+/** Enable loading and saving learned sleep data.
+ *
+ *  \param  newval   true to enable, false to disable
+ *  \return old setting
+ *
+ *  \remark
+ *  Unlike the capabilities cache, disabling does not delete the file,
+ *  since it is still valid when dynamic sleep adjustment is next enabled.
+ */
+bool enable_persistent_sleep_data(bool newval) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "newval=%s", sbool(newval));
+   g_mutex_lock(&persistent_sleep_data_mutex);
+   bool old = persistent_sleep_data_enabled;
+   persistent_sleep_data_enabled = newval;
+   g_mutex_unlock(&persistent_sleep_data_mutex);
+   DBGTRC_RET_BOOL(debug, TRACE_GROUP, old, "");
+   return old;
+}
+
+
+bool is_persistent_sleep_data_enabled() {
+   return persistent_sleep_data_enabled;
+}
+
+
+/** Looks up the learned sleep data for a monitor model.
+ *
+ *  \param  mmk       monitor model key
+ *  \param  data_loc  where to copy the data
+ *  \return true if found, false if not found or persistence not enabled
+ */
+bool get_persistent_sleep_data(DDCA_Monitor_Model_Key * mmk, Persistent_Sleep_Data * data_loc)
+{
+   assert(mmk);
+   assert(data_loc);
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "mmk -> %s", mmk_repr(*mmk));
+
+   bool found = false;
+   g_mutex_lock(&persistent_sleep_data_mutex);
+   if (persistent_sleep_data_enabled) {
+      ensure_sleep_data_loaded();
+      Persistent_Sleep_Data * data = g_hash_table_lookup(sleep_data_hash, monitor_model_string(mmk));
+      if (data) {
+         *data_loc = *data;
+         found = true;
+      }
+   }
+   g_mutex_unlock(&persistent_sleep_data_mutex);
+
+   DBGTRC_RET_BOOL(debug, TRACE_GROUP, found, "");
+   return found;
+}
+
+
+/** Saves the learned sleep data for a monitor model.
+ *
+ *  The sleep adjustment factor replaces the saved value.  The counts are
+ *  added to the saved counts, which are first reread from the file so that
+ *  counts saved by other processes are preserved.  The file is rewritten
+ *  only if the data has changed.
+ *
+ *  \param  mmk    monitor model key
+ *  \param  data   factor, and counts recorded since the last save
+ */
+void update_persistent_sleep_data(DDCA_Monitor_Model_Key * mmk, Persistent_Sleep_Data * data)
+{
+   assert(mmk);
+   assert(data);
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "mmk -> %s, factor=%5.2f, ok=%d, error=%d",
+                   mmk_repr(*mmk), data->sleep_adjustment_factor,
+                   data->ok_status_count, data->error_status_count);
+
+   g_mutex_lock(&persistent_sleep_data_mutex);
+   if (persistent_sleep_data_enabled) {
+      char * lockfn = get_persistent_sleep_data_lock_file_name();
+      int lockfd = file_lock(lockfn, true, ferr());
+      free(lockfn);
+      reload_sleep_data();
+
+      char * mms = monitor_model_string(mmk);
+      Persistent_Sleep_Data * old = g_hash_table_lookup(sleep_data_hash, mms);
+      Persistent_Sleep_Data merged = *data;
+      if (old) {
+         merged.ok_status_count    += old->ok_status_count;
+         merged.error_status_count += old->error_status_count;
+      }
+      if (!old || memcmp(old, &merged, sizeof(Persistent_Sleep_Data)) != 0) {
+         Persistent_Sleep_Data * newdata = calloc(1, sizeof(Persistent_Sleep_Data));
+         *newdata = merged;
+         g_hash_table_replace(sleep_data_hash, strdup(mms), newdata);
+         save_persistent_sleep_data_file();
+      }
+      file_unlock(lockfd);
+   }
+   g_mutex_unlock(&persistent_sleep_data_mutex);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+void init_persistent_sleep_data() {
+   RTTI_ADD_FUNC(load_persistent_sleep_data_file);
+   RTTI_ADD_FUNC(save_persistent_sleep_data_file);
+   RTTI_ADD_FUNC(enable_persistent_sleep_data);
+   RTTI_ADD_FUNC(get_persistent_sleep_data);
+   RTTI_ADD_FUNC(update_persistent_sleep_data);
+}
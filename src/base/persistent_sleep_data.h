@@ -0,0 +1,29 @@
+/** \file persistent_sleep_data.h */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef PERSISTENT_SLEEP_DATA_H_
+#define PERSISTENT_SLEEP_DATA_H_
+
+#include <stdbool.h>
+
+#include "private/ddcutil_types_private.h"
+#include "util/error_info.h"
+
+/** Dynamic sleep adjustment state learned for a monitor model */
+typedef struct {
+   double sleep_adjustment_factor;
+   int    ok_status_count;
+   int    error_status_count;
+} Persistent_Sleep_Data;
+
+bool   enable_persistent_sleep_data(bool onoff);
+bool   is_persistent_sleep_data_enabled();
+char * get_persistent_sleep_data_file_name();
+bool   get_persistent_sleep_data(DDCA_Monitor_Model_Key * mmk, Persistent_Sleep_Data * data_loc);
+void   update_persistent_sleep_data(DDCA_Monitor_Model_Key * mmk, Persistent_Sleep_Data * data);
+void   dbgrpt_persistent_sleep_data_hash(int depth, const char * msg);
+void   init_persistent_sleep_data();
+
+#endif /* PERSISTENT_SLEEP_DATA_H_ */
@@ -24,6 +24,7 @@
 #include "base/parms.h"
 #include "base/core.h"
 #include "base/sleep.h"
+#include "base/dynamic_sleep.h"
 
 #include "base/per_thread_data.h"
 #include "base/thread_sleep_data.h"
@@ -38,13 +39,12 @@
  * sleep_multiplier_factor: set globally, e.g. from arg passed on
  * command line.  Consider making thread specific.
  *
- * sleep_multiplier_ct: Per thread adjustment,initiated by IO retries.
+ * sleep_multiplier_ct: Per display adjustment, initiated by IO retries.
+ * See per_display_data.c
  */
 
-// Defaults for new threads.  Default sleep multiplier factor can be adjusted,
-// Default sleep multiplier count cannot.
+// Defaults for new threads.
 static       double default_sleep_multiplier_factor = 1.0;
-static const int    default_sleep_multiplier_count  = 1;
 static       bool   default_dynamic_sleep_enabled   = false;
 static       double global_sleep_multiplier_factor = 1.0;   // as set by --sleep-multiplier option
 
@@ -70,28 +70,6 @@ void report_thread_sleep_data(Per_Thread_Data * data, int depth) {
    rpt_vstring(d2,    "Description:                       %s", (data->description) ? data->description : "Not set");
    rpt_vstring(d2,    "Current sleep-multiplier factor:  %5.2f", data->sleep_multiplier_factor);
    rpt_vstring(d2,    "Dynamic sleep enabled:             %s",  sbool(data->dynamic_sleep_enabled));
-
-   rpt_label(  d1,   "Sleep multiplier adjustment:");
-   rpt_vstring(d2,    "Current adjustment:                %d", data->sleep_multiplier_ct);
-   rpt_vstring(d2,    "Highest adjustment:                %d", data->highest_sleep_multiplier_value);
-   rpt_label(  d2,    "Number of function calls");
-   rpt_vstring(d2,    "   that performed adjustment:      %d", data->sleep_multipler_changer_ct);
-
-   if ( data->dynamic_sleep_enabled ) {
-      rpt_label(  d1, "Dynamic Sleep Adjustment:  ");
-      rpt_vstring(d2, "Total successful reads:          %5d",   data->total_ok_status_count);
-      rpt_vstring(d2, "Total reads with DDC error:      %5d",   data->total_error_status_count);
-      rpt_vstring(d2, "Total ignored status codes:      %5d",   data->total_other_status_ct);
-      rpt_vstring(d2, "Current sleep adjustment factor: %5.2f", data->current_sleep_adjustment_factor);
-      rpt_vstring(d2, "Thread adjustment increment:     %5.2f", data->thread_adjustment_increment);
-      rpt_vstring(d2, "Adjustment check interval        %5d",   data->adjustment_check_interval);
-
-      rpt_vstring(d2, "Calls since last check:          %5d",   data->calls_since_last_check);
-      rpt_vstring(d2, "Total adjustment checks:         %5d",   data->total_adjustment_checks);
-      rpt_vstring(d2, "Number of adjustments:           %5d",   data->adjustment_ct);
-      rpt_vstring(d2, "Number of excess adjustments:    %5d",   data->max_adjustment_ct);
-      rpt_vstring(d2, "Final sleep adjustment:          %5.2f", data->current_sleep_adjustment_factor);
-   }
 }
 
 
@@ -147,8 +125,15 @@ void report_all_thread_sleep_data(int depth) {
    // rpt_vstring(d1, "cross thread operations blocked: %d", cross_thread_operation_blocked_count);
 
    ptd_apply_all_sorted(&wrap_report_thread_sleep_data, GINT_TO_POINTER(depth+1) );
-   DBGMSF(debug, "Done");
    rpt_nl();
+
+   // dynamic sleep adjustment is maintained per display, not per thread
+   if (tsd_get_dsa_enabled_default()) {
+      rpt_label(depth, "Per display dynamic sleep adjustment");
+      report_all_dsa_tuners(depth+1);
+      rpt_nl();
+   }
+   DBGMSF(debug, "Done");
 }
 
 
@@ -236,14 +221,8 @@ Per_Thread_Data * tsd_get_thread_sleep_data() {
 // initialize a single instance
 void init_thread_sleep_data(Per_Thread_Data * data) {
    data->dynamic_sleep_enabled = default_dynamic_sleep_enabled;
-   data->sleep_multiplier_ct = default_sleep_multiplier_count;
-   data->highest_sleep_multiplier_value = 1;
-
-   data->current_sleep_adjustment_factor = 1.0;
    data->initialized = true;
    data->sleep_multiplier_factor = global_sleep_multiplier_factor;    // default
-   data->thread_adjustment_increment = global_sleep_multiplier_factor;
-   data->adjustment_check_interval = 2;
 
    data->thread_sleep_data_defined = true;   // vs data->initialized
 }
@@ -251,14 +230,6 @@ void init_thread_sleep_data(Per_Thread_Data * data) {
 
 void reset_thread_sleep_data(Per_Thread_Data * data) {
    ptd_cross_thread_operation_block();
-   data->highest_sleep_multiplier_value = data->sleep_multiplier_ct;
-   data->sleep_multipler_changer_ct = 0;
-   data->total_ok_status_count = 0;
-   data->total_error_status_count = 0;
-   data->total_other_status_ct = 0;
-   data->total_adjustment_checks = 0;
-   data->adjustment_ct = 0;
-   data->max_adjustment_ct = 0;
 }
 
 
@@ -354,7 +325,6 @@ void tsd_set_sleep_multiplier_factor(double factor) {
    ptd_cross_thread_operation_block();
    Per_Thread_Data * data = tsd_get_thread_sleep_data();
    data->sleep_multiplier_factor = factor;
-   data->thread_adjustment_increment = factor;
    DBGMSF(debug, "Done");
 }
 
@@ -378,44 +348,6 @@ double get_global_sleep_multiplier_factor() {
 
 
 
-//
-// Sleep Multiplier Count
-//
-
-/** Gets the multiplier count for the current thread.
- *
- *  \return multiplier count
- */
-int tsd_get_sleep_multiplier_ct() {
-   Per_Thread_Data * data = tsd_get_thread_sleep_data();
-   return data->sleep_multiplier_ct;
-}
-
-
-/** Sets the multiplier count for the current thread.
- *
- *  \parsm multipler_ct  value to set
- */
-void tsd_set_sleep_multiplier_ct(int multiplier_ct) {
-   assert(multiplier_ct > 0 && multiplier_ct < 100);
-   ptd_cross_thread_operation_start();
-   Per_Thread_Data * data = tsd_get_thread_sleep_data();
-   data->sleep_multiplier_ct = multiplier_ct;
-   if (multiplier_ct > data->highest_sleep_multiplier_value)
-      data->highest_sleep_multiplier_value = multiplier_ct;
-   ptd_cross_thread_operation_end();
-   // DBGMSG("Setting sleep_multiplier_ct = %d", settings->sleep_multiplier_ct);
-}
-
-
-// Number of function executions that changed the multiplier
-void tsd_bump_sleep_multiplier_changer_ct() {
-   ptd_cross_thread_operation_block();
-   Per_Thread_Data * data = tsd_get_thread_sleep_data();
-   data->sleep_multipler_changer_ct++;
-}
-
-
 #ifdef UNUSED
 // apply the sleep-multiplier to any existing threads
 // it will be set for new threads from global_sleep_multiplier_factor
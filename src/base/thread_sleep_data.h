@@ -40,12 +40,6 @@ double tsd_get_default_sleep_multiplier_factor();
 double tsd_get_sleep_multiplier_factor();
 void   tsd_set_sleep_multiplier_factor(double factor);
 
-//  sleep_multiplier_ct is set by functions performing I2C retry
-//  Per thread
-int    tsd_get_sleep_multiplier_ct();
-void   tsd_set_sleep_multiplier_ct(int multiplier_ct);
-void   tsd_bump_sleep_multiplier_changer_ct();
-
 // Reporting
 void   report_thread_sleep_data(Per_Thread_Data * data, int depth);
 // void   report_all_thread_sleep_data(int depth);
@@ -22,6 +22,7 @@
 #include "base/parms.h"
 #include "base/dynamic_sleep.h"
 #include "base/execution_stats.h"
+#include "base/per_display_data.h"
 #include "base/sleep.h"
 #include "base/thread_sleep_data.h"
 
@@ -62,7 +63,7 @@ bool is_deferred_sleep_enabled() {
  * sleep_multiplier_factor: set globally, e.g. from arg passed on
  * command line.  Consider making thread specific.
  *
- * sleep_multiplier_ct: Per thread adjustment,initiated by io retries.
+ * sleep_multiplier_ct: Per display adjustment, initiated by io retries.
  */
 
 
@@ -74,15 +75,13 @@ bool is_deferred_sleep_enabled() {
  *  by the io mode and sleep event type.
  *
  *  The time is further adjusted by the sleep factor and sleep multiplier
- *  currently in effect.
+ *  currently in effect.  The sleep multiplier count and dynamic sleep
+ *  adjustment are maintained per display, so that errors on one display
+ *  do not lengthen the sleeps for other displays serviced by the same thread.
  *
  *  \todo
  *  Take into account the time since the last monitor return in the
  *  current thread.
- *  \todo
- *  Take into account per-display error statistics.  Would require
- *  error statistics be maintained on a per-display basis, either
- *  in the display reference or display handle.
  *
  * \param io_mode     communication mechanism
  * \param event_type  reason for sleep
@@ -139,10 +138,10 @@ void tuned_sleep_with_tracex(
                // 4.4 Set VCP Feature:
                //   The host should wait at least 50ms to ensure next message is received by the display
                spec_sleep_time_millis = DDC_TIMEOUT_MILLIS_POST_NORMAL_COMMAND;
-               deferrable_sleep = deferred_sleep_enabled;
+               deferrable_sleep = deferred_sleep_enabled || dh->defer_sleeps;
                break;
          case (SE_POST_READ):
-               deferrable_sleep = deferred_sleep_enabled;
+               deferrable_sleep = deferred_sleep_enabled || dh->defer_sleeps;
                spec_sleep_time_millis = DDC_TIMEOUT_MILLIS_POST_NORMAL_COMMAND;
                if (sleep_suppression_enabled) {
                   suppress = true;
@@ -245,13 +244,13 @@ void tuned_sleep_with_tracex(
       //   get error rate (total calls, total errors), current adjustment value
       //   adjust by time since last i2c event
 
-      double dynamic_sleep_adjustment_factor = dsa_get_sleep_adjustment();
+      double dynamic_sleep_adjustment_factor = dsa_get_sleep_adjustment(dh);
 
       // DBGMSG("Calling tsd_get_sleep_multiplier_factor()");
       double sleep_multiplier_factor = tsd_get_sleep_multiplier_factor();
       // DBGMSG("sleep_multiplier_factor = %5.2f", sleep_multiplier_factor);
       // crude, should be sensitive to event type?
-      int sleep_multiplier_ct = tsd_get_sleep_multiplier_ct();  // per thread
+      int sleep_multiplier_ct = pdd_get_sleep_multiplier_ct(dh);  // per display
       double adjusted_sleep_time_millis = sleep_multiplier_ct * sleep_multiplier_factor *
                                           spec_sleep_time_millis * dynamic_sleep_adjustment_factor;
       if (debug && false) {    // TMI for now
@@ -269,6 +268,7 @@ void tuned_sleep_with_tracex(
       }
 
       record_sleep_event(event_type);
+      pdd_record_sleep(dh, adjusted_sleep_time_millis, deferrable_sleep);
 
       char msg_buf[100];
       const char * evname = sleep_event_name(event_type);
@@ -0,0 +1,224 @@
+/** @file worker_pool.c
+ *
+ *  Bounded pool of worker threads shared by display detection,
+ *  EDID reads, and initial display checks.
+ *
+ *  Creating a thread per bus or per display does not scale on systems
+ *  with many I2C buses (docks, MST hubs), and is not worth its cost
+ *  on systems with only one or two.  Instead, work is submitted to a
+ *  single #GThreadPool whose size defaults to the number of processors.
+ *
+ *  A batch submitted from a thread that is itself a pool worker is
+ *  executed inline, so nested use cannot exhaust the pool and deadlock.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "util/report_util.h"
+
+#include "base/core.h"
+#include "base/parms.h"
+#include "base/rtti.h"
+
+#include "base/worker_pool.h"
+
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_BASE;
+
+static GThreadPool * worker_pool = NULL;
+static GMutex        worker_pool_mutex;
+static int           requested_pool_size = WORKER_POOL_SIZE_DEFAULT;   // 0 = number of processors
+static GPrivate      is_worker_thread_key;
+
+/** Set of work items submitted together, waited for as a unit.
+ *
+ *  Referenced by the submitting thread and by each queued task.  The
+ *  last holder to release its reference frees the batch, so a worker
+ *  can still be unlocking the batch mutex after the submitter resumes.
+ */
+typedef struct {
+   Worker_Pool_Func  func;
+   gpointer          arg;
+   int               remaining_ct;
+   gint              ref_ct;
+   GMutex            batch_mutex;
+   GCond             batch_cond;
+} Worker_Batch;
+
+/** A single work item queued to the pool */
+typedef struct {
+   Worker_Batch *    batch;
+   gpointer          item;
+} Worker_Task;
+
+
+static int effective_pool_size() {
+   int size = requested_pool_size;
+   if (size <= 0)
+      size = g_get_num_processors();
+   if (size > WORKER_POOL_MAX_SIZE)
+      size = WORKER_POOL_MAX_SIZE;
+   return size;
+}
+
+
+/** Sets the maximum number of worker threads.
+ *
+ *  \param  size  number of threads, <= 0 to use the number of processors
+ *
+ *  \remark
+ *  A size of 1 causes all batches to execute serially on the calling thread.
+ */
+void set_worker_pool_size(int size) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "size=%d", size);
+
+   g_mutex_lock(&worker_pool_mutex);
+   requested_pool_size = size;
+   if (worker_pool)
+      g_thread_pool_set_max_threads(worker_pool, effective_pool_size(), NULL);
+   g_mutex_unlock(&worker_pool_mutex);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "effective size: %d", get_worker_pool_size());
+}
+
+
+/** Returns the maximum number of worker threads.
+ *
+ *  \return number of threads
+ */
+int get_worker_pool_size() {
+   g_mutex_lock(&worker_pool_mutex);
+   int result = effective_pool_size();
+   g_mutex_unlock(&worker_pool_mutex);
+   return result;
+}
+
+
+/** Reports whether the current thread is a pool worker.
+ *
+ *  \return true if a worker thread, false if not
+ */
+bool is_worker_pool_thread() {
+   return GPOINTER_TO_INT(g_private_get(&is_worker_thread_key));
+}
+
+
+static void unref_worker_batch(Worker_Batch * batch) {
+   if (g_atomic_int_dec_and_test(&batch->ref_ct)) {
+      g_mutex_clear(&batch->batch_mutex);
+      g_cond_clear(&batch->batch_cond);
+      free(batch);
+   }
+}
+
+
+static void worker_pool_task(gpointer data, gpointer user_data) {
+   Worker_Task * task = data;
+   Worker_Batch * batch = task->batch;
+   g_private_set(&is_worker_thread_key, GINT_TO_POINTER(1));
+
+   batch->func(task->item, batch->arg);
+   free(task);
+
+   g_mutex_lock(&batch->batch_mutex);
+   if (--batch->remaining_ct == 0)
+      g_cond_signal(&batch->batch_cond);
+   g_mutex_unlock(&batch->batch_mutex);
+   unref_worker_batch(batch);
+}
+
+
+// must be called with worker_pool_mutex held
+static GThreadPool * get_worker_pool() {
+   if (!worker_pool) {
+      GError * error = NULL;
+      worker_pool = g_thread_pool_new(worker_pool_task,
+                                      NULL,
+                                      effective_pool_size(),
+                                      false,        // not exclusive
+                                      &error);
+      if (!worker_pool) {
+         SEVEREMSG("Unable to create worker pool: %s", error->message);
+         g_error_free(error);
+      }
+   }
+   return worker_pool;
+}
+
+
+/** Executes a function on each item of an array using the worker pool,
+ *  and waits until all have completed.
+ *
+ *  \param  items  #GPtrArray of work items
+ *  \param  func   function to execute on each item
+ *  \param  arg    additional argument passed to **func**
+ *
+ *  \remark
+ *  Items are processed on the calling thread if there is only one,
+ *  if the pool size is 1, or if the caller is itself a worker thread.
+ */
+void run_in_worker_pool(GPtrArray * items, Worker_Pool_Func func, gpointer arg) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "item count=%d, func=%p", items->len, func);
+
+   GThreadPool * pool = NULL;
+   if (items->len > 1 && !is_worker_pool_thread()) {
+      g_mutex_lock(&worker_pool_mutex);
+      if (effective_pool_size() > 1)
+         pool = get_worker_pool();
+      g_mutex_unlock(&worker_pool_mutex);
+   }
+
+   if (!pool) {
+      for (int ndx = 0; ndx < items->len; ndx++)
+         func(g_ptr_array_index(items, ndx), arg);
+      DBGTRC_DONE(debug, TRACE_GROUP, "Executed inline");
+      return;
+   }
+
+   Worker_Batch * batch = calloc(1, sizeof(Worker_Batch));
+   batch->func = func;
+   batch->arg  = arg;
+   batch->remaining_ct = items->len;
+   batch->ref_ct = items->len + 1;      // one per task, one for this thread
+   g_mutex_init(&batch->batch_mutex);
+   g_cond_init(&batch->batch_cond);
+
+   for (int ndx = 0; ndx < items->len; ndx++) {
+      Worker_Task * task = calloc(1, sizeof(Worker_Task));
+      task->batch = batch;
+      task->item  = g_ptr_array_index(items, ndx);
+      g_thread_pool_push(pool, task, NULL);
+   }
+
+   g_mutex_lock(&batch->batch_mutex);
+   while (batch->remaining_ct > 0)
+      g_cond_wait(&batch->batch_cond, &batch->batch_mutex);
+   g_mutex_unlock(&batch->batch_mutex);
+
+   unref_worker_batch(batch);
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+void init_worker_pool() {
+   RTTI_ADD_FUNC(set_worker_pool_size);
+   RTTI_ADD_FUNC(run_in_worker_pool);
+}
+
+
+/** Releases the worker pool after waiting for queued work to finish. */
+void terminate_worker_pool() {
+   g_mutex_lock(&worker_pool_mutex);
+   if (worker_pool) {
+      g_thread_pool_free(worker_pool, false, true);
+      worker_pool = NULL;
+   }
+   g_mutex_unlock(&worker_pool_mutex);
+}
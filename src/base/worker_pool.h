@@ -0,0 +1,26 @@
+/** @file worker_pool.h
+ *
+ *  Bounded pool of worker threads shared by display detection,
+ *  EDID reads, and initial display checks
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef WORKER_POOL_H_
+#define WORKER_POOL_H_
+
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+
+/** Function executed on a worker thread for each item of a batch */
+typedef void (*Worker_Pool_Func)(gpointer item, gpointer arg);
+
+void  set_worker_pool_size(int size);
+int   get_worker_pool_size();
+bool  is_worker_pool_thread();
+void  run_in_worker_pool(GPtrArray * items, Worker_Pool_Func func, gpointer arg);
+void  init_worker_pool();
+void  terminate_worker_pool();
+
+#endif /* WORKER_POOL_H_ */
@@ -18,6 +18,7 @@
 #include "util/string_util.h"
 /** \endcond */
 
+#include "base/core.h"
 #include "base/parms.h"
 
 #include "cmdline/cmd_parser_aux.h"
@@ -37,7 +38,7 @@ static Cmd_Desc cmdinfo[] = {
    {CMDID_TESTCASE,     "testcase",       3,  1,       1},
    {CMDID_LISTTESTS,    "listtests",      5,  0,       0},
 #endif
-   {CMDID_LOADVCP,      "loadvcp",        3,  1,       1},
+   {CMDID_LOADVCP,      "loadvcp",        3,  1,       MAX_ARGS},
    {CMDID_DUMPVCP,      "dumpvcp",        3,  0,       1},
 #ifdef ENABLE_ENVCMDS
    {CMDID_INTERROGATE,  "interrogate",    3,  0,       0},
@@ -53,6 +54,7 @@ static Cmd_Desc cmdinfo[] = {
 #endif
    {CMDID_PROBE,        "probe",          5,  0,       0},
    {CMDID_SAVE_SETTINGS,"scs",            3,  0,       0},
+   {CMDID_DAEMON,       "daemon",         6,  0,       0},
 };
 static int cmdct = sizeof(cmdinfo)/sizeof(Cmd_Desc);
 
@@ -300,9 +302,9 @@ bool validate_output_level(Parsed_Cmd* parsed_cmd) {
          valid_output_levels = DDCA_OL_TERSE | DDCA_OL_NORMAL | DDCA_OL_VERBOSE | DDCA_OL_VV;
    }
    if (!(parsed_cmd->output_level & valid_output_levels)) {
-      printf("Output level invalid for command %s: %s\n",
-             get_command(parsed_cmd->cmd_id)->cmd_name,
-             output_level_name(parsed_cmd->output_level) );
+      f0printf(ferr(), "Output level invalid for command %s: %s\n",
+                       get_command(parsed_cmd->cmd_id)->cmd_name,
+                       output_level_name(parsed_cmd->output_level) );
       ok = false;
    }
    return ok;
@@ -319,8 +321,9 @@ char * commands_list_help =
        "   getvcp <feature-code-or-group>          Report VCP feature value(s)\n"
        "   setvcp <feature-code> [+|-] <new-value> Set VCP feature value\n"
        "   dumpvcp (filename)                      Write color profile related settings to file\n"
-       "   loadvcp <filename>                      Load profile related settings from file\n"
+       "   loadvcp <filename> ...                  Load profile related settings from file(s)\n"
        "   scs                                     Store current settings in monitor's nonvolatile storage\n"
+       "   daemon                                  Serve commands from other ddcutil invocations\n"
 #ifdef INCLUDE_TESTCASES
        "   testcase <testcase-number>\n"
        "   listtests\n"
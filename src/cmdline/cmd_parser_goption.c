@@ -152,6 +152,11 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
       }
    }
 
+   // may be called more than once, e.g. by the daemon command
+   output_level = DDCA_OL_NORMAL;
+   stats_work   = DDCA_STATS_NONE;
+   usbwork      = NULL;
+
    Parsed_Cmd * parsed_cmd = new_parsed_cmd();
    parsed_cmd->parser_mode = parser_mode;
    // parsed_cmd->pdid = create_dispno_display_identifier(1);   // default monitor
@@ -174,7 +179,9 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    gboolean verify_flag    = false;
    gboolean noverify_flag  = false;
    gboolean nodetect_flag  = false;
-   gboolean async_flag     = false;
+   gboolean async_flag     = (DISPLAY_CHECK_ASYNC_THRESHOLD_DEFAULT != DISPLAY_CHECK_ASYNC_NEVER);
+   const char * async_expl   = (async_flag) ? "Enable asynchronous display detection (default)" : "Enable asynchronous display detection";
+   const char * noasync_expl = (async_flag) ? "Disable asynchronous display detection" : "Disable asynchronous display detection (default)";
    gboolean report_freed_excp_flag = false;
    gboolean notable_flag   = true;
    gboolean rw_only_flag   = false;
@@ -202,11 +209,25 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    gboolean f6_flag        = false;
    gboolean debug_parse_flag  = false;
    gboolean x52_no_fifo_flag  = false;
+   gboolean nodaemon_flag     = false;
+   gboolean differential_flag = false;
 
    gboolean enable_cc_flag = DEFAULT_ENABLE_CACHED_CAPABILITIES;
    const char * enable_cc_expl =  (enable_cc_flag) ? "Enable cached capabilities (default)" : "Enable cached capabilities";
    const char * disable_cc_expl = (enable_cc_flag) ? "Disable cached capabilities" : "Disable cached capabilities (default)";
    // gboolean enable_cc_flag_set = false;
+   gboolean enable_dc_flag = DEFAULT_ENABLE_DETECTION_CACHE;
+   const char * enable_dc_expl =  (enable_dc_flag) ? "Enable cached display detection (default)" : "Enable cached display detection";
+   const char * disable_dc_expl = (enable_dc_flag) ? "Disable cached display detection" : "Disable cached display detection (default)";
+   gboolean enable_vc_flag = DEFAULT_ENABLE_VCP_VALUE_CACHE;
+   const char * enable_vc_expl =  (enable_vc_flag) ? "Enable VCP value cache (default)" : "Enable VCP value cache";
+   const char * disable_vc_expl = (enable_vc_flag) ? "Disable VCP value cache" : "Disable VCP value cache (default)";
+   gboolean enable_bl_flag = DEFAULT_ENABLE_I2C_BUS_LOCKS;
+   const char * enable_bl_expl =  (enable_bl_flag) ? "Serialize I2C bus use with other processes (default)" : "Serialize I2C bus use with other processes";
+   const char * disable_bl_expl = (enable_bl_flag) ? "Do not serialize I2C bus use with other processes" : "Do not serialize I2C bus use with other processes (default)";
+   gboolean enable_se_flag = DEFAULT_EDID_READ_USES_SYSFS;
+   const char * enable_se_expl =  (enable_se_flag) ? "Read EDID from DRM connector in sysfs if possible (default)" : "Read EDID from DRM connector in sysfs if possible";
+   const char * disable_se_expl = (enable_se_flag) ? "Always read EDID over I2C" : "Always read EDID over I2C (default)";
    // gboolean disable_cc_flag_set = false;
 
    // gboolean ignore_cc_flag = false;
@@ -222,9 +243,11 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    gchar**  trace_filenames = NULL;
    gint     buswork        = -1;
    gint     hidwork        = -1;
-   gint     dispwork       = -1;
+   char *   dispwork       = NULL;
    char *   maxtrywork      = NULL;
    gint     edid_read_size_work = -1;
+   gint     worker_thread_work = -1;
+   gint     vcp_value_ttl_work = -1;
    gint     i1_work = -1;
    char *   failsim_fn_work = NULL;
    // gboolean enable_failsim_flag = false;
@@ -238,8 +261,8 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
 
    GOptionEntry ddcutil_only_options[] = {
          //  Monitor selection options
-         {"display", 'd',  0, G_OPTION_ARG_INT,      &dispwork,         "Display number",              "number"},
-         {"dis",    '\0',  0, G_OPTION_ARG_INT,      &dispwork,         "Display number",              "number"},
+         {"display", 'd',  0, G_OPTION_ARG_STRING,   &dispwork,         "Display number, comma separated list, or \"all\"", "number"},
+         {"dis",    '\0',  0, G_OPTION_ARG_STRING,   &dispwork,         "Display number, comma separated list, or \"all\"", "number"},
          {"bus",     'b',  0, G_OPTION_ARG_INT,      &buswork,          "I2C bus number",              "busnum" },
          {"hiddev", '\0',  0, G_OPTION_ARG_INT,      &hidwork,          "hiddev device number",        "number" },
          {"usb",     'u',  0, G_OPTION_ARG_STRING,   &usbwork,          "USB bus and device numbers",  "busnum.devicenum"},
@@ -314,11 +337,25 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
       {"verify",  '\0', 0, G_OPTION_ARG_NONE,     &verify_flag,      "Read VCP value after setting it", NULL},
       {"noverify",'\0', 0, G_OPTION_ARG_NONE,     &noverify_flag,    "Do not read VCP value after setting it", NULL},
 //    {"nodetect",'\0', 0, G_OPTION_ARG_NONE,     &nodetect_flag,    "Skip initial monitor detection",  NULL},
-      {"async",   '\0', 0, G_OPTION_ARG_NONE,     &async_flag,       "Enable asynchronous display detection", NULL},
+      {"async",   '\0', 0, G_OPTION_ARG_NONE,     &async_flag,       async_expl,         NULL},
+      {"noasync", '\0', G_OPTION_FLAG_REVERSE,
+                           G_OPTION_ARG_NONE,     &async_flag,       noasync_expl,       NULL},
       {"enable-capabilities-cache",
                   '\0', 0, G_OPTION_ARG_NONE,     &enable_cc_flag,   enable_cc_expl,     NULL},
       {"disable-capabilities-cache", '\0', G_OPTION_FLAG_REVERSE,
                            G_OPTION_ARG_NONE,     &enable_cc_flag,   disable_cc_expl ,   NULL},
+      {"enable-detection-cache",
+                  '\0', 0, G_OPTION_ARG_NONE,     &enable_dc_flag,   enable_dc_expl,     NULL},
+      {"disable-detection-cache", '\0', G_OPTION_FLAG_REVERSE,
+                           G_OPTION_ARG_NONE,     &enable_dc_flag,   disable_dc_expl ,   NULL},
+      {"enable-vcp-value-cache",
+                  '\0', 0, G_OPTION_ARG_NONE,     &enable_vc_flag,   enable_vc_expl,     NULL},
+      {"disable-vcp-value-cache", '\0', G_OPTION_FLAG_REVERSE,
+                           G_OPTION_ARG_NONE,     &enable_vc_flag,   disable_vc_expl ,   NULL},
+      {"enable-bus-locks",
+                  '\0', 0, G_OPTION_ARG_NONE,     &enable_bl_flag,   enable_bl_expl,     NULL},
+      {"disable-bus-locks", '\0', G_OPTION_FLAG_REVERSE,
+                           G_OPTION_ARG_NONE,     &enable_bl_flag,   disable_bl_expl ,   NULL},
 
       {"udf",     '\0', 0, G_OPTION_ARG_NONE,     &enable_udf_flag,  enable_udf_expl,    NULL},
       {"enable-udf",'\0',0,G_OPTION_ARG_NONE,     &enable_udf_flag,  enable_udf_expl,    NULL},
@@ -327,6 +364,9 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
       {"disable-udf",'\0', G_OPTION_FLAG_REVERSE,
                            G_OPTION_ARG_NONE,     &enable_udf_flag,  disable_udf_expl,   NULL},
       {"x52-no-fifo",'\0',0,G_OPTION_ARG_NONE,    &x52_no_fifo_flag, "Feature x52 does have a FIFO queue", NULL},
+      {"nodaemon",'\0', 0, G_OPTION_ARG_NONE,     &nodaemon_flag,    "Execute in process even if a ddcutil daemon is running", NULL},
+      {"differential",
+                  '\0', 0, G_OPTION_ARG_NONE,     &differential_flag, "loadvcp writes only values that differ from the current values", NULL},
 
       // Performance and retry
       {"maxtries",'\0', 0, G_OPTION_ARG_STRING,   &maxtrywork,       "Max try adjustment",  "comma separated list" },
@@ -349,6 +389,14 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
       {"dsa",                     '\0', 0, G_OPTION_ARG_NONE, &dsa_flag, "Enable dynamic sleep adjustment",  NULL},
       {"edid-read-size",
                       '\0', 0, G_OPTION_ARG_INT,         &edid_read_size_work, "Number of EDID bytes to read", "128,256" },
+      {"enable-sysfs-edid",
+                      '\0', 0, G_OPTION_ARG_NONE,        &enable_se_flag,   enable_se_expl,     NULL},
+      {"disable-sysfs-edid", '\0', G_OPTION_FLAG_REVERSE,
+                              G_OPTION_ARG_NONE,        &enable_se_flag,   disable_se_expl,    NULL},
+      {"worker-threads",
+                      '\0', 0, G_OPTION_ARG_INT,         &worker_thread_work, "Maximum threads for bus probing and display checks, 0 = number of processors", "number" },
+      {"vcp-value-ttl",
+                      '\0', 0, G_OPTION_ARG_INT,         &vcp_value_ttl_work, "Milliseconds for which time limited cached VCP values remain valid", "millisec" },
       {NULL},
    };
 
@@ -483,9 +531,9 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    if (!ok) {
       char * mode_name = (parser_mode == MODE_DDCUTIL) ? "ddcutil" : "libddcutil";
       if (error)
-         fprintf(stderr, "%s option parsing failed: %s\n", mode_name, error->message);
+         f0printf(ferr(), "%s option parsing failed: %s\n", mode_name, error->message);
       else
-         fprintf(stderr, "%s option parsing failed\n", mode_name);
+         f0printf(ferr(), "%s option parsing failed\n", mode_name);
    }
    ntsa_free(temp_argv, true);
 
@@ -502,7 +550,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    if (ro_only_flag)   rwo_flag_ct++;
    if (wo_only_flag)   rwo_flag_ct++;
    if (rwo_flag_ct > 1) {
-      fprintf(stderr, "Options -rw-only, --ro-only, --wo-only are mutually exclusive\n");
+      f0printf(ferr(), "Options -rw-only, --ro-only, --wo-only are mutually exclusive\n");
       ok = false;
    }
 
@@ -558,8 +606,14 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    SET_CMDFLAG(CMD_FLAG_X52_NO_FIFO,       x52_no_fifo_flag);
    SET_CMDFLAG(CMD_FLAG_PER_THREAD_STATS,  per_thread_stats_flag);
    SET_CMDFLAG(CMD_FLAG_SHOW_SETTINGS,     show_settings_flag);
+   SET_CMDFLAG(CMD_FLAG_NODAEMON,          nodaemon_flag);
+   SET_CMDFLAG(CMD_FLAG_DIFFERENTIAL,      differential_flag);
 
    SET_CLR_CMDFLAG(CMD_FLAG_ENABLE_CACHED_CAPABILITIES, enable_cc_flag);
+   SET_CLR_CMDFLAG(CMD_FLAG_ENABLE_DETECTION_CACHE,     enable_dc_flag);
+   SET_CLR_CMDFLAG(CMD_FLAG_ENABLE_VCP_VALUE_CACHE,     enable_vc_flag);
+   SET_CLR_CMDFLAG(CMD_FLAG_ENABLE_BUS_LOCKS,           enable_bl_flag);
+   SET_CLR_CMDFLAG(CMD_FLAG_EDID_READ_USES_SYSFS,       enable_se_flag);
 
    if (failsim_fn_work) {
 #ifdef ENABLE_FAILSIM
@@ -567,7 +621,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
       parsed_cmd->flags |= CMD_FLAG_ENABLE_FAILSIM;
       parsed_cmd->failsim_control_fn = failsim_fn_work;
 #else
-      fprintf(stderr, "ddcutil not built with failure simulation support.  --failsim option invalid.\n");
+      f0printf(ferr(), "ddcutil not built with failure simulation support.  --failsim option invalid.\n");
       ok = false;
 #endif
    }
@@ -591,7 +645,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
       if (!arg_ok)
          arg_ok = parse_colon_separated_arg(usbwork, &busnum, &devicenum);
       if (!arg_ok) {
-          fprintf(stderr, "Invalid USB argument: %s\n", usbwork );
+          f0printf(ferr(), "Invalid USB argument: %s\n", usbwork );
           ok = false;
           // DBGMSG("After USB parse, ok=%d", ok);
       }
@@ -604,7 +658,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
       }
       explicit_display_spec_ct++;
 #else
-      fprintf(stderr, "ddcutil not built with support for USB connected monitors.  --usb option invalid.\n");
+      f0printf(ferr(), "ddcutil not built with support for USB connected monitors.  --usb option invalid.\n");
       ok = false;
 #endif
    }
@@ -625,24 +679,52 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
       explicit_display_spec_ct++;
    }
 
-   if (dispwork >= 0) {
-      // avoid memory leak in case parsed_cmd->pdid set in more than 1 way
-      if (parsed_cmd->pdid)
-         free_display_identifier(parsed_cmd->pdid);
-      parsed_cmd->pdid = create_dispno_display_identifier(dispwork);
-      explicit_display_spec_ct++;
+   if (dispwork) {
+      if (g_ascii_strcasecmp(dispwork, "all") == 0) {
+         // other display selection options, if any, restrict the displays
+         parsed_cmd->flags |= CMD_FLAG_ALL_DISPLAYS;
+      }
+      else {
+         GArray * dispnos = g_array_new(false, false, sizeof(int));
+         Null_Terminated_String_Array pieces = strsplit(dispwork, ",");
+         for (int ndx = 0; pieces[ndx]; ndx++) {
+            int dispno;
+            if (!str_to_int(pieces[ndx], &dispno, 10) || dispno < 1) {
+               f0printf(ferr(), "Invalid display number: %s\n", pieces[ndx]);
+               ok = false;
+            }
+            else
+               g_array_append_val(dispnos, dispno);
+         }
+         ntsa_free(pieces, true);
+
+         if (ok && dispnos->len > 0) {
+            // avoid memory leak in case parsed_cmd->pdid set in more than 1 way
+            if (parsed_cmd->pdid)
+               free_display_identifier(parsed_cmd->pdid);
+            parsed_cmd->pdid = create_dispno_display_identifier(g_array_index(dispnos, int, 0));
+            if (dispnos->len > 1) {
+               parsed_cmd->dispnos = dispnos;
+               dispnos = NULL;
+            }
+         }
+         if (dispnos)
+            g_array_free(dispnos, true);
+         explicit_display_spec_ct++;
+      }
+      free(dispwork);
    }
 
    if (edidwork) {
       if (strlen(edidwork) != 256) {
-         fprintf(stderr, "EDID hex string not 256 characters\n");
+         f0printf(ferr(), "EDID hex string not 256 characters\n");
          ok = false;
       }
       else {
          Byte * pba = NULL;
          int bytect = hhs_to_byte_array(edidwork, &pba);
          if (bytect < 0 || bytect != 128) {
-            fprintf(stderr, "Invalid EDID hex string\n");
+            f0printf(ferr(), "Invalid EDID hex string\n");
             ok = false;
          }
          else {
@@ -677,7 +759,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
        int ntsal = ntsa_length(pieces);
        DBGMSF(debug, "ntsal=%d", ntsal );
        if (ntsa_length(pieces) != 3) {
-          fprintf(stderr, "--retries requires 3 values\n");
+          f0printf(ferr(), "--retries requires 3 values\n");
           ok = false;
        }
        else {
@@ -690,15 +772,15 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
                 int ival;
                 int ct = sscanf(token, "%ud", &ival);
                 if (ct != 1) {
-                   fprintf(stderr, "Invalid --maxtries value: %s\n", token);
+                   f0printf(ferr(), "Invalid --maxtries value: %s\n", token);
                    ok = false;
                 }
                 else if (ival > MAX_MAX_TRIES) {
-                   fprintf(stderr, "--maxtries value %d exceeds %d\n", ival, MAX_MAX_TRIES);
+                   f0printf(ferr(), "--maxtries value %d exceeds %d\n", ival, MAX_MAX_TRIES);
                    ok = false;
                 }
                 else if (ival < 0) {
-                   fprintf(stderr, "negative --maxtries value: %d\n", ival);
+                   f0printf(ferr(), "negative --maxtries value: %d\n", ival);
                    ok = false;
                 }
 
@@ -728,7 +810,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
          arg_ok = vcp_version_is_valid(vspec, false);
       }
       if (!arg_ok) {
-          fprintf(stderr, "Invalid MCCS spec: %s\n", mccswork );
+          f0printf(ferr(), "Invalid MCCS spec: %s\n", mccswork );
           ok = false;
       }
       else {
@@ -747,7 +829,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
       }
 
       if (!arg_ok) {
-          fprintf(stderr, "Invalid sleep-multiplier: %s\n", sleep_multiplier_work );
+          f0printf(ferr(), "Invalid sleep-multiplier: %s\n", sleep_multiplier_work );
           ok = false;
       }
       else {
@@ -761,12 +843,27 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
        edid_read_size_work !=   0 &&
        edid_read_size_work != 256)
    {
-      fprintf(stderr, "Invalid EDID read size: %d\n", edid_read_size_work);
+      f0printf(ferr(), "Invalid EDID read size: %d\n", edid_read_size_work);
       ok = false;
    }
    else
       parsed_cmd->edid_read_size = edid_read_size_work;
 
+   DBGMSF(debug, "worker_thread_work = %d", worker_thread_work);
+   if (worker_thread_work < -1 || worker_thread_work > WORKER_POOL_MAX_SIZE) {
+      f0printf(ferr(), "Invalid worker thread count: %d\n", worker_thread_work);
+      ok = false;
+   }
+   else
+      parsed_cmd->worker_thread_ct = worker_thread_work;
+
+   if (vcp_value_ttl_work < -1) {
+      f0printf(ferr(), "Invalid VCP value TTL: %d\n", vcp_value_ttl_work);
+      ok = false;
+   }
+   else
+      parsed_cmd->vcp_value_ttl_millis = vcp_value_ttl_work;
+
 #ifdef COMMA_DELIMITED_TRACE
    if (tracework) {
        bool saved_debug = debug;
@@ -792,7 +889,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
                 traceClasses |= tg;
              }
              else {
-                fprintf(stderr, "Invalid trace group: %s\n", token);
+                f0printf(ferr(), "Invalid trace group: %s\n", token);
                 ok = false;
              }
           }
@@ -827,7 +924,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
                traceClasses |= tg;
             }
             else {
-               fprintf(stderr, "Invalid trace group: %s\n", token);
+               f0printf(ferr(), "Invalid trace group: %s\n", token);
                ok = false;
             }
         }
@@ -885,7 +982,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
 
    // All options processed.  Check for consistency, set defaults
    if (explicit_display_spec_ct > 1) {
-      fprintf(stderr, "Monitor specified in more than one way\n");
+      f0printf(ferr(), "Monitor specified in more than one way\n");
       free_display_identifier(parsed_cmd->pdid);
       parsed_cmd->pdid = NULL;
       ok = false;
@@ -894,11 +991,11 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
    //   parsed_cmd->pdid = create_dispno_display_identifier(1);   // default monitor
 
    if (parser_mode == MODE_LIBDDCUTIL && rest_ct > 0) {
-         fprintf(stderr, "Unrecognized configuration file options: %s\n", cmd_and_args[0]);
+         f0printf(ferr(), "Unrecognized configuration file options: %s\n", cmd_and_args[0]);
          ok = false;
    }
    else if (ok && parser_mode == MODE_DDCUTIL && rest_ct == 0) {
-      fprintf(stderr, "No command specified\n");
+      f0printf(ferr(), "No command specified\n");
       ok = false;
    }
    if (ok && parser_mode == MODE_DDCUTIL) {
@@ -907,7 +1004,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
          printf("cmd=|%s|\n", cmd);
       Cmd_Desc * cmdInfo = find_command(cmd);
       if (cmdInfo == NULL) {
-         fprintf(stderr, "Unrecognized command: %s\n", cmd);
+         f0printf(ferr(), "Unrecognized command: %s\n", cmd);
          ok = false;
       }
       else {
@@ -921,7 +1018,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
          int argctr = 1;
          while ( cmd_and_args[argctr] != NULL) {
             if (argctr > max_arg_ct) {
-               fprintf(stderr, "Too many arguments\n");
+               f0printf(ferr(), "Too many arguments\n");
                ok = false;
                break;
             }
@@ -934,7 +1031,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
 
          // no more arguments specified
          if (argctr <= min_arg_ct) {
-            fprintf(stderr, "Missing argument(s)\n");
+            f0printf(ferr(), "Missing argument(s)\n");
             ok = false;
          }
 
@@ -950,7 +1047,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
             if (ok)
                parsed_cmd->fref = fsref;
             else
-               fprintf(stderr, "Invalid feature code or subset: %s\n", parsed_cmd->args[0]);
+               f0printf(ferr(), "Invalid feature code or subset: %s\n", parsed_cmd->args[0]);
          }
 
          // Ignore --notable for vcpinfo
@@ -959,7 +1056,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
          }
 
          if (ok && parsed_cmd->cmd_id == CMDID_GETVCP && (parsed_cmd->flags & CMD_FLAG_WO_ONLY) ) {
-            fprintf(stdout, "Ignoring option --wo-only\n");
+            f0printf(fout(), "Ignoring option --wo-only\n");
             parsed_cmd->flags &= ~CMD_FLAG_WO_ONLY;
          }
 
@@ -973,14 +1070,14 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
                              parsed_cmd->args[argpos],
                              &psv.feature_code);
                if (!feature_code_ok) {
-                  fprintf(stderr, "Invalid feature code: %s\n", parsed_cmd->args[argpos]);
+                  f0printf(ferr(), "Invalid feature code: %s\n", parsed_cmd->args[argpos]);
                   ok = false;
                   break;
                }
 
                argpos++;
                if (argpos >= parsed_cmd->argct) {
-                  fprintf(stderr, "Missing feature value\n");
+                  f0printf(ferr(), "Missing feature value\n");
                   ok = false;
                   break;
                }
@@ -993,7 +1090,7 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
                      psv.feature_value_type = VALUE_TYPE_RELATIVE_MINUS;
                   argpos++;
                   if (argpos >= parsed_cmd->argct) {
-                     fprintf(stderr, "Missing feature value\n");
+                     f0printf(ferr(), "Missing feature value\n");
                      ok = false;
                      break;
                   }
@@ -1010,14 +1107,14 @@ Parsed_Cmd * parse_command(int argc, char * argv[], Parser_Mode parser_mode) {
             for (int argpos = 0; argpos < parsed_cmd->argct; argpos+=2) {
                // DBGMSG("argpos=%d, argct=%d", argpos, parsed_cmd->argct);
                if ( (argpos+1) == parsed_cmd->argct) {
-                  fprintf(stderr, "Missing feature value\n");
+                  f0printf(ferr(), "Missing feature value\n");
                   ok = false;
                   break;
                }
                char * a1 = parsed_cmd->args[argpos+1];
                if ( streq(a1,"+") || streq(a1,"-") ) {
                   if ( (argpos+2) == parsed_cmd->argct) {
-                       fprintf(stderr, "Missing relative feature value\n");
+                       f0printf(ferr(), "Missing relative feature value\n");
                        ok = false;
                        break;
                   }
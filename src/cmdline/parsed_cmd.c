@@ -58,6 +58,7 @@ Value_Name_Table cmd_id_table = {
       VNT(CMDID_CHKUSBMON     ,  "chkusbmon"),
       VNT(CMDID_PROBE         ,  "probe"),
       VNT(CMDID_SAVE_SETTINGS ,  "save settings"),
+      VNT(CMDID_DAEMON        ,  "daemon"),
       VNT_END
 };
 
@@ -114,6 +115,8 @@ Parsed_Cmd *  new_parsed_cmd() {
    // parsed_cmd->output_level = OL_DEFAULT;
    parsed_cmd->output_level = DDCA_OL_NORMAL;
    parsed_cmd->edid_read_size = -1;   // if set, values are >= 0
+   parsed_cmd->worker_thread_ct = -1; // if set, values are >= 0
+   parsed_cmd->vcp_value_ttl_millis = -1; // if set, values are >= 0
    parsed_cmd->i1 = -1;               // if set, values are >= 0
    // parsed_cmd->nodetect = true;
    parsed_cmd->flags |= CMD_FLAG_NODETECT;
@@ -127,6 +130,14 @@ Parsed_Cmd *  new_parsed_cmd() {
       parsed_cmd->flags |= CMD_FLAG_ENABLE_USB;
    if (DEFAULT_ENABLE_CACHED_CAPABILITIES)
       parsed_cmd->flags |= CMD_FLAG_ENABLE_CACHED_CAPABILITIES;
+   if (DEFAULT_ENABLE_DETECTION_CACHE)
+      parsed_cmd->flags |= CMD_FLAG_ENABLE_DETECTION_CACHE;
+   if (DEFAULT_ENABLE_VCP_VALUE_CACHE)
+      parsed_cmd->flags |= CMD_FLAG_ENABLE_VCP_VALUE_CACHE;
+   if (DEFAULT_ENABLE_I2C_BUS_LOCKS)
+      parsed_cmd->flags |= CMD_FLAG_ENABLE_BUS_LOCKS;
+   if (DEFAULT_EDID_READ_USES_SYSFS)
+      parsed_cmd->flags |= CMD_FLAG_EDID_READ_USES_SYSFS;
    return parsed_cmd;
 }
 
@@ -143,6 +154,8 @@ void free_parsed_cmd(Parsed_Cmd * parsed_cmd) {
       free(parsed_cmd->args[ndx]);
    if (parsed_cmd->pdid)
       free_display_identifier(parsed_cmd->pdid);
+   if (parsed_cmd->dispnos)
+      g_array_free(parsed_cmd->dispnos, true);
    free(parsed_cmd->raw_command);
    free(parsed_cmd->failsim_control_fn);
    free(parsed_cmd->fref);
@@ -176,6 +189,10 @@ void dbgrpt_parsed_cmd(Parsed_Cmd * parsed_cmd, int depth) {
       rpt_str("parser mode",       NULL, parser_mode_name(parsed_cmd->parser_mode), d1);
       if (parsed_cmd->pdid)
           dbgrpt_display_identifier(parsed_cmd->pdid,                    d2);
+      if (parsed_cmd->dispnos) {
+         for (int ndx = 0; ndx < parsed_cmd->dispnos->len; ndx++)
+            rpt_int("dispno", NULL, g_array_index(parsed_cmd->dispnos, int, ndx), d2);
+      }
 
       rpt_structure_loc("fref", parsed_cmd->fref,                        d1);
       if (parsed_cmd->fref)
@@ -235,6 +252,16 @@ void dbgrpt_parsed_cmd(Parsed_Cmd * parsed_cmd, int depth) {
       rpt_bool("show settings:",    NULL, parsed_cmd->flags & CMD_FLAG_SHOW_SETTINGS,            d1);
       rpt_bool("enable cached capabilities:",
                                     NULL, parsed_cmd->flags & CMD_FLAG_ENABLE_CACHED_CAPABILITIES, d1);
+      rpt_bool("enable detection cache:",
+                                    NULL, parsed_cmd->flags & CMD_FLAG_ENABLE_DETECTION_CACHE,   d1);
+      rpt_bool("enable VCP value cache:",
+                                    NULL, parsed_cmd->flags & CMD_FLAG_ENABLE_VCP_VALUE_CACHE,   d1);
+      rpt_bool("enable bus locks:", NULL, parsed_cmd->flags & CMD_FLAG_ENABLE_BUS_LOCKS,         d1);
+      rpt_bool("read EDID from sysfs:",
+                                    NULL, parsed_cmd->flags & CMD_FLAG_EDID_READ_USES_SYSFS,     d1);
+      rpt_bool("nodaemon:",         NULL, parsed_cmd->flags & CMD_FLAG_NODAEMON,                 d1);
+      rpt_bool("all displays:",     NULL, parsed_cmd->flags & CMD_FLAG_ALL_DISPLAYS,             d1);
+      rpt_bool("differential:",     NULL, parsed_cmd->flags & CMD_FLAG_DIFFERENTIAL,             d1);
    // rpt_bool("clear persistent cache:",
    //                               NULL, parsed_cmd->flags & CMD_FLAG_CLEAR_PERSISTENT_CACHE,   d1);
       rpt_str ("MCCS version spec", NULL, format_vspec(parsed_cmd->mccs_vspec),                  d1);
@@ -262,6 +289,8 @@ void dbgrpt_parsed_cmd(Parsed_Cmd * parsed_cmd, int depth) {
                          elem->feature_value);
       }
       rpt_int( "edid_read_size:",   NULL, parsed_cmd->edid_read_size,                d1);
+      rpt_int( "worker_thread_ct:", NULL, parsed_cmd->worker_thread_ct,              d1);
+      rpt_int( "vcp_value_ttl_millis:", NULL, parsed_cmd->vcp_value_ttl_millis,      d1);
       rpt_str ("library trace file:", NULL, parsed_cmd->library_trace_file,          d1);
       rpt_bool("write to syslog:",  NULL, parsed_cmd->flags & CMD_FLAG_SYSLOG,       d1);
       rpt_int( "i1",                NULL, parsed_cmd->i1,                            d1);
@@ -42,6 +42,7 @@ typedef enum {
    CMDID_CHKUSBMON     =   0x4000,
    CMDID_PROBE         =   0x8000,
    CMDID_SAVE_SETTINGS = 0x010000,
+   CMDID_DAEMON        = 0x020000,
 } Cmd_Id_Type;
 
 typedef enum {
@@ -81,6 +82,17 @@ typedef enum {
 //                           = 0x1000000000,
    CMD_FLAG_WALLTIME_TRACE   = 0x2000000000,
    CMD_FLAG_SYSLOG           = 0x4000000000,
+   CMD_FLAG_ENABLE_DETECTION_CACHE
+                             = 0x8000000000,
+   CMD_FLAG_ENABLE_VCP_VALUE_CACHE
+                           = 0x010000000000,
+   CMD_FLAG_NODAEMON       = 0x020000000000,
+   CMD_FLAG_ALL_DISPLAYS   = 0x040000000000,
+   CMD_FLAG_DIFFERENTIAL   = 0x080000000000,
+   CMD_FLAG_ENABLE_BUS_LOCKS
+                           = 0x100000000000,
+   CMD_FLAG_EDID_READ_USES_SYSFS
+                           = 0x200000000000,
 } Parsed_Cmd_Flags;
 
 typedef
@@ -111,6 +123,7 @@ struct {
    DDCA_Stats_Type        stats_types;
    char *                 failsim_control_fn;
    Display_Identifier*    pdid;
+   GArray *               dispnos;    // if --display specifies more than one display number
    DDCA_Trace_Group       traced_groups;
    gchar **               traced_files;
    gchar **               traced_functions;
@@ -120,6 +133,8 @@ struct {
    DDCA_MCCS_Version_Spec mccs_vspec;
 // DDCA_MCCS_Version_Id   mccs_version_id;
    int                    edid_read_size;
+   int                    worker_thread_ct;
+   int                    vcp_value_ttl_millis;
    uint64_t               flags;      // Parsed_Cmd_Flags
    char *                 library_trace_file;
    int                    i1;         // for temporary use
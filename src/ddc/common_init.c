@@ -15,21 +15,26 @@
 
 #include "base/core.h"
 #include "base/parms.h"
+#include "base/persistent_sleep_data.h"
 #include "base/thread_retry_data.h"
 #include "base/thread_sleep_data.h"
 #include "base/tuned_sleep.h"
+#include "base/worker_pool.h"
 
 #include "vcp/persistent_capabilities.h"
 
 #include "dynvcp/dyn_feature_files.h"
 
+#include "i2c/i2c_bus_lock.h"
 #include "i2c/i2c_execute.h"
 #include "i2c/i2c_strategy_dispatcher.h"
 
+#include "ddc/ddc_detection_cache.h"
 #include "ddc/ddc_displays.h"
 #include "ddc/ddc_services.h"
 #include "ddc/ddc_try_stats.h"
 #include "ddc/ddc_vcp.h"
+#include "ddc/ddc_vcp_value_cache.h"
 
 #include "ddc/common_init.h"
 
@@ -138,11 +143,12 @@ void init_performance_options(Parsed_Cmd * parsed_cmd)
    enable_sleep_suppression( parsed_cmd->flags & CMD_FLAG_REDUCE_SLEEPS );
    enable_deferred_sleep( parsed_cmd->flags & CMD_FLAG_DEFER_SLEEPS);
 
-   int threshold = DISPLAY_CHECK_ASYNC_NEVER;
-   if (parsed_cmd->flags & CMD_FLAG_ASYNC) {
-      threshold = DISPLAY_CHECK_ASYNC_THRESHOLD_STANDARD;
-      ddc_set_async_threshold(threshold);
-   }
+   int threshold = (parsed_cmd->flags & CMD_FLAG_ASYNC)
+                          ? DISPLAY_CHECK_ASYNC_THRESHOLD_STANDARD
+                          : DISPLAY_CHECK_ASYNC_NEVER;
+   ddc_set_async_threshold(threshold);
+   if (parsed_cmd->worker_thread_ct >= 0)
+      set_worker_pool_size(parsed_cmd->worker_thread_ct);
 
    if (parsed_cmd->sleep_multiplier != 0 && parsed_cmd->sleep_multiplier != 1) {
       tsd_set_sleep_multiplier_factor(parsed_cmd->sleep_multiplier);         // for current thread
@@ -152,6 +158,8 @@ void init_performance_options(Parsed_Cmd * parsed_cmd)
          tsd_dsa_enable_globally(true);
       }
    }
+   // learned adjustments are loaded and saved iff dynamic sleep adjustment requested
+   enable_persistent_sleep_data(parsed_cmd->flags & CMD_FLAG_DSA);
 
    // experimental timeout of i2c read()
    if (parsed_cmd->flags & CMD_FLAG_TIMEOUT_I2C_IO) {
@@ -175,6 +183,7 @@ submaster_initializer(Parsed_Cmd * parsed_cmd) {
 
    if (parsed_cmd->edid_read_size >= 0)
       EDID_Read_Size = parsed_cmd->edid_read_size;
+   EDID_Read_Uses_Sysfs = parsed_cmd->flags & CMD_FLAG_EDID_READ_USES_SYSFS;
 
     init_ddc_services();   // n. initializes start timestamp
     // overrides setting in init_ddc_services():
@@ -200,6 +209,11 @@ submaster_initializer(Parsed_Cmd * parsed_cmd) {
 
    init_performance_options(parsed_cmd);
    enable_capabilities_cache(parsed_cmd->flags & CMD_FLAG_ENABLE_CACHED_CAPABILITIES);
+   enable_detection_cache(parsed_cmd->flags & CMD_FLAG_ENABLE_DETECTION_CACHE);
+   enable_vcp_value_cache(parsed_cmd->flags & CMD_FLAG_ENABLE_VCP_VALUE_CACHE);
+   enable_i2c_bus_locks(parsed_cmd->flags & CMD_FLAG_ENABLE_BUS_LOCKS);
+   if (parsed_cmd->vcp_value_ttl_millis >= 0)
+      set_vcp_value_cache_ttl(parsed_cmd->vcp_value_ttl_millis);
 
    ok = true;
 
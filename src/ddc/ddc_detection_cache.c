@@ -0,0 +1,415 @@
+/** \file ddc_detection_cache.c
+ *
+ *  Saves the results of initial display checks, so that later executions
+ *  need not repeat the DDC communication done during display detection.
+ *
+ *  Entries are keyed by I2C bus number, DRM connector name, and EDID.
+ *  An entry is used only if the connector status and the bus probe flags
+ *  are unchanged.  Only displays for which DDC communication succeeded are
+ *  saved, so a display that failed its checks is always rechecked.
+ *
+ *  Data is stored in file $HOME/.cache/ddcutil/displays, one line per
+ *  display, of the form:
+ *     i2c-<busno> <connector> <edid hex>:<dref flags> <vcp major> <vcp minor> <bus flags> <connector status>
+ *
+ *  As with the capabilities cache, the file is read holding a shared lock
+ *  and rewritten atomically holding an exclusive lock on file
+ *  $HOME/.cache/ddcutil/displays.lock, so that concurrent ddcutil processes
+ *  never see a partially written file.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <assert.h>
+#include <errno.h>
+#include <glib-2.0/glib.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "public/ddcutil_types.h"
+#include "public/ddcutil_status_codes.h"
+
+#include "util/edid.h"
+#include "util/error_info.h"
+#include "util/file_util.h"
+#include "util/report_util.h"
+#include "util/string_util.h"
+#include "util/xdg_util.h"
+
+#include "base/core.h"
+#include "base/displays.h"
+#include "base/rtti.h"
+
+#include "i2c/i2c_bus_core.h"
+#include "i2c/i2c_sysfs.h"
+
+#include "ddc/ddc_detection_cache.h"
+
+static DDCA_Trace_Group TRACE_GROUP  = DDCA_TRC_DDC;
+
+/** Dref_Flags values determined by initial checks */
+#define CACHED_DREF_FLAGS (DREF_DDC_COMMUNICATION_CHECKED                 | \
+                           DREF_DDC_COMMUNICATION_WORKING                 | \
+                           DREF_DDC_NULL_RESPONSE_CHECKED                 | \
+                           DREF_DDC_USES_NULL_RESPONSE_FOR_UNSUPPORTED    | \
+                           DREF_DDC_USES_MH_ML_SH_SL_ZERO_FOR_UNSUPPORTED | \
+                           DREF_DDC_USES_DDC_FLAG_FOR_UNSUPPORTED         | \
+                           DREF_DDC_DOES_NOT_INDICATE_UNSUPPORTED)
+
+/** I2C_Bus_Info flags that must be unchanged for an entry to be used */
+#define CHECKED_BUS_FLAGS (I2C_BUS_ACCESSIBLE | I2C_BUS_ADDR_0X50 | I2C_BUS_ADDR_0X37 | \
+                           I2C_BUS_EDP        | I2C_BUS_LVDS)
+
+/** Initial check results saved for a display */
+typedef struct {
+   Dref_Flags             dref_flags;
+   DDCA_MCCS_Version_Spec vcp_version;
+   uint16_t               bus_flags;
+   char                   connector_status[20];
+} Cached_Detection;
+
+static bool          detection_cache_enabled = false;
+static GHashTable *  detection_hash = NULL;     // key string -> Cached_Detection *
+static bool          detection_hash_changed = false;
+static GMutex        detection_cache_mutex;
+
+
+static void dbgrpt_detection_hash0(int depth, const char * msg) {
+   int d = depth;
+   if (msg) {
+      rpt_label(depth, msg);
+      d = depth+1;
+   }
+   if (!detection_hash)
+      rpt_label(d, "No detection hash table");
+   else if (g_hash_table_size(detection_hash) == 0)
+      rpt_label(d, "Empty detection hash table");
+   else {
+      GHashTableIter iter;
+      gpointer key, value;
+      g_hash_table_iter_init(&iter, detection_hash);
+      while (g_hash_table_iter_next(&iter, &key, &value)) {
+         Cached_Detection * data = value;
+         rpt_vstring(d, "%.40s... : dref_flags=0x%04x, vcp version=%d.%d, bus_flags=0x%04x, status=%s",
+                        (char *) key, data->dref_flags,
+                        data->vcp_version.major, data->vcp_version.minor,
+                        data->bus_flags, data->connector_status);
+      }
+   }
+}
+
+
+static char * get_detection_cache_lock_file_name() {
+   return xdg_cache_home_file("ddcutil", "displays.lock");
+}
+
+
+static void delete_detection_cache_file() {
+   bool debug = false;
+   char * fn = get_detection_cache_file_name();
+   if (regular_file_exists(fn)) {
+      char * lockfn = get_detection_cache_lock_file_name();
+      int lockfd = file_lock(lockfn, true, ferr());
+      free(lockfn);
+      DBGMSF(debug, "Deleting file: %s", fn);
+      if (unlink(fn) < 0)
+         fprintf(ferr(), "Unexpected error deleting file %s: %s\n", fn, strerror(errno));
+      file_unlock(lockfd);
+   }
+   free(fn);
+}
+
+
+static Error_Info * load_detection_cache_file() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "");
+
+   Error_Info * errs = NULL;
+   if (detection_hash)
+      g_hash_table_destroy(detection_hash);
+   detection_hash = g_hash_table_new_full(g_str_hash, g_str_equal, free, free);
+   detection_hash_changed = false;
+
+   char * data_file_name = get_detection_cache_file_name();
+   DBGTRC_NOPREFIX(debug, TRACE_GROUP, "data_file_name: %s", data_file_name);
+   GPtrArray * linearray = g_ptr_array_new_with_free_func(g_free);
+   char * lockfn = get_detection_cache_lock_file_name();
+   int lockfd = file_lock(lockfn, false, ferr());
+   free(lockfn);
+   errs = file_getlines_errinfo(data_file_name, linearray);
+   file_unlock(lockfd);
+   free(data_file_name);
+   if (!errs) {
+      for (int ndx = 0; ndx < linearray->len; ndx++) {
+         char * aline = strtrim(g_ptr_array_index(linearray, ndx));
+         if (strlen(aline) > 0 && aline[0] != '*' && aline[0] != '#') {
+            Cached_Detection data = {0};
+            unsigned int dref_flags, bus_flags, major, minor;
+            char * colon = strchr(aline, ':');
+            if (!colon ||
+                sscanf(colon+1, "%x %u %u %x %19s", &dref_flags, &major, &minor,
+                                                    &bus_flags, data.connector_status) != 5)
+            {
+               if (!errs)
+                  errs = errinfo_new(DDCRC_BAD_DATA, __func__);
+               errinfo_add_cause(errs, errinfo_new2(DDCRC_BAD_DATA, __func__,
+                                                    "Line %d, invalid data: %s",
+                                                     ndx+1, aline));
+            }
+            else {
+               *colon = '\0';
+               data.dref_flags = dref_flags & CACHED_DREF_FLAGS;
+               data.vcp_version.major = major;
+               data.vcp_version.minor = minor;
+               data.bus_flags = bus_flags;
+               Cached_Detection * newdata = calloc(1, sizeof(Cached_Detection));
+               *newdata = data;
+               g_hash_table_insert(detection_hash, strdup(aline), newdata);
+            }
+         }
+         free(aline);
+      }
+   }
+   g_ptr_array_free(linearray, true);
+
+   if (debug || IS_TRACING())
+      dbgrpt_detection_hash0(2, "detection_hash:");
+   DBGTRC_RET_ERRINFO(debug, TRACE_GROUP, errs, "");
+   return errs;
+}
+
+
+static bool write_detection_lines(FILE * fp, void * data) {
+   bool ok = true;
+   GHashTableIter iter;
+   gpointer key, value;
+   g_hash_table_iter_init(&iter, detection_hash);
+   while (g_hash_table_iter_next(&iter, &key, &value)) {
+      Cached_Detection * cached = value;
+      int ct = fprintf(fp, "%s:%04x %d %d %04x %s\n", (char *) key,
+                           cached->dref_flags,
+                           cached->vcp_version.major, cached->vcp_version.minor,
+                           cached->bus_flags,
+                           cached->connector_status);
+      if (ct < 0) {
+         ok = false;
+         break;
+      }
+   }
+   return ok;
+}
+
+
+static void save_detection_cache_file() {
+   bool debug = false;
+   char * data_file_name = get_detection_cache_file_name();
+   DBGTRC_STARTING(debug, TRACE_GROUP, "data_file_name=%s", data_file_name);
+
+   char * lockfn = get_detection_cache_lock_file_name();
+   int lockfd = file_lock(lockfn, true, ferr());
+   free(lockfn);
+   write_file_atomically(data_file_name, write_detection_lines, NULL, ferr());
+   file_unlock(lockfd);
+
+   free(data_file_name);
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+// loads the file if not already loaded, must be called with mutex held
+static void ensure_detection_cache_loaded() {
+   if (!detection_hash) {
+      Error_Info * errs = load_detection_cache_file();
+      if (errs) {
+         if (ERRINFO_STATUS(errs) == -ENOENT)
+            errinfo_free(errs);
+         else
+            ERRINFO_FREE_WITH_REPORT(errs,true);
+      }
+   }
+}
+
+
+// Returns the lookup key for an I2C display, and the current connector status.
+// Returns NULL if the display cannot be cached.
+static char * detection_key(Display_Ref * dref, char ** status_loc) {
+   *status_loc = NULL;
+   if (dref->io_path.io_mode != DDCA_IO_I2C || !dref->pedid || !dref->detail)
+      return NULL;
+
+   int busno = dref->io_path.path.i2c_busno;
+   char * connector = find_sysfs_drm_connector_name(busno);
+   if (connector)
+      *status_loc = get_sysfs_drm_connector_status(connector);
+   char * edid_hex = hexstring2(dref->pedid->bytes, 128, NULL, false, NULL, 0);
+   char * key = g_strdup_printf("i2c-%d %s %s", busno, (connector) ? connector : "-", edid_hex);
+   free(edid_hex);
+   free(connector);
+   if (!*status_loc)
+      *status_loc = strdup("unknown");
+   return key;
+}
+
+
+// Publicly visible functions
+
+/** Emit a debug report of the detection cache
+ *
+ *  \param depth  logical indentation depth
+ *  \param msg    if non-null, emit this message before the report
+ */
+void dbgrpt_detection_cache(int depth, const char * msg) {
+   g_mutex_lock(&detection_cache_mutex);
+   dbgrpt_detection_hash0(depth, msg);
+   g_mutex_unlock(&detection_cache_mutex);
+}
+
+
+/** Returns the name of the file that stores display detection results
+ *
+ *  \return name of file, normally $HOME/.cache/ddcutil/displays
+ */
+/* caller is responsible for freeing returned value */
+char * get_detection_cache_file_name() {
+   return xdg_cache_home_file("ddcutil", "displays");
+}
+
+
+/** Enable saving and using display detection results.
+ *
+ *  \param  newval   true to enable, false to disable
+ *  \return old setting
+ *
+ *  \remark
+ *  As with the capabilities cache, disabling deletes the file.
+ */
+bool enable_detection_cache(bool newval) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "newval=%s", sbool(newval));
+   g_mutex_lock(&detection_cache_mutex);
+   bool old = detection_cache_enabled;
+   detection_cache_enabled = newval;
+   if (!newval) {
+      if (detection_hash) {
+         g_hash_table_destroy(detection_hash);
+         detection_hash = NULL;
+      }
+      delete_detection_cache_file();
+   }
+   g_mutex_unlock(&detection_cache_mutex);
+   DBGTRC_RET_BOOL(debug, TRACE_GROUP, old, "");
+   return old;
+}
+
+
+bool is_detection_cache_enabled() {
+   return detection_cache_enabled;
+}
+
+
+/** Sets the initial check results for a display from the detection cache.
+ *
+ *  \param  dref  display reference
+ *  \return true if valid cached results were found and applied, false if not
+ */
+bool ddc_restore_cached_detection(Display_Ref * dref) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dref=%s", dref_repr_t(dref));
+
+   bool found = false;
+   if (detection_cache_enabled && !i2c_force_bus) {
+      char * status = NULL;
+      char * key = detection_key(dref, &status);
+      if (key) {
+         I2C_Bus_Info * businfo = dref->detail;
+         g_mutex_lock(&detection_cache_mutex);
+         ensure_detection_cache_loaded();
+         Cached_Detection * data = g_hash_table_lookup(detection_hash, key);
+         if (data &&
+             streq(data->connector_status, status) &&
+             data->bus_flags == (businfo->flags & CHECKED_BUS_FLAGS) &&
+             (data->dref_flags & DREF_DDC_COMMUNICATION_WORKING) )
+         {
+            dref->flags |= data->dref_flags;
+            dref->vcp_version_xdf = data->vcp_version;
+            found = true;
+         }
+         g_mutex_unlock(&detection_cache_mutex);
+         free(key);
+      }
+      free(status);
+   }
+
+   DBGTRC_RET_BOOL(debug, TRACE_GROUP, found, "dref->flags: %s", interpret_dref_flags_t(dref->flags));
+   return found;
+}
+
+
+/** Records the initial check results for a display in the detection cache.
+ *  The cache file is not written until #ddc_save_detection_cache() is called.
+ *
+ *  \param  dref  display reference
+ */
+void ddc_record_detection(Display_Ref * dref) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dref=%s, flags: %s",
+                   dref_repr_t(dref), interpret_dref_flags_t(dref->flags));
+
+   if (detection_cache_enabled && !i2c_force_bus &&
+       (dref->flags & DREF_DDC_COMMUNICATION_WORKING) )
+   {
+      char * status = NULL;
+      char * key = detection_key(dref, &status);
+      if (key) {
+         I2C_Bus_Info * businfo = dref->detail;
+         Cached_Detection data = {0};
+         data.dref_flags = dref->flags & CACHED_DREF_FLAGS;
+         data.vcp_version = dref->vcp_version_xdf;
+         data.bus_flags = businfo->flags & CHECKED_BUS_FLAGS;
+         g_strlcpy(data.connector_status, status, sizeof(data.connector_status));
+
+         g_mutex_lock(&detection_cache_mutex);
+         ensure_detection_cache_loaded();
+         Cached_Detection * old = g_hash_table_lookup(detection_hash, key);
+         if (!old || memcmp(old, &data, sizeof(Cached_Detection)) != 0) {
+            Cached_Detection * newdata = calloc(1, sizeof(Cached_Detection));
+            *newdata = data;
+            g_hash_table_replace(detection_hash, key, newdata);
+            key = NULL;      // now owned by hash table
+            detection_hash_changed = true;
+         }
+         g_mutex_unlock(&detection_cache_mutex);
+         free(key);
+      }
+      free(status);
+   }
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+/** Writes the detection cache file if any entries have changed. */
+void ddc_save_detection_cache() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "detection_hash_changed=%s", sbool(detection_hash_changed));
+   g_mutex_lock(&detection_cache_mutex);
+   if (detection_cache_enabled && detection_hash && detection_hash_changed) {
+      save_detection_cache_file();
+      detection_hash_changed = false;
+   }
+   g_mutex_unlock(&detection_cache_mutex);
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+void init_ddc_detection_cache() {
+   RTTI_ADD_FUNC(load_detection_cache_file);
+   RTTI_ADD_FUNC(save_detection_cache_file);
+   RTTI_ADD_FUNC(enable_detection_cache);
+   RTTI_ADD_FUNC(ddc_restore_cached_detection);
+   RTTI_ADD_FUNC(ddc_record_detection);
+   RTTI_ADD_FUNC(ddc_save_detection_cache);
+}
@@ -0,0 +1,22 @@
+/** \file ddc_detection_cache.h */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_DETECTION_CACHE_H_
+#define DDC_DETECTION_CACHE_H_
+
+#include <stdbool.h>
+
+#include "base/displays.h"
+
+bool   enable_detection_cache(bool onoff);
+bool   is_detection_cache_enabled();
+char * get_detection_cache_file_name();
+bool   ddc_restore_cached_detection(Display_Ref * dref);
+void   ddc_record_detection(Display_Ref * dref);
+void   ddc_save_detection_cache();
+void   dbgrpt_detection_cache(int depth, const char * msg);
+void   init_ddc_detection_cache();
+
+#endif /* DDC_DETECTION_CACHE_H_ */
@@ -37,6 +37,7 @@
 #include "base/monitor_model_key.h"
 #include "base/parms.h"
 #include "base/rtti.h"
+#include "base/worker_pool.h"
 
 #include "vcp/vcp_feature_codes.h"
 
@@ -50,6 +51,7 @@
 
 #include "public/ddcutil_types.h"
 
+#include "ddc/ddc_detection_cache.h"
 #include "ddc/ddc_packet_io.h"
 #include "ddc/ddc_vcp.h"
 #include "ddc/ddc_vcp_version.h"
@@ -263,10 +265,17 @@ bool ddc_initial_checks_by_dref(Display_Ref * dref) {
    Display_Handle * dh = NULL;
    Public_Status_Code psc = 0;
 
+   if (ddc_restore_cached_detection(dref)) {
+      result = true;
+      goto bye;
+   }
+
    psc = ddc_open_display(dref, CALLOPT_ERR_MSG, &dh);
    if (psc == 0)  {
       result = ddc_initial_checks_by_dh(dh);
       ddc_close_display(dh);
+      if (result)
+         ddc_record_detection(dref);
    }
    // else {    // why else?
      dref->flags |= DREF_DDC_COMMUNICATION_CHECKED;
@@ -274,6 +283,7 @@ bool ddc_initial_checks_by_dref(Display_Ref * dref) {
    if (psc == -EBUSY)
       dref->flags |= DREF_DDC_BUSY;
 
+bye:
    DBGTRC_DONE(debug, TRACE_GROUP, "Returning %s. dref = %s", sbool(result), dref_repr_t(dref) );
    DBGTRC_NOPREFIX(debug, TRACE_GROUP, "communication flags: %s", interpret_dref_flags_t(dref->flags));
    return result;
@@ -866,32 +876,23 @@ bye:
 }
 
 
-/**
+static void pooled_initial_checks_by_dref(gpointer data, gpointer arg) {
+   threaded_initial_checks_by_dref(data);
+}
+
+
+/** Performs initial checks on all displays using the shared worker pool,
+ *  so the number of threads is bounded by the pool size rather than
+ *  growing with the number of displays.
+ *
  *  \param all_displays #GPtrArray of pointers to #Display_Ref
  */
 void ddc_async_scan(GPtrArray * all_displays) {
    bool debug = false;
-   DBGTRC_STARTING(debug, TRACE_GROUP, "all_displays=%p, display_count=%d", all_displays, all_displays->len);
+   DBGTRC_STARTING(debug, TRACE_GROUP, "all_displays=%p, display_count=%d, worker pool size=%d",
+                                       all_displays, all_displays->len, get_worker_pool_size());
 
-   GPtrArray * threads = g_ptr_array_new();
-   for (int ndx = 0; ndx < all_displays->len; ndx++) {
-      Display_Ref * dref = g_ptr_array_index(all_displays, ndx);
-      TRACED_ASSERT( memcmp(dref->marker, DISPLAY_REF_MARKER, 4) == 0 );
-
-      GThread * th =
-      g_thread_new(
-            dref_repr_t(dref),
-            threaded_initial_checks_by_dref,
-            dref);
-      g_ptr_array_add(threads, th);
-   }
-   DBGMSF(debug, "Started %d threads", threads->len);
-   for (int ndx = 0; ndx < threads->len; ndx++) {
-      GThread * thread = g_ptr_array_index(threads, ndx);
-      g_thread_join(thread);  // implicitly unrefs the GThread
-   }
-   DBGMSF(debug, "Threads joined");
-   g_ptr_array_free(threads, true);
+   run_in_worker_pool(all_displays, pooled_initial_checks_by_dref, NULL);
 
 #ifdef OLD
    for (int ndx = 0; ndx < all_displays->len; ndx++) {
@@ -1025,26 +1026,9 @@ void filter_phantom_displays(GPtrArray * all_displays) {
 }
 
 
-/** Searches the master display list for a display matching the
- *  specified #Display_Identifier, returning its #Display_Ref
- *
- *  \param did display identifier to search for
- *  \return #Display_Ref for the display, NULL if not found or
- *          display doesn't support DDC
- *
- * \remark
- * The returned value is a pointer into an internal data structure
- * and should not be freed by the caller.
- */
-Display_Ref *
-ddc_find_display_ref_by_display_identifier(Display_Identifier * did) {
-   bool debug = false;
-   DBGMSF(debug, "Starting. did=%s", did_repr(did));
-   if (debug)
-      dbgrpt_display_identifier(did, 1);
-
-   Display_Ref * result = NULL;
-
+// returned criteria point into did, do not free them
+static Display_Criteria *
+criteria_from_display_identifier(Display_Identifier * did) {
    Display_Criteria * criteria = new_display_criteria();
 
    switch(did->id_type) {
@@ -1072,7 +1056,31 @@ ddc_find_display_ref_by_display_identifier(Display_Identifier * did) {
    case DISP_ID_HIDDEV:
       criteria->hiddev = did->hiddev_devno;
    }
+   return criteria;
+}
+
 
+/** Searches the master display list for a display matching the
+ *  specified #Display_Identifier, returning its #Display_Ref
+ *
+ *  \param did display identifier to search for
+ *  \return #Display_Ref for the display, NULL if not found or
+ *          display doesn't support DDC
+ *
+ * \remark
+ * The returned value is a pointer into an internal data structure
+ * and should not be freed by the caller.
+ */
+Display_Ref *
+ddc_find_display_ref_by_display_identifier(Display_Identifier * did) {
+   bool debug = false;
+   DBGMSF(debug, "Starting. did=%s", did_repr(did));
+   if (debug)
+      dbgrpt_display_identifier(did, 1);
+
+   Display_Ref * result = NULL;
+
+   Display_Criteria * criteria = criteria_from_display_identifier(did);
    result = ddc_find_display_ref_by_criteria(criteria);
 
    // Is this the best location in the call chain to make this check?
@@ -1122,6 +1130,41 @@ get_display_ref_for_display_identifier(
 }
 
 
+static gint compare_dref_dispno(gconstpointer a, gconstpointer b) {
+   Display_Ref * dref_a = *(Display_Ref **) a;
+   Display_Ref * dref_b = *(Display_Ref **) b;
+   return dref_a->dispno - dref_b->dispno;
+}
+
+
+/** Returns all detected displays that support DDC and match a #Display_Identifier.
+ *
+ *  \param  pdid  pointer to a #Display_Identifier, if NULL all displays match
+ *  \return array of #Display_Ref in display number order, caller must free
+ *          the array but not the references it contains
+ */
+GPtrArray *
+ddc_get_display_refs_for_display_identifier(
+                Display_Identifier* pdid)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "pdid=%s", did_repr(pdid));
+
+   GPtrArray * result = g_ptr_array_new();
+   Display_Criteria * criteria = (pdid) ? criteria_from_display_identifier(pdid) : new_display_criteria();
+   for (int ndx = 0; ndx < all_displays->len; ndx++) {
+      Display_Ref * dref = g_ptr_array_index(all_displays, ndx);
+      if (dref->dispno > 0 && ddc_check_display_ref(dref, criteria))
+         g_ptr_array_add(result, dref);
+   }
+   free(criteria);   // do not free pointers in criteria, they are owned by Display_Identifier
+   g_ptr_array_sort(result, compare_dref_dispno);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %d displays", result->len);
+   return result;
+}
+
+
 /** Detects all connected displays by querying the I2C and USB subsystems.
  *
  * \return array of #Display_Ref
@@ -1198,6 +1241,7 @@ ddc_detect_all_displays() {
       ddc_async_scan(display_list);
    else
       ddc_non_async_scan(display_list);
+   ddc_save_detection_cache();
 
    if (olev == DDCA_OL_VERBOSE)
       set_output_level(olev);
@@ -1379,6 +1423,7 @@ void
 init_ddc_displays() {
    RTTI_ADD_FUNC(ddc_async_scan);
    RTTI_ADD_FUNC(ddc_redetect_displays);
+   RTTI_ADD_FUNC(ddc_get_display_refs_for_display_identifier);
    RTTI_ADD_FUNC(ddc_detect_all_displays);
    RTTI_ADD_FUNC(filter_phantom_displays);
    RTTI_ADD_FUNC(ddc_initial_checks_by_dh);
@@ -47,6 +47,10 @@ get_display_ref_for_display_identifier(
    Display_Identifier* pdid,
    Call_Options        callopts);
 
+GPtrArray *
+ddc_get_display_refs_for_display_identifier(
+   Display_Identifier* pdid);
+
 void
 ddc_dbgrpt_display_ref(Display_Ref * drec, int depth);
 
@@ -45,10 +45,13 @@
 #include "ddc/ddc_packet_io.h"
 #include "ddc/ddc_read_capabilities.h"
 #include "ddc/ddc_vcp.h"
+#include "ddc/ddc_vcp_value_cache.h"
 #include "ddc/ddc_vcp_version.h"
 
 #include "ddc/ddc_dumpload.h"
 
+// Default trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
 
 /** Frees a #Dumpload_Data struct.  The underlying Vcp_Value_set is also freed.
  *
@@ -342,6 +345,103 @@ create_dumpload_data_from_g_ptr_array(
 #undef ADD_DATA_ERROR
 
 
+static bool differential_loadvcp = DEFAULT_DIFFERENTIAL_LOADVCP;
+
+/** Controls whether loadvcp writes only the values that differ from
+ *  those currently held by the monitor.
+ *
+ *  \param  onoff  true to enable, false to disable
+ *  \return prior setting
+ */
+bool ddc_enable_differential_loadvcp(bool onoff) {
+   bool old = differential_loadvcp;
+   differential_loadvcp = onoff;
+   return old;
+}
+
+
+/** Reports whether loadvcp writes only the values that differ.
+ *
+ *  \return true if enabled, false if not
+ */
+bool ddc_is_differential_loadvcp_enabled() {
+   return differential_loadvcp;
+}
+
+
+// unlike the comparison used for verification, checks the full non-table value
+static bool
+vcp_values_differ(DDCA_Any_Vcp_Value * vrec1, DDCA_Any_Vcp_Value * vrec2) {
+   bool result = true;
+   if (vrec1->value_type == vrec2->value_type) {
+      if (vrec1->value_type == DDCA_NON_TABLE_VCP_VALUE)
+         result = vrec1->val.c_nc.sh != vrec2->val.c_nc.sh ||
+                  vrec1->val.c_nc.sl != vrec2->val.c_nc.sl;
+      else
+         result = vrec1->val.t.bytect != vrec2->val.t.bytect ||
+                  memcmp(vrec1->val.t.bytes, vrec2->val.t.bytes, vrec1->val.t.bytect) != 0;
+   }
+   return result;
+}
+
+
+/** Reads the current values of the features in a #Vcp_Value_Set, and
+ *  determines which differ from the values to be set.
+ *
+ *  The values are read using #ddc_get_vcp_values(), so that the inter-command
+ *  sleeps overlap interpretation of the responses.  A feature whose current
+ *  value cannot be read is treated as differing.  Any cached values of the
+ *  features are discarded first, so that the values compared are those
+ *  actually in effect.
+ *
+ *  @param   dh      display handle
+ *  @param   vset    values to set
+ *  @return  array of value_ct flags, true if the value should be written,
+ *           caller must free
+ */
+bool *
+ddc_find_changed_values(
+      Display_Handle* dh,
+      Vcp_Value_Set   vset)
+{
+   bool debug = false;
+   int value_ct = vcp_value_set_size(vset);
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dh=%s, value_ct=%d", dh_repr_t(dh), value_ct);
+
+   Byte *                 feature_codes = calloc(value_ct, sizeof(Byte));
+   DDCA_Vcp_Value_Type *  value_types   = calloc(value_ct, sizeof(DDCA_Vcp_Value_Type));
+   DDCA_Any_Vcp_Value **  valrecs       = calloc(value_ct, sizeof(DDCA_Any_Vcp_Value *));
+   bool *                 changed       = calloc(value_ct, sizeof(bool));
+   for (int ndx = 0; ndx < value_ct; ndx++) {
+      DDCA_Any_Vcp_Value * vrec = vcp_value_set_get(vset, ndx);
+      feature_codes[ndx] = vrec->opcode;
+      value_types[ndx]   = vrec->value_type;
+      ddc_invalidate_cached_vcp_value(dh->dref, vrec->opcode);
+   }
+
+   Error_Info * excp = ddc_get_vcp_values(dh, value_ct, feature_codes, value_types, valrecs, NULL);
+   if (excp) {
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "ddc_get_vcp_values() returned %s", errinfo_summary(excp));
+      errinfo_free(excp);
+   }
+
+   int changed_ct = 0;
+   for (int ndx = 0; ndx < value_ct; ndx++) {
+      changed[ndx] = !valrecs[ndx] || vcp_values_differ(vcp_value_set_get(vset, ndx), valrecs[ndx]);
+      if (changed[ndx])
+         changed_ct++;
+      if (valrecs[ndx])
+         free_single_vcp_value(valrecs[ndx]);
+   }
+   free(feature_codes);
+   free(value_types);
+   free(valrecs);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "%d of %d values differ", changed_ct, value_ct);
+   return changed;
+}
+
+
 /** Sets multiple VCP values.
  *
  * @param   dh      display handle
@@ -350,6 +450,9 @@ create_dumpload_data_from_g_ptr_array(
  *
  * This function stops applying values on the first error encountered, and
  * returns the value of that error as its status code.
+ *
+ * If differential loading is enabled, the current values are read first,
+ * and only the values that differ are written.
  */
 Error_Info *
 ddc_set_multiple(
@@ -359,12 +462,15 @@ ddc_set_multiple(
    Public_Status_Code psc = 0;
    Error_Info *        ddc_excp = NULL;
    int value_ct = vcp_value_set_size(vset);
+   bool * changed = (differential_loadvcp) ? ddc_find_changed_values(dh, vset) : NULL;
 
    int ndx;
    for (ndx=0; ndx < value_ct; ndx++) {
       DDCA_Any_Vcp_Value * vrec
       = vcp_value_set_get(vset, ndx);
       Byte   feature_code = vrec->opcode;
+      if (changed && !changed[ndx])
+         continue;
 
       // HACK: will this affect intermittent error of silently failing sets?
       // pointless, ddc_it2_write_only) calls call_tuned_sleep() after write
@@ -385,6 +491,7 @@ ddc_set_multiple(
 
    } // for loop
 
+   free(changed);
    return ddc_excp;
 }
 
@@ -870,6 +977,7 @@ dumpvcp_as_string(Display_Handle * dh, char ** result_loc) {
 
 
 void init_ddc_dumpload() {
+   RTTI_ADD_FUNC(ddc_find_changed_values);
    RTTI_ADD_FUNC(format_timestamp);
    RTTI_ADD_FUNC(collect_machine_readable_timestamp);
 }
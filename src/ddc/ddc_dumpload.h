@@ -51,6 +51,17 @@ free_dumpload_data(Dumpload_Data * pdata);
 char *
 format_timestamp(time_t time_millis, char * buf, int bufsz);
 
+bool
+ddc_enable_differential_loadvcp(bool onoff);
+
+bool
+ddc_is_differential_loadvcp_enabled();
+
+bool *
+ddc_find_changed_values(
+      Display_Handle * dh,
+      Vcp_Value_Set    vset);
+
 Error_Info *
 loadvcp_by_dumpload_data(
       Dumpload_Data*   pdata,
@@ -471,6 +471,10 @@ collect_raw_feature_set_values2_dfm(
    // needed when called from C API, o.w. get get NULL response for first feature
    // DBGMSG("Inserting sleep() before first call to get_raw_value_for_feature_table_entry()");
    // sleep_millis_with_trace(DDC_TIMEOUT_MILLIS_DEFAULT, __func__, "initial");
+
+   // overlap post-read sleeps with processing between reads, see ddc_get_vcp_values()
+   bool saved_defer_sleeps = dh->defer_sleeps;
+   dh->defer_sleeps = true;
    int ndx;
    for (ndx=0; ndx< features_ct; ndx++) {
       Display_Feature_Metadata * dfm = dyn_get_feature_set_entry2(feature_set, ndx);
@@ -505,6 +509,7 @@ collect_raw_feature_set_values2_dfm(
          break;
       }
    }
+   dh->defer_sleeps = saved_defer_sleeps;
 
    DBGMSF(debug, "Done.  Returning: %s", psc_desc(master_status_code));
    return master_status_code;
@@ -777,6 +782,10 @@ show_feature_set_values2_dfm(
    FILE * msg_fh = outf;                        // TO FIX
    int features_ct = dyn_get_feature_set_size2(feature_set);
    DBGMSF(debug, "features_ct=%d", features_ct);
+
+   // overlap post-read sleeps with value formatting and output, see ddc_get_vcp_values()
+   bool saved_defer_sleeps = dh->defer_sleeps;
+   dh->defer_sleeps = true;
    int ndx;
    for (ndx=0; ndx< features_ct; ndx++) {
       Display_Feature_Metadata * dfm = dyn_get_feature_set_entry2(feature_set, ndx);
@@ -838,6 +847,7 @@ show_feature_set_values2_dfm(
       }
       DBGMSF(debug,"ndx=%d, feature = 0x%02x Done", ndx, dfm->feature_code);
    }   // loop over features
+   dh->defer_sleeps = saved_defer_sleeps;
 
    DBGMSF(debug, "Returning: %s", psc_desc(master_status_code));
    return master_status_code;
@@ -845,23 +855,23 @@ show_feature_set_values2_dfm(
 
 
 
-#ifdef FUTURE
-//typedef bool (*VCP_Feature_Set_Filter_Func)(VCP_Feature_Table_Entry * ventry);
-bool hack42(VCP_Feature_Table_Entry * ventry) {
+/** Filter function for #filter_feature_set2().  Rejects synthesized
+ *  (i.e. manufacturer specific or otherwise unrecognized) table features,
+ *  which cannot be read if the monitor does not support table commands.
+ */
+static bool hack42(Display_Feature_Metadata * dfm) {
    bool debug = false;
    bool result = true;
 
-   // if (ventry->code >= 0xe0)  {     // is everything promoted to int before comparison?
-   if ( (ventry->vcp_global_flags & DDCA_SYNTHETIC) &&
-        (ventry->v20_flags & DDCA_NORMAL_TABLE)
+   if ( (dfm->feature_flags & DDCA_SYNTHETIC) &&
+        (dfm->feature_flags & DDCA_NORMAL_TABLE)
       )
    {
       result = false;
-      DBGMSF(debug, "Returning false for vcp code 0x%02x", ventry->code);
+      DBGMSF(debug, "Returning false for vcp code 0x%02x", dfm->feature_code);
    }
    return result;
 }
-#endif
 
 
 
@@ -900,16 +910,16 @@ ddc_show_vcp_values(
                                     dh->dref,   // vcp_version,
                                     flags);
 
-#ifdef FUTURE
-   Parsed_Capabilities * pcaps = NULL;   // TODO: HOW TO GET Parsed_Capabilities?, will only be set for probe/interrogate
-   // special case, if scanning, don't try to do a table read of manufacturer specific
-   // features if it's clear that table read commands are unavailable
-
-   // convoluted solution to avoid passing additional argument to create_feature_set()
-   if (subset == VCP_SUBSET_SCAN && !parsed_capabilities_may_support_table_commands(pcaps)) {
-      filter_feature_set(feature_set, hack42);
+   // Special case: if scanning, don't try to do a table read of manufacturer
+   // specific features if it's clear that table read commands are unavailable.
+   // Uses the parsed capabilities shared by the display reference, if they have
+   // already been obtained (e.g. by probe), rather than reading them here.
+   Parsed_Capabilities * pcaps = g_atomic_pointer_get(&dh->dref->pcaps);
+   if (subset == VCP_SUBSET_SCAN && pcaps && pcaps->raw_cmds_segment_seen &&
+       !parsed_capabilities_supports_table_commands(pcaps))
+   {
+      filter_feature_set2(feature_set, hack42);
    }
-#endif
    if (debug || IS_TRACING()) {
       DBGMSG("feature_set:");
       dbgrpt_dyn_feature_set(feature_set, true, 0);
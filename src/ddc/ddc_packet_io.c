@@ -35,13 +35,16 @@
 #include "base/displays.h"
 #include "base/dynamic_sleep.h"
 #include "base/execution_stats.h"
+#include "base/last_io_event.h"
 #include "base/parms.h"
+#include "base/per_display_data.h"
 #include "base/rtti.h"
 #include "base/status_code_mgt.h"
 #include "base/tuned_sleep.h"
 #include "base/thread_sleep_data.h"
 
 #include "i2c/i2c_bus_core.h"
+#include "i2c/i2c_bus_lock.h"
 #include "i2c/i2c_strategy_dispatcher.h"
 
 #ifdef USE_USB
@@ -49,7 +52,9 @@
 #endif
 
 #include "ddc/ddc_display_lock.h"
+#include "ddc/ddc_request_queue.h"
 #include "ddc/ddc_try_stats.h"
+#include "ddc/ddc_vcp.h"
 
 #include "ddc/ddc_packet_io.h"
 
@@ -153,6 +158,7 @@ ddc_open_display(
    if (callopts & CALLOPT_WAIT)
       ddisp_flags |= DDISP_WAIT;
 
+   uint64_t shared_next_io_after = 0;    // set from cross-process bus lock record
    DDCA_Status lockrc = lock_distinct_display(ddisp_ref, ddisp_flags);
    if (lockrc == DDCRC_LOCKED) {     // locked in another thread
       ddcrc = DDCRC_LOCKED;          // is there an appropriate errno value?  EBUSY? EACCES?
@@ -181,6 +187,30 @@ ddc_open_display(
          TRACED_ASSERT(bus_info);   // need to convert to a test?
          TRACED_ASSERT( bus_info && memcmp(bus_info, I2C_BUS_INFO_MARKER, 4) == 0);
 
+         // serialize with other processes using the bus
+         // The lock is held only for the duration of each transaction.
+         // Here it is acquired just to read when the bus was last used.
+         int bus_lockfd = -1;
+         if (is_i2c_bus_locks_enabled()) {
+            bus_lockfd = i2c_open_bus_lock(dref->io_path.path.i2c_busno);
+            if (bus_lockfd >= 0) {
+               int bus_lockrc = i2c_lock_bus(bus_lockfd,
+                                      (callopts & CALLOPT_WAIT) ? -1 : I2C_BUS_LOCK_TIMEOUT_MILLIS,
+                                      &shared_next_io_after);
+               if (bus_lockrc == DDCRC_LOCKED) {
+                  if (callopts & CALLOPT_ERR_MSG)
+                     f0printf(ferr(), "/dev/"I2C"-%d is in use by another process\n",
+                                      dref->io_path.path.i2c_busno);
+                  i2c_close_bus_lock(bus_lockfd);
+                  ddcrc = DDCRC_LOCKED;
+                  break;
+               }
+               if (bus_lockrc == 0)
+                  i2c_release_bus(bus_lockfd);
+            }
+            // if the lock file is unusable, proceed without it
+         }
+
          int fd = i2c_open_bus(dref->io_path.path.i2c_busno, callopts);
          if (fd < 0) {
             ddcrc = fd;
@@ -214,6 +244,12 @@ ddc_open_display(
                }
             }
          }
+         if (bus_lockfd >= 0) {
+            if (dh)
+               dh->bus_lockfd = bus_lockfd;
+            else
+               i2c_close_bus_lock(bus_lockfd);
+         }
       }
       break;
 
@@ -249,8 +285,19 @@ ddc_open_display(
    TRACED_ASSERT(!dh || dh->dref->pedid);
 
    if (ddcrc == 0) {
-      if (dref->io_path.io_mode != DDCA_IO_USB)
-         TUNED_SLEEP_WITH_TRACE(dh, SE_POST_OPEN, NULL);
+      if (dref->io_path.io_mode != DDCA_IO_USB) {
+         set_io_event_display_data(dh->fd, dref->async_rec->pdd);
+         dsa_load_persistent_adjustment(dref);
+         if (shared_next_io_after > 0) {
+            // Another process recorded when the bus may next be used.
+            // Wait only for any remainder of that interval.
+            if (shared_next_io_after > dref->next_i2c_io_after)
+               dref->next_i2c_io_after = shared_next_io_after;
+         }
+         else {
+            TUNED_SLEEP_WITH_TRACE(dh, SE_POST_OPEN, NULL);
+         }
+      }
       dref->flags |= DREF_OPEN;
       // protect with lock?
       TRACED_ASSERT(open_displays);
@@ -280,6 +327,9 @@ bye:
  *
  *  \remark
  *  Logs underlying status code if error.
+ *  \remark
+ *  Waits for any requests using **dh** that are queued on the
+ *  display's executor thread.
  */
 Status_Errno
 ddc_close_display(Display_Handle * dh) {
@@ -292,10 +342,27 @@ ddc_close_display(Display_Handle * dh) {
       rc = DDCRC_INVALID_OPERATION;    // or DDCRC_ARG?
    }
    else {
+      // the display's executor thread may still be using dh
+      ddc_wait_display_requests_by_dh(dh);
+      // failures are reported by the deferred verify failure function
+      Error_Info * verify_excp = ddc_flush_deferred_verifies(dh);
+      if (verify_excp) {
+         DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Deferred verification: %s", errinfo_summary(verify_excp));
+         errinfo_free(verify_excp);
+      }
+      if (dh->dref->io_path.io_mode != DDCA_IO_USB)
+         dsa_save_persistent_adjustment(dh->dref);
+
       switch(dh->dref->io_path.io_mode) {
       case DDCA_IO_I2C:
          {
+            // clear the mapping before the descriptor can be reused by another open
+            set_io_event_display_data(dh->fd, NULL);
             rc = i2c_close_bus(dh->fd, CALLOPT_NONE);
+            if (dh->bus_lockfd >= 0) {
+               i2c_close_bus_lock(dh->bus_lockfd);
+               dh->bus_lockfd = -1;
+            }
             if (rc != 0) {
                TRACED_ASSERT(rc < 0);
                DBGMSG("i2c_close_bus returned %d, errno=%s", rc, psc_desc(errno) );
@@ -372,6 +439,72 @@ DDCA_Status (*Write_Read_Raw_Function)(
 // Write and read operations that take DDC_Packets
 //
 
+/** Locks held for the duration of a DDC transaction */
+typedef struct {
+   bool display_locked;    // display lock acquired for this transaction
+   bool bus_locked;        // cross-process bus lock acquired
+} Transaction_Locks;
+
+
+/** Acquires the locks on an open display for the duration of a DDC transaction.
+ *
+ *  The display lock serializes I/O with the display's request executor thread.
+ *  It is not acquired if the current thread already holds it, i.e. if this
+ *  is the executor thread performing a queued request.
+ *
+ *  The cross-process lock on the I2C bus serializes I/O with other processes.
+ *  Any deferred sleep recorded by another process is applied to the display.
+ *
+ *  \param  dh     display handle
+ *  \param  locks  where to record the locks acquired
+ *  \return 0 if success, or if the bus lock file is not usable,
+ *          DDCRC_LOCKED if the bus is in use by another process
+ */
+static Status_Errno_DDC
+lock_for_transaction(Display_Handle * dh, Transaction_Locks * locks) {
+   Status_Errno_DDC rc = 0;
+   Display_Async_Rec * async_rec = dh->dref->async_rec;
+   locks->display_locked = false;
+   locks->bus_locked     = false;
+   if (async_rec->thread_owning_display_lock != g_thread_self())
+      locks->display_locked = lock_display_lock(async_rec, true);
+   if (dh->bus_lockfd >= 0) {
+      uint64_t shared_next_io_after = 0;
+      rc = i2c_lock_bus(dh->bus_lockfd, I2C_BUS_LOCK_TIMEOUT_MILLIS, &shared_next_io_after);
+      if (rc == 0) {
+         locks->bus_locked = true;
+         if (shared_next_io_after > dh->dref->next_i2c_io_after)
+            dh->dref->next_i2c_io_after = shared_next_io_after;
+      }
+      else if (rc != DDCRC_LOCKED) {
+         rc = 0;     // proceed without the lock
+      }
+   }
+   if (rc != 0 && locks->display_locked) {
+      unlock_display_lock(async_rec);
+      locks->display_locked = false;
+   }
+   return rc;
+}
+
+
+/** Records when the bus was last used and releases the locks acquired by
+ *  #lock_for_transaction().
+ *
+ *  \param  dh     display handle
+ *  \param  locks  locks recorded by #lock_for_transaction()
+ */
+static void
+unlock_after_transaction(Display_Handle * dh, Transaction_Locks * locks) {
+   if (locks->bus_locked)
+      i2c_unlock_bus(dh->bus_lockfd,
+                     get_io_event_timestamp(dh->fd)->finish_time,
+                     dh->dref->next_i2c_io_after);
+   if (locks->display_locked)
+      unlock_display_lock(dh->dref->async_rec);
+}
+
+
 /* Writes a DDC request packet to an open I2C bus
  * and returns the raw response.
  *
@@ -420,9 +553,13 @@ DDCA_Status ddc_i2c_write_read_raw(
    TRACED_ASSERT(slave_addr >> 1 == 0x37);
 #endif
 
+   Transaction_Locks locks;
+   Status_Errno_DDC rc = lock_for_transaction(dh, &locks);
+   if (rc != 0)
+      goto bye;
+
    CHECK_DEFERRED_SLEEP(dh);
-   Status_Errno_DDC rc =
-         invoke_i2c_writer(
+   rc =  invoke_i2c_writer(
                            dh->fd,
                            0x37,
                            get_packet_len(request_packet_ptr)-1,
@@ -454,6 +591,9 @@ DDCA_Status ddc_i2c_write_read_raw(
          //        hexstring(get_packet_start(request_packet_ptr)+1, get_packet_len(request_packet_ptr)-1));
       }
    }
+   unlock_after_transaction(dh, &locks);
+
+bye:
    if (rc < 0) {
       COUNT_STATUS_CODE(rc);
    }
@@ -510,19 +650,22 @@ DDCA_Status ddc_write_read_raw(
 /** Writes a DDC request packet to a monitor and provides basic response parsing
  *  based whether the response type is continuous, non-continuous, or table.
  *
+ *  Unlike #ddc_write_read(), failure is reported only as a status code,
+ *  so that callers retrying the operation need not allocate an #Error_Info
+ *  for each failed try.
+ *
  *  \param dh                  display handle (for either I2C or ADL device)
  *  \param request_packet_ptr  DDC packet to write
+ *  \param read_bytewise       read one byte at a time
  *  \param max_read_bytes      maximum number of bytes to read
  *  \param expected_response_type expected response type to check for
  *  \param expected_subtype    expected subtype to check for
  *  \param response_packet_ptr_loc  where to write address of response packet received
  *
- *  \return pointer to #Error_Info struct if failure, NULL if success
- *  \remark
- *  Issue: positive ADL codes, need to handle?
+ *  \return status code, 0 if success
  */
-Error_Info *
-ddc_write_read(
+static DDCA_Status
+ddc_write_read_status(
       Display_Handle * dh,
       DDC_Packet *     request_packet_ptr,
       bool             read_bytewise,
@@ -536,7 +679,12 @@ ddc_write_read(
    DBGTRC_STARTING(debug, TRACE_GROUP, "dh=%s, read_bytewise=%s, max_read_bytes=%d",
                  dh_repr_t(dh), sbool(read_bytewise), max_read_bytes );
 
-   Byte * readbuf = calloc(1, max_read_bytes);
+   // the response is copied into the response packet, so a stack buffer
+   // suffices unless the caller asks for an unusually large read
+   Byte   stack_readbuf[MAX_DDC_PACKET_INC_CHECKSUM+1] = {0};
+   Byte * readbuf = (max_read_bytes <= (int) sizeof(stack_readbuf))
+                        ? stack_readbuf
+                        : calloc(1, max_read_bytes);
    int    bytes_received = max_read_bytes;
    DDCA_Status    psc;
    *response_packet_ptr_loc = NULL;
@@ -564,32 +712,70 @@ ddc_write_read(
               ddcrc_desc_t(psc), *response_packet_ptr_loc );
 
        if (psc != 0 && *response_packet_ptr_loc) {  // paranoid,  should never occur
-          free(*response_packet_ptr_loc);
+          free_ddc_packet(*response_packet_ptr_loc);
           *response_packet_ptr_loc = NULL;
        }
    }
-   dsa_record_ddcrw_status_code(psc);
+   dsa_record_ddcrw_status_code(dh, psc);
 
-   free(readbuf);    // or does response_packet_ptr_loc point into here?
+   if (readbuf != stack_readbuf)
+      free(readbuf);
 
    // already done:
    // if (rc != 0)
    //    COUNT_STATUS_CODE(psc);
 
-   // Convert status code to Error_Info *
-   Error_Info * excp = NULL;
-   if (psc < 0)
-      excp = errinfo_new(psc, __func__);
-
-   if (excp) {
-      DBGTRC_DONE(debug, TRACE_GROUP, "Returning: %s", errinfo_summary(excp)  );
+   if (psc < 0) {
+      DBGTRC_DONE(debug, TRACE_GROUP, "Returning: %s", psc_desc(psc)  );
    }
    else {
-      DBGTRC_DONE(debug, TRACE_GROUP, "Returning: NULL, *response_packet_ptr_loc ->");
+      DBGTRC_DONE(debug, TRACE_GROUP, "Returning: 0, *response_packet_ptr_loc ->");
       if (debug || IS_TRACING())
          dbgrpt_packet(*response_packet_ptr_loc, 2);
    }
 
+   return (psc < 0) ? psc : 0;
+}
+
+
+/** Writes a DDC request packet to a monitor and provides basic response parsing
+ *  based whether the response type is continuous, non-continuous, or table.
+ *
+ *  \param dh                  display handle (for either I2C or ADL device)
+ *  \param request_packet_ptr  DDC packet to write
+ *  \param max_read_bytes      maximum number of bytes to read
+ *  \param expected_response_type expected response type to check for
+ *  \param expected_subtype    expected subtype to check for
+ *  \param response_packet_ptr_loc  where to write address of response packet received
+ *
+ *  \return pointer to #Error_Info struct if failure, NULL if success
+ *  \remark
+ *  Issue: positive ADL codes, need to handle?
+ */
+Error_Info *
+ddc_write_read(
+      Display_Handle * dh,
+      DDC_Packet *     request_packet_ptr,
+      bool             read_bytewise,
+      int              max_read_bytes,
+      Byte             expected_response_type,
+      Byte             expected_subtype,
+      DDC_Packet **    response_packet_ptr_loc
+     )
+{
+   DDCA_Status psc = ddc_write_read_status(
+                        dh,
+                        request_packet_ptr,
+                        read_bytewise,
+                        max_read_bytes,
+                        expected_response_type,
+                        expected_subtype,
+                        response_packet_ptr_loc);
+
+   // Convert status code to Error_Info *
+   Error_Info * excp = NULL;
+   if (psc < 0)
+      excp = errinfo_new(psc, __func__);
    return excp;
 }
 
@@ -649,7 +835,12 @@ ddc_write_read_with_retry(
    // ddcrc_null_response_max = 6;  // *** TEMP *** for testing
    DBGMSF(debug, "retry_null_response = %s, ddcrc_null_response_max = %d",
           sbool(retry_null_response), ddcrc_null_response_max);
-   Error_Info * try_errors[MAX_MAX_TRIES];
+   // Failed tries are recorded as status codes.  Error_Info instances are
+   // created for them only if the operation fails, or if exception detail
+   // has been requested, so that a success after retry allocates nothing.
+   DDCA_Status  try_status[MAX_MAX_TRIES];
+   bool         want_try_errors = IS_DBGTRC(debug, TRACE_GROUP | DDCA_TRC_RETRY) ||
+                                  report_freed_exceptions;
 
    // TRACED_ASSERT(max_write_read_exchange_tries > 0);   // to avoid clang warning
    int max_tries = try_data_get_maxtries2(WRITE_READ_TRIES_OP);
@@ -662,7 +853,7 @@ ddc_write_read_with_retry(
            "Start of try loop, tryctr=%d, max_tries=%d, rc=%d, retryable=%s, read_bytewise=%s",
            tryctr, max_tries, psc, sbool(retryable), sbool(read_bytewise) );
 
-      Error_Info * cur_excp = ddc_write_read(
+      psc = ddc_write_read_status(
                 dh,
                 request_packet_ptr,
                 read_bytewise,
@@ -673,11 +864,10 @@ ddc_write_read_with_retry(
 
       // TESTCASES:
       // if (tryctr < 2)
-      // cur_excp = errinfo_new(DDCRC_NULL_RESPONSE, "dummy");
-      // cur_excp = errinfo_new(-EIO, "dummy");
+      // psc = DDCRC_NULL_RESPONSE;
+      // psc = -EIO;
 
-      psc = (cur_excp) ? cur_excp->status_code : 0;
-      try_errors[tryctr] = cur_excp;
+      try_status[tryctr] = psc;
 
       if (psc == 0 && ddcrc_null_response_ct > 0) {
          DBGTRC_NOPREFIX(debug, TRACE_GROUP | DDCA_TRC_RETRY,
@@ -704,7 +894,7 @@ ddc_write_read_with_retry(
                      if (retryable) {
                         if (ddcrc_null_response_ct == 1 && get_output_level() >= DDCA_OL_VERBOSE)
                            f0printf(fout(), "Extended delay as recovery from DDC Null Response...\n");
-                        tsd_set_sleep_multiplier_ct(ddcrc_null_response_ct+1);
+                        pdd_set_sleep_multiplier_ct(dh, ddcrc_null_response_ct+1);
                         sleep_multiplier_incremented = true;
                         // replaces: call_dynamic_tuned_sleep_i2c(SE_DDC_NULL, ddcrc_null_response_ct);
                      }
@@ -752,26 +942,23 @@ ddc_write_read_with_retry(
    // DBGMSG("psc=%d, tryctr=%d, errct=%d", psc, tryctr, errct);
 
    // read_bytewise = !read_bytewise;
-#ifdef OLD
-   if (debug) {
-      for (int ndx = 0; ndx < tryctr; ndx++) {
-         DBGMSG("try_errors[ndx] = %p", try_errors[ndx]);
-         DBGMSG("try_errors[%d] = %s", ndx, errinfo_summary(try_errors[ndx]));
-      }
+   Error_Info * try_errors[MAX_MAX_TRIES];
+   int          try_error_ct = 0;
+   if (psc < 0 || want_try_errors) {
+      for (; try_error_ct < errct; try_error_ct++)
+         try_errors[try_error_ct] = errinfo_new(try_status[try_error_ct], "ddc_write_read");
    }
-#endif
-   // DBGMSG("try_errors = %p, &try_errors=%p", try_errors, &try_errors);
-   if (errct > 0) {
+
+   if (errct > 0 && IS_DBGTRC(debug, TRACE_GROUP | DDCA_TRC_RETRY)) {
          char * s0 = (psc == 0) ? "Succeeded" : "Failed";
          char * s1 = (errct == 1) ? "" : "s";
          char * s = errinfo_array_summary(try_errors, errct);
          DBGTRC_NOPREFIX(debug, TRACE_GROUP | DDCA_TRC_RETRY, "%s after %d error%s: %s", s0, errct, s1, s);
          free(s);
-
    }
    if (sleep_multiplier_incremented) {
-      tsd_set_sleep_multiplier_ct(1);   // in case we changed it
-      tsd_bump_sleep_multiplier_changer_ct();
+      pdd_set_sleep_multiplier_ct(dh, 1);   // in case we changed it
+      pdd_bump_sleep_multiplier_changer_ct(dh);
    }
 
    Error_Info * ddc_excp = NULL;
@@ -789,17 +976,17 @@ ddc_write_read_with_retry(
 
       ddc_excp = errinfo_new_with_causes(psc, try_errors, tryctr, __func__);
 
-      if (psc != try_errors[tryctr-1]->status_code)
+      if (psc != try_status[tryctr-1])
          COUNT_STATUS_CODE(psc);     // new status code, count it
    }
    else {
-      for (int ndx = 0; ndx < tryctr-1; ndx++) {
+      for (int ndx = 0; ndx < try_error_ct; ndx++) {
          // errinfo_free(try_errors[ndx]);
          ERRINFO_FREE_WITH_REPORT(try_errors[ndx], debug || IS_TRACING() || report_freed_exceptions);
       }
    }
 
-   try_data_record_tries2(WRITE_READ_TRIES_OP, psc, tryctr);
+   try_data_record_tries2(dh, WRITE_READ_TRIES_OP, psc, tryctr);
 
    DBGTRC_DONE(debug, TRACE_GROUP, "Total Tries (tryctr): %d. Returning: %s", tryctr, errinfo_summary(ddc_excp));
    return ddc_excp;
@@ -837,20 +1024,24 @@ ddc_i2c_write_only(
    // assert(slave_address == 0x37);
    Byte slave_address = 0x37;
 
-   CHECK_DEFERRED_SLEEP(dh);
-   Status_Errno_DDC rc =
-         invoke_i2c_writer(fh,
-                           slave_address,
-                           get_packet_len(request_packet_ptr)-1,
-                           get_packet_start(request_packet_ptr)+1 );
-   if (rc < 0)
-      log_status_code(rc, __func__);
-   Sleep_Event_Type sleep_type =
-         (request_packet_ptr->type == DDC_PACKET_TYPE_SAVE_CURRENT_SETTINGS )
-            ? SE_POST_SAVE_SETTINGS
-            : SE_POST_WRITE;
-   // tuned_sleep_i2c_with_trace(sleep_type, __func__, NULL);
-   TUNED_SLEEP_WITH_TRACE(dh, sleep_type, NULL);
+   Transaction_Locks locks;
+   Status_Errno_DDC rc = lock_for_transaction(dh, &locks);
+   if (rc == 0) {
+      CHECK_DEFERRED_SLEEP(dh);
+      rc = invoke_i2c_writer(fh,
+                             slave_address,
+                             get_packet_len(request_packet_ptr)-1,
+                             get_packet_start(request_packet_ptr)+1 );
+      if (rc < 0)
+         log_status_code(rc, __func__);
+      Sleep_Event_Type sleep_type =
+            (request_packet_ptr->type == DDC_PACKET_TYPE_SAVE_CURRENT_SETTINGS )
+               ? SE_POST_SAVE_SETTINGS
+               : SE_POST_WRITE;
+      // tuned_sleep_i2c_with_trace(sleep_type, __func__, NULL);
+      TUNED_SLEEP_WITH_TRACE(dh, sleep_type, NULL);
+      unlock_after_transaction(dh, &locks);
+   }
    DBGTRC_RETURNING(debug, TRACE_GROUP, rc, "");
    return rc;
 }
@@ -908,7 +1099,7 @@ ddc_write_only_with_retry(
    DDCA_Status        psc;
    int                tryctr;
    bool               retryable;
-   Error_Info *       try_errors[MAX_MAX_TRIES];
+   DDCA_Status        try_status[MAX_MAX_TRIES];
 
    int max_tries = try_data_get_maxtries2(WRITE_ONLY_TRIES_OP);
    TRACED_ASSERT(max_tries > 0);
@@ -920,11 +1111,8 @@ ddc_write_only_with_retry(
              "Start of try loop, tryctr=%d, max_tries=%d, rc=%d, retryable=%d",
              tryctr, max_tries, psc, retryable );
 
-      Error_Info * cur_excp = ddc_write_only(dh, request_packet_ptr);
-      psc = (cur_excp) ? cur_excp->status_code : 0;
-      try_errors[tryctr] = cur_excp;
-
-      // try_status_codes[tryctr] = psc;   // for future Ddc_Error mechanism
+      psc = ddc_i2c_write_only(dh, request_packet_ptr);
+      try_status[tryctr] = psc;
    }
 
    Error_Info * ddc_excp = NULL;
@@ -944,22 +1132,27 @@ ddc_write_only_with_retry(
       if (retryable)
          psc = DDCRC_RETRIES;
 
+      // Error_Info instances for the failed tries are created only now
+      Error_Info * try_errors[MAX_MAX_TRIES];
+      for (int ndx = 0; ndx < tryctr; ndx++)
+         try_errors[ndx] = errinfo_new(try_status[ndx], "ddc_write_only");
       ddc_excp = errinfo_new_with_causes(psc, try_errors, tryctr, __func__);
 
-      if (psc != try_errors[tryctr-1]->status_code)
+      if (psc != try_status[tryctr-1])
          COUNT_STATUS_CODE(psc);     // new status code, count it
    }
-   else {
+   else if (debug || IS_TRACING() || report_freed_exceptions) {
       // 2 possibilities:
       //   succeeded after retries, there will be some errors (tryctr > 1)
       //   no errors (tryctr == 1)
       // int last_bad_try_index = tryctr-2;
       for (int ndx = 0; ndx < tryctr-1; ndx++) {
-         ERRINFO_FREE_WITH_REPORT(try_errors[ndx], debug || IS_TRACING() || report_freed_exceptions);
+         Error_Info * try_error = errinfo_new(try_status[ndx], "ddc_write_only");
+         ERRINFO_FREE_WITH_REPORT(try_error, true);
       }
    }
 
-   try_data_record_tries2(WRITE_ONLY_TRIES_OP, psc, tryctr);
+   try_data_record_tries2(dh, WRITE_ONLY_TRIES_OP, psc, tryctr);
 
    DBGTRC_DONE(debug, TRACE_GROUP, "Returning: %s", errinfo_summary(ddc_excp));
    return ddc_excp;
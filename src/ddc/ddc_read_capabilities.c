@@ -28,6 +28,7 @@
 #include "usb/usb_displays.h"
 #endif
 
+#include "vcp/parse_capabilities.h"
 #include "vcp/persistent_capabilities.h"
 
 #include "ddc/ddc_multi_part_io.h"
@@ -129,7 +130,7 @@ ddc_get_capabilities_string(
       }
       else {
          // n. persistent_capabilities_enabled handled in get_persistent_capabilities()
-         dh->dref->capabilities_string = g_strdup(get_persistent_capabilities(dh->dref->mmid));
+         dh->dref->capabilities_string = get_persistent_capabilities(dh->dref->mmid);
          DBGTRC_NOPREFIX(debug, TRACE_GROUP, "get_persistent_capabilities() returned |%s|",
                                     dh->dref->capabilities_string);
          if (dh->dref->capabilities_string && get_output_level() >= DDCA_OL_VERBOSE) {
@@ -155,6 +156,57 @@ ddc_get_capabilities_string(
 }
 
 
+
+/** Returns the parsed capabilities for a display.
+ *
+ *  The parsed capabilities are obtained once per #Display_Ref, and are
+ *  shared with other displays having the same capabilities string.
+ *
+ *  \param  dh         display handle
+ *  \param  pcaps_loc  where to return pointer to #Parsed_Capabilities
+ *  \return NULL if success, #Error_Info if unable to obtain capabilities string
+ *
+ *  \remark
+ *  The returned #Parsed_Capabilities is owned by the display reference.
+ *  It must not be modified or freed by the caller.  Use
+ *  parsed_capabilities_ref() to retain it beyond the life of the
+ *  display reference.
+ */
+Error_Info *
+ddc_get_parsed_capabilities(
+      Display_Handle *       dh,
+      Parsed_Capabilities ** pcaps_loc)
+{
+   bool debug = false;
+   assert(dh);
+   assert(dh->dref);
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dh=%s", dh_repr_t(dh));
+
+   Display_Ref * dref = dh->dref;
+   char * caps = NULL;
+   Error_Info * ddc_excp = NULL;
+   if (!g_atomic_pointer_get(&dref->pcaps)) {
+      ddc_excp = ddc_get_capabilities_string(dh, &caps);
+      if (!ddc_excp) {
+         Parsed_Capabilities * pcaps = NULL;
+         if (dref->io_path.io_mode == DDCA_IO_USB) {
+            // synthesized string, not shared with other displays
+            pcaps = parse_capabilities_string(caps);
+            pcaps->raw_value_synthesized = true;
+         }
+         else {
+            pcaps = get_parsed_capabilities(caps);
+         }
+         if (!g_atomic_pointer_compare_and_exchange(&dref->pcaps, NULL, pcaps))
+            free_parsed_capabilities(pcaps);    // another thread got there first
+      }
+   }
+   *pcaps_loc = g_atomic_pointer_get(&dref->pcaps);
+   DBGTRC_RET_ERRINFO(debug, TRACE_GROUP, ddc_excp, "*pcaps_loc -> %p", *pcaps_loc);
+   return ddc_excp;
+}
+
+
 #ifdef UNUSED
 Error_Info *
 get_capabilities_string_by_dref(Display_Ref * dref, char **pcaps) {
@@ -190,6 +242,8 @@ get_capabilities_string_by_dref(Display_Ref * dref, char **pcaps) {
 
 void init_ddc_read_capabilities() {
    RTTI_ADD_FUNC(ddc_get_capabilities_string);
+   RTTI_ADD_FUNC(ddc_get_parsed_capabilities);
+   set_dref_pcaps_release_func(free_parsed_capabilities);
    RTTI_ADD_FUNC(get_capabilities_into_buffer);
 }
 
@@ -14,6 +14,8 @@
 #include "base/displays.h"
 #include "base/status_code_mgt.h"
 
+#include "vcp/parse_capabilities.h"
+
 
 // Get capability string for monitor.
 
@@ -22,6 +24,13 @@ ddc_get_capabilities_string(
       Display_Handle * dh,
       char**           caps_loc);
 
+// Get parsed capabilities for monitor, shared by monitors of the same model
+
+Error_Info *
+ddc_get_parsed_capabilities(
+      Display_Handle *       dh,
+      Parsed_Capabilities ** pcaps_loc);
+
 void init_ddc_read_capabilities();
 
 #endif /* DDC_READ_CAPABILITIES_H_ */
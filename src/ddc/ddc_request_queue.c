@@ -0,0 +1,581 @@
+/** @file ddc_request_queue.c
+ *
+ *  Per-display request queue and executor thread.
+ *
+ *  Each #Display_Async_Rec, i.e. each distinct #DDCA_IO_Path, has its own
+ *  request queue serviced by a single executor thread.  Get and set VCP value
+ *  operations queued for different displays therefore execute concurrently,
+ *  so that the DDC protocol sleeps for one monitor overlap those of the others,
+ *  while operations for a single display are still performed serially.
+ *
+ *  The executor thread is started when the first request is queued for a display,
+ *  and runs until ddc_stop_display_request_threads() is called at termination.
+ *
+ *  If set request coalescing is enabled, a set request queued while an
+ *  earlier set request for the same feature is still waiting at the end of
+ *  the queue replaces it, so that only the latest value is written.  This
+ *  bounds the latency of e.g. brightness slider drags to a single transaction.
+ *  The replaced request completes with the status and value of the one that
+ *  replaced it.
+ *
+ *  The executor performs I/O using the #Display_Handle specified by the caller,
+ *  applying the caller's output level, sleep multiplier, and verification
+ *  settings (including whether verification is deferred) as they were when
+ *  the request was queued.  The lock acquired by
+ *  ddc_open_display() remains owned by the thread that opened the display.
+ *  Instead, the executor holds the display's I/O lock (see lock_display_lock())
+ *  while a request executes, so that its transactions do not interleave
+ *  with those performed directly by the thread using the handle.
+ *
+ *  ddc_close_display() waits for any outstanding requests on the handle.
+ *  The request is no longer considered outstanding when its callback is
+ *  called, so the callback may close the handle.  Requests for the same
+ *  handle that are still queued at that point are cancelled.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "config.h"
+
+/** \cond */
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/error_info.h"
+#include "util/report_util.h"
+/** \endcond */
+
+#include "base/core.h"
+#include "base/ddc_errno.h"
+#include "base/displays.h"
+#include "base/parms.h"
+#include "base/per_thread_data.h"
+#include "base/rtti.h"
+#include "base/thread_sleep_data.h"
+
+#include "vcp/vcp_feature_values.h"
+
+#include "ddc/ddc_vcp.h"
+
+#include "ddc/ddc_request_queue.h"
+
+
+// Trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
+
+// Display_Async_Recs for which an executor thread has been started
+static GPtrArray * active_async_recs = NULL;
+static GMutex      active_async_recs_mutex;
+
+static bool        setvcp_coalescing_enabled = DEFAULT_ENABLE_SETVCP_COALESCING;
+
+
+/** Enables or disables coalescing of queued set VCP value requests.
+ *
+ *  \param  onoff  true to enable, false to disable
+ *  \return prior setting
+ */
+bool ddc_enable_setvcp_coalescing(bool onoff) {
+   bool old = setvcp_coalescing_enabled;
+   setvcp_coalescing_enabled = onoff;
+   return old;
+}
+
+
+/** Reports whether queued set VCP value requests are coalesced.
+ *
+ *  \return true if enabled, false if not
+ */
+bool ddc_is_setvcp_coalescing_enabled() {
+   return setvcp_coalescing_enabled;
+}
+
+
+const char * display_request_type_name(Display_Request_Type request_type) {
+   char * result = NULL;
+   switch(request_type) {
+   case DISPLAY_REQUEST_GET_VCP:  result = "DISPLAY_REQUEST_GET_VCP";   break;
+   case DISPLAY_REQUEST_SET_VCP:  result = "DISPLAY_REQUEST_SET_VCP";   break;
+   }
+   return result;
+}
+
+
+void dbgrpt_display_request(Display_Request * request, int depth) {
+   int d1 = depth+1;
+   rpt_structure_loc("Display_Request", request, depth);
+   if (request) {
+      rpt_vstring(d1, "request_type:  %s", display_request_type_name(request->request_type));
+      rpt_vstring(d1, "dh:            %s", dh_repr_t(request->dh));
+      rpt_vstring(d1, "feature_code:  0x%02x", request->feature_code);
+      rpt_vstring(d1, "verify:        %s", sbool(request->verify));
+      rpt_vstring(d1, "defer_verify:  %s", sbool(request->defer_verify));
+      rpt_vstring(d1, "output_level:  %s", output_level_name(request->output_level));
+      rpt_vstring(d1, "sleep multiplier factor: %5.2f", request->sleep_multiplier_factor);
+      rpt_vstring(d1, "callback:      %p", request->callback);
+      rpt_vstring(d1, "superseded ct: %d", (request->superseded) ? request->superseded->len : 0);
+      rpt_vstring(d1, "completed:     %s", sbool(request->completed));
+      rpt_vstring(d1, "coalesced:     %s", sbool(request->coalesced));
+      rpt_vstring(d1, "excp:          %s", errinfo_summary(request->excp));
+   }
+}
+
+
+/** Frees a #Display_Request, including any result value and
+ *  #Error_Info not taken by the caller.
+ *
+ *  @param request  pointer to request, may be NULL
+ */
+void ddc_free_display_request(Display_Request * request) {
+   if (request) {
+      assert(memcmp(request->marker, DISPLAY_REQUEST_MARKER, 4) == 0);
+      if (request->setvalue)
+         free_single_vcp_value(request->setvalue);
+      if (request->result_value)
+         free_single_vcp_value(request->result_value);
+      if (request->excp)
+         errinfo_free(request->excp);
+      if (request->superseded)
+         g_ptr_array_free(request->superseded, true);
+      request->marker[3] = 'x';
+      free(request);
+   }
+}
+
+
+static void execute_display_request(Display_Request * request) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "request_type=%s, dh=%s, feature_code=0x%02x",
+         display_request_type_name(request->request_type),
+         dh_repr_t(request->dh), request->feature_code);
+
+   // apply the caller's per-thread settings
+   DDCA_Output_Level saved_output_level = set_output_level(request->output_level);
+   double saved_sleep_multiplier_factor = tsd_get_sleep_multiplier_factor();
+   tsd_set_sleep_multiplier_factor(request->sleep_multiplier_factor);
+
+   switch(request->request_type) {
+   case DISPLAY_REQUEST_GET_VCP:
+      request->excp = ddc_get_vcp_value(
+                          request->dh,
+                          request->feature_code,
+                          request->value_type,
+                          &request->result_value);
+      break;
+   case DISPLAY_REQUEST_SET_VCP:
+      {
+         bool saved_verify = ddc_set_verify_setvcp(request->verify);
+         bool saved_defer_verify = ddc_set_deferred_verify(request->defer_verify);
+         request->excp = ddc_set_vcp_value(
+                             request->dh,
+                             request->setvalue,
+                             (request->verify) ? &request->result_value : NULL);
+         ddc_set_deferred_verify(saved_defer_verify);
+         ddc_set_verify_setvcp(saved_verify);
+         // report the value applied to requests that were coalesced with this one
+         if (request->superseded && !request->result_value && !request->excp)
+            request->result_value = clone_single_vcp_value(request->setvalue);
+      }
+      break;
+   }
+
+   set_output_level(saved_output_level);
+   tsd_set_sleep_multiplier_factor(saved_sleep_multiplier_factor);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "excp=%s", errinfo_summary(request->excp));
+}
+
+
+/** Completes a request, calling its callback if it has one.
+ *  Must be called without holding the queue lock.
+ */
+static void complete_display_request(Display_Async_Rec * async_rec, Display_Request * request) {
+   if (request->callback) {
+      request->callback(request);
+      ddc_free_display_request(request);
+   }
+   else {
+      g_mutex_lock(&async_rec->request_queue_lock);
+      request->completed = true;   // caller may free request as soon as it sees this
+      g_cond_broadcast(&async_rec->request_queue_cond);
+      g_mutex_unlock(&async_rec->request_queue_lock);
+   }
+}
+
+
+/** Completes the requests whose values were replaced by a request that
+ *  has just executed, giving each a copy of its status and value.
+ *  Must be called without holding the queue lock.
+ */
+static void complete_superseded_requests(Display_Async_Rec * async_rec, Display_Request * request) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "request=%p, superseded ct=%d", request, request->superseded->len);
+
+   for (int ndx = 0; ndx < request->superseded->len; ndx++) {
+      Display_Request * cur = g_ptr_array_index(request->superseded, ndx);
+      cur->excp = errinfo_copy(request->excp);
+      if (request->result_value)
+         cur->result_value = clone_single_vcp_value(request->result_value);
+      cur->coalesced = true;
+      complete_display_request(async_rec, cur);
+   }
+   g_ptr_array_set_size(request->superseded, 0);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+static gpointer display_request_executor(gpointer data) {
+   bool debug = false;
+   Display_Async_Rec * async_rec = data;
+   assert(memcmp(async_rec->marker, DISPLAY_ASYNC_REC_MARKER, 4) == 0);
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dpath=%s", dpath_repr_t(&async_rec->dpath));
+
+   char buf[40];
+   g_snprintf(buf, 40, "Request executor for %s", dpath_short_name_t(&async_rec->dpath));
+   ptd_set_thread_description(buf);
+
+   g_mutex_lock(&async_rec->request_queue_lock);
+   while (true) {
+      while (g_queue_is_empty(async_rec->request_queue) && !async_rec->request_thread_terminate)
+         g_cond_wait(&async_rec->request_queue_cond, &async_rec->request_queue_lock);
+      if (g_queue_is_empty(async_rec->request_queue))    // and terminating
+         break;
+
+      Display_Request * request = g_queue_pop_head(async_rec->request_queue);
+      async_rec->active_request = request;
+      g_mutex_unlock(&async_rec->request_queue_lock);
+
+      lock_display_lock(async_rec, true);
+      execute_display_request(request);
+      unlock_display_lock(async_rec);
+
+      // The request no longer uses its display handle.  Clear it as the
+      // active request before completing it, so that a callback can call
+      // ddc_close_display(), which waits for requests using the handle.
+      g_mutex_lock(&async_rec->request_queue_lock);
+      async_rec->active_request = NULL;
+      g_cond_broadcast(&async_rec->request_queue_cond);
+      g_mutex_unlock(&async_rec->request_queue_lock);
+
+      if (request->superseded)
+         complete_superseded_requests(async_rec, request);
+      complete_display_request(async_rec, request);
+
+      g_mutex_lock(&async_rec->request_queue_lock);
+   }
+   g_mutex_unlock(&async_rec->request_queue_lock);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "dpath=%s", dpath_repr_t(&async_rec->dpath));
+   return NULL;
+}
+
+
+/** Returns the set request that a new set request may replace, i.e. the last
+ *  request in the queue if it sets the same feature using the same handle.
+ *  Must be called with the queue lock held.
+ */
+static Display_Request * find_coalescible_request(Display_Async_Rec * async_rec, Display_Request * request) {
+   Display_Request * result = g_queue_peek_tail(async_rec->request_queue);
+   if ( !result                                                     ||
+        result->request_type         != DISPLAY_REQUEST_SET_VCP      ||
+        result->dh                   != request->dh                  ||
+        result->feature_code         != request->feature_code        ||
+        result->setvalue->value_type != request->setvalue->value_type ||
+        result->verify               != request->verify              ||
+        result->defer_verify         != request->defer_verify )
+      result = NULL;
+   return result;
+}
+
+
+static void queue_display_request(Display_Request * request) {
+   bool debug = false;
+   Display_Async_Rec * async_rec = request->dh->dref->async_rec;
+   assert(memcmp(async_rec->marker, DISPLAY_ASYNC_REC_MARKER, 4) == 0);
+   DBGTRC_STARTING(debug, TRACE_GROUP, "request_type=%s, dh=%s, feature_code=0x%02x",
+         display_request_type_name(request->request_type),
+         dh_repr_t(request->dh), request->feature_code);
+
+   g_mutex_lock(&async_rec->request_queue_lock);
+   if (!async_rec->request_execution_thread) {
+      async_rec->request_thread_terminate = false;
+      async_rec->request_execution_thread =
+            g_thread_new("display_request_executor", display_request_executor, async_rec);
+      g_mutex_lock(&active_async_recs_mutex);
+      g_ptr_array_add(active_async_recs, async_rec);
+      g_mutex_unlock(&active_async_recs_mutex);
+   }
+   if (request->request_type == DISPLAY_REQUEST_SET_VCP && setvcp_coalescing_enabled) {
+      Display_Request * pending = find_coalescible_request(async_rec, request);
+      if (pending) {
+         DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Replacing pending request %p", pending);
+         g_queue_pop_tail(async_rec->request_queue);
+         request->superseded = (pending->superseded) ? pending->superseded : g_ptr_array_new();
+         pending->superseded = NULL;
+         g_ptr_array_add(request->superseded, pending);
+      }
+   }
+   g_queue_push_tail(async_rec->request_queue, request);
+   int queue_len = g_queue_get_length(async_rec->request_queue);
+   g_cond_broadcast(&async_rec->request_queue_cond);
+   g_mutex_unlock(&async_rec->request_queue_lock);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "queue length: %d", queue_len);
+}
+
+
+static Display_Request * display_request_new(
+      Display_Request_Type     request_type,
+      Display_Handle *         dh,
+      Display_Request_Callback callback,
+      void *                   callback_data)
+{
+   Display_Request * request = calloc(1, sizeof(Display_Request));
+   memcpy(request->marker, DISPLAY_REQUEST_MARKER, 4);
+   request->request_type  = request_type;
+   request->dh            = dh;
+   request->callback      = callback;
+   request->callback_data = callback_data;
+   request->output_level  = get_output_level();
+   request->sleep_multiplier_factor = tsd_get_sleep_multiplier_factor();
+   return request;
+}
+
+
+/** Queues a get VCP value request for execution on the display's executor thread.
+ *
+ *  @param  dh             display handle
+ *  @param  feature_code   VCP feature code
+ *  @param  value_type     #DDCA_NON_TABLE_VCP_VALUE or #DDCA_TABLE_VCP_VALUE
+ *  @param  callback       if non-NULL, called on the executor thread on completion,
+ *                         after which the request is freed
+ *  @param  callback_data  passed to the callback in the request
+ *  @return request, must be passed to #ddc_wait_display_request() and
+ *          #ddc_free_display_request() iff **callback** is NULL
+ */
+Display_Request * ddc_queue_get_vcp_request(
+      Display_Handle *         dh,
+      Byte                     feature_code,
+      DDCA_Vcp_Value_Type      value_type,
+      Display_Request_Callback callback,
+      void *                   callback_data)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dh=%s, feature_code=0x%02x", dh_repr_t(dh), feature_code);
+
+   Display_Request * request =
+         display_request_new(DISPLAY_REQUEST_GET_VCP, dh, callback, callback_data);
+   request->feature_code = feature_code;
+   request->value_type   = value_type;
+   queue_display_request(request);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %p", request);
+   return request;
+}
+
+
+/** Queues a set VCP value request for execution on the display's executor thread.
+ *  Whether the value is verified, and whether verification is deferred,
+ *  is determined by the current thread's settings at the time of the call.
+ *
+ *  If coalescing is enabled and the last queued request sets the same feature,
+ *  the new request replaces it.  The replaced request then completes with
+ *  #Display_Request.coalesced set, and the status and value of the new request.
+ *
+ *  @param  dh             display handle
+ *  @param  setvalue       value to set, ownership passes to the request
+ *  @param  callback       if non-NULL, called on the executor thread on completion,
+ *                         after which the request is freed
+ *  @param  callback_data  passed to the callback in the request
+ *  @return request, must be passed to #ddc_wait_display_request() and
+ *          #ddc_free_display_request() iff **callback** is NULL
+ */
+Display_Request * ddc_queue_set_vcp_request(
+      Display_Handle *         dh,
+      DDCA_Any_Vcp_Value *     setvalue,
+      Display_Request_Callback callback,
+      void *                   callback_data)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dh=%s, feature_code=0x%02x", dh_repr_t(dh), setvalue->opcode);
+
+   Display_Request * request =
+         display_request_new(DISPLAY_REQUEST_SET_VCP, dh, callback, callback_data);
+   request->feature_code = setvalue->opcode;
+   request->value_type   = setvalue->value_type;
+   request->setvalue     = setvalue;
+   request->verify       = ddc_get_verify_setvcp();
+   request->defer_verify = ddc_get_deferred_verify();
+   queue_display_request(request);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %p", request);
+   return request;
+}
+
+
+/** Waits for a request queued without a callback to complete.
+ *
+ *  @param request  request returned by #ddc_queue_get_vcp_request() or
+ *                  #ddc_queue_set_vcp_request()
+ */
+void ddc_wait_display_request(Display_Request * request) {
+   bool debug = false;
+   assert(memcmp(request->marker, DISPLAY_REQUEST_MARKER, 4) == 0);
+   assert(!request->callback);
+   Display_Async_Rec * async_rec = request->dh->dref->async_rec;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "request=%p, dh=%s", request, dh_repr_t(request->dh));
+
+   g_mutex_lock(&async_rec->request_queue_lock);
+   while (!request->completed)
+      g_cond_wait(&async_rec->request_queue_cond, &async_rec->request_queue_lock);
+   g_mutex_unlock(&async_rec->request_queue_lock);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "excp=%s", errinfo_summary(request->excp));
+}
+
+
+static bool has_request_for_dh(Display_Async_Rec * async_rec, Display_Handle * dh) {
+   Display_Request * active = async_rec->active_request;
+   if (active && active->dh == dh)
+      return true;
+   for (GList * l = async_rec->request_queue->head; l; l = l->next) {
+      Display_Request * request = l->data;
+      if (request->dh == dh)
+         return true;
+   }
+   return false;
+}
+
+
+/** Removes the requests using the specified display handle from the queue,
+ *  and completes them with status DDCRC_INVALID_OPERATION.
+ *
+ *  @param async_rec  display's #Display_Async_Rec
+ *  @param dh         display handle
+ */
+static void cancel_requests_by_dh(Display_Async_Rec * async_rec, Display_Handle * dh) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dh=%s", dh_repr_t(dh));
+
+   GPtrArray * cancelled = g_ptr_array_new();
+   g_mutex_lock(&async_rec->request_queue_lock);
+   GList * l = async_rec->request_queue->head;
+   while (l) {
+      GList * next = l->next;
+      Display_Request * request = l->data;
+      if (request->dh == dh) {
+         g_queue_delete_link(async_rec->request_queue, l);
+         g_ptr_array_add(cancelled, request);
+      }
+      l = next;
+   }
+   g_mutex_unlock(&async_rec->request_queue_lock);
+
+   for (int ndx = 0; ndx < cancelled->len; ndx++) {
+      Display_Request * request = g_ptr_array_index(cancelled, ndx);
+      request->excp = errinfo_new(DDCRC_INVALID_OPERATION, __func__);
+      if (request->superseded)
+         complete_superseded_requests(async_rec, request);
+      complete_display_request(async_rec, request);
+   }
+   int cancelled_ct = cancelled->len;
+   g_ptr_array_free(cancelled, true);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "cancelled %d requests", cancelled_ct);
+}
+
+
+/** Waits until no request using the specified display handle is
+ *  queued or executing.  Called before the handle is closed.
+ *
+ *  If called on the display's executor thread, i.e. from a request callback,
+ *  requests for the handle that are still queued would never be executed,
+ *  so they are cancelled instead.
+ *
+ *  @param dh  display handle
+ */
+void ddc_wait_display_requests_by_dh(Display_Handle * dh) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dh=%s", dh_repr_t(dh));
+
+   Display_Async_Rec * async_rec = dh->dref->async_rec;
+   if (async_rec) {
+      g_mutex_lock(&async_rec->request_queue_lock);
+      bool on_executor_thread = (async_rec->request_execution_thread == g_thread_self());
+      g_mutex_unlock(&async_rec->request_queue_lock);
+      if (on_executor_thread) {
+         cancel_requests_by_dh(async_rec, dh);
+      }
+      else {
+         g_mutex_lock(&async_rec->request_queue_lock);
+         while (has_request_for_dh(async_rec, dh))
+            g_cond_wait(&async_rec->request_queue_cond, &async_rec->request_queue_lock);
+         g_mutex_unlock(&async_rec->request_queue_lock);
+      }
+   }
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+/** Terminates all executor threads, after they have completed any
+ *  queued requests.  Called at program or library termination.
+ *
+ *  The threads are joined without holding #active_async_recs_mutex, since
+ *  a callback executing on one of them may queue a request for a display
+ *  whose executor has not yet been started.  Any executor started that way
+ *  is terminated in turn.
+ */
+void ddc_stop_display_request_threads() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "");
+
+   while (true) {
+      g_mutex_lock(&active_async_recs_mutex);
+      GPtrArray * async_recs = active_async_recs;
+      active_async_recs = g_ptr_array_new();
+      g_mutex_unlock(&active_async_recs_mutex);
+      if (async_recs->len == 0) {
+         g_ptr_array_free(async_recs, true);
+         break;
+      }
+
+      for (int ndx = 0; ndx < async_recs->len; ndx++) {
+         Display_Async_Rec * async_rec = g_ptr_array_index(async_recs, ndx);
+         g_mutex_lock(&async_rec->request_queue_lock);
+         GThread * thread = async_rec->request_execution_thread;
+         async_rec->request_thread_terminate = true;
+         g_cond_broadcast(&async_rec->request_queue_cond);
+         g_mutex_unlock(&async_rec->request_queue_lock);
+
+         g_thread_join(thread);
+         g_mutex_lock(&async_rec->request_queue_lock);
+         async_rec->request_execution_thread = NULL;
+         g_mutex_unlock(&async_rec->request_queue_lock);
+      }
+      g_ptr_array_free(async_recs, true);
+   }
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+void init_ddc_request_queue() {
+   active_async_recs = g_ptr_array_new();
+
+   RTTI_ADD_FUNC(display_request_executor);
+   RTTI_ADD_FUNC(execute_display_request);
+   RTTI_ADD_FUNC(queue_display_request);
+   RTTI_ADD_FUNC(complete_superseded_requests);
+   RTTI_ADD_FUNC(ddc_queue_get_vcp_request);
+   RTTI_ADD_FUNC(ddc_queue_set_vcp_request);
+   RTTI_ADD_FUNC(ddc_wait_display_request);
+   RTTI_ADD_FUNC(ddc_wait_display_requests_by_dh);
+   RTTI_ADD_FUNC(cancel_requests_by_dh);
+   RTTI_ADD_FUNC(ddc_stop_display_request_threads);
+}
@@ -0,0 +1,89 @@
+/** @file ddc_request_queue.h
+ *
+ *  Per-display request queue and executor thread
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_REQUEST_QUEUE_H_
+#define DDC_REQUEST_QUEUE_H_
+
+/** \cond */
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+
+#include "util/coredefs.h"
+#include "util/error_info.h"
+/** \endcond */
+
+#include "base/displays.h"
+
+#include "vcp/vcp_feature_values.h"
+
+typedef enum {
+   DISPLAY_REQUEST_GET_VCP,
+   DISPLAY_REQUEST_SET_VCP
+} Display_Request_Type;
+
+const char * display_request_type_name(Display_Request_Type request_type);
+bool         ddc_enable_setvcp_coalescing(bool onoff);
+bool         ddc_is_setvcp_coalescing_enabled();
+
+struct Display_Request;
+
+/** Function called on the executor thread when a request completes.
+ *  Ownership of the request remains with the executor, which frees it
+ *  when the callback returns.
+ *
+ *  The request no longer uses its display handle when the callback is called.
+ *  The callback may close the handle, but must not otherwise use it, since
+ *  the handle may already have been closed by another thread.
+ */
+typedef void (*Display_Request_Callback)(struct Display_Request * request);
+
+#define DISPLAY_REQUEST_MARKER "DREQ"
+/** A get or set VCP value operation queued for execution on a display's executor thread */
+typedef struct Display_Request {
+   char                     marker[4];
+   Display_Request_Type     request_type;
+   Display_Handle *         dh;
+   Byte                     feature_code;
+   DDCA_Vcp_Value_Type      value_type;         ///< for DISPLAY_REQUEST_GET_VCP
+   DDCA_Any_Vcp_Value *     setvalue;           ///< for DISPLAY_REQUEST_SET_VCP, owned by request
+   // caller's thread settings, captured at queue time
+   bool                     verify;
+   bool                     defer_verify;
+   DDCA_Output_Level        output_level;
+   double                   sleep_multiplier_factor;
+   Display_Request_Callback callback;           ///< if NULL, caller waits using ddc_wait_display_request()
+   void *                   callback_data;
+   GPtrArray *              superseded;         ///< queued set requests replaced by this one
+   // result
+   bool                     completed;
+   bool                     coalesced;          ///< value replaced by that of a later request
+   Error_Info *             excp;               ///< owned by request unless taken by caller
+   DDCA_Any_Vcp_Value *     result_value;       ///< owned by request unless taken by caller
+} Display_Request;
+
+Display_Request * ddc_queue_get_vcp_request(
+      Display_Handle *         dh,
+      Byte                     feature_code,
+      DDCA_Vcp_Value_Type      value_type,
+      Display_Request_Callback callback,
+      void *                   callback_data);
+
+Display_Request * ddc_queue_set_vcp_request(
+      Display_Handle *         dh,
+      DDCA_Any_Vcp_Value *     setvalue,
+      Display_Request_Callback callback,
+      void *                   callback_data);
+
+void ddc_wait_display_request(Display_Request * request);
+void ddc_wait_display_requests_by_dh(Display_Handle * dh);
+void ddc_free_display_request(Display_Request * request);
+void dbgrpt_display_request(Display_Request * request, int depth);
+void ddc_stop_display_request_threads();
+void init_ddc_request_queue();
+
+#endif /* DDC_REQUEST_QUEUE_H_ */
@@ -17,6 +17,7 @@
 #include "base/base_init.h"
 #include "base/feature_metadata.h"
 #include "base/parms.h"
+#include "base/per_display_data.h"
 #include "base/rtti.h"
 #include "base/sleep.h"
 #include "base/tuned_sleep.h"
@@ -24,17 +25,20 @@
 #include "base/thread_sleep_data.h"
 
 #include "vcp/vcp_feature_codes.h"
+#include "vcp/parse_capabilities.h"
 #include "vcp/persistent_capabilities.h"
 
 #include "dynvcp/dyn_feature_codes.h"
 #include "dynvcp/dyn_feature_files.h"
 
 #include "i2c/i2c_bus_core.h"
+#include "i2c/i2c_bus_lock.h"
 #include "i2c/i2c_strategy_dispatcher.h"
 #ifdef USE_USB
 #include "usb/usb_displays.h"
 #endif
 
+#include "ddc/ddc_detection_cache.h"
 #include "ddc/ddc_display_lock.h"
 #include "ddc/ddc_displays.h"
 #include "ddc/ddc_dumpload.h"
@@ -42,8 +46,10 @@
 #include "ddc/ddc_output.h"
 #include "ddc/ddc_packet_io.h"
 #include "ddc/ddc_read_capabilities.h"
+#include "ddc/ddc_request_queue.h"
 #include "ddc/ddc_try_stats.h"
 #include "ddc/ddc_vcp.h"
+#include "ddc/ddc_vcp_value_cache.h"
 #include "ddc/ddc_watch_displays.h"
 
 #include "ddc/ddc_services.h"
@@ -63,6 +69,7 @@
 void ddc_reset_stats_main() {
    // ddc_reset_ddc_stats();
    try_data_reset2_all();
+   pdd_reset_all();
    reset_execution_stats();
 }
 
@@ -119,6 +126,12 @@ void ddc_report_stats_main(DDCA_Stats_Type stats, bool show_per_thread_stats, in
    }
 
 
+   if (stats & (DDCA_STATS_TRIES | DDCA_STATS_CALLS)) {
+      rpt_label(depth, "PER-DISPLAY EXECUTION STATISTICS");
+      rpt_nl();
+      report_all_per_display_data(depth);
+   }
+
    if (show_per_thread_stats) {
       rpt_label(depth, "PER-THREAD EXECUTION STATISTICS");
       rpt_nl();
@@ -155,6 +168,7 @@ void init_ddc_services() {
    // i2c:
    i2c_set_io_strategy(DEFAULT_I2C_IO_STRATEGY);
    init_i2c_bus_core();
+   init_i2c_bus_lock();
 
    // usb
 #ifdef USE_USB
@@ -167,16 +181,26 @@ void init_ddc_services() {
    init_vcp_feature_codes();
    init_dyn_feature_codes();    // must come after init_vcp_feature_codes()
    init_dyn_feature_files();
+   init_ddc_detection_cache();
    init_ddc_display_lock();
    init_ddc_displays();
    init_ddc_dumpload();
    init_ddc_output();
    init_ddc_packet_io();
    init_ddc_read_capabilities();
+   init_ddc_request_queue();
    init_ddc_multi_part_io();
    init_ddc_vcp();
+   init_ddc_vcp_value_cache();
    init_ddc_watch_displays();
 
    // dbgrpt_rtti_func_name_table(1);
    DBGMSF(debug, "Done");
 }
+
+
+/** Releases data cached by DDC services, at program or library termination.
+ */
+void release_ddc_services() {
+   clear_parsed_capabilities_cache();
+}
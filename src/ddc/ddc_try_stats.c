@@ -21,6 +21,7 @@
 #include "base/core.h"
 #include "base/ddc_errno.h"
 #include "base/parms.h"
+#include "base/per_display_data.h"
 #include "base/per_thread_data.h"    // for retry_type_name()
 #include "base/thread_retry_data.h"
 #include "base/thread_sleep_data.h"
@@ -305,20 +306,22 @@ static void record_failed_fatally2(Retry_Operation retry_type) {
 
 /** Records the status and retry count for a retryable transaction
  *
+ *  @param  dh    display handle
  *  @param  retry_type
  *  @param  ddcrc status code
  *  @param  tryct number of tries required for success, when rc == 0
  *
  *  @remark
- *  Also calls #trd_record_cur_thread_ties() to record the transaction status
- *  in the per-thread data structure.
+ *  Also calls #trd_record_cur_thread_ties() and #pdd_record_tries() to record
+ *  the transaction status in the per-thread and per-display data structures.
  */
-void try_data_record_tries2(Retry_Operation retry_type, DDCA_Status ddcrc, int tryct) {
+void try_data_record_tries2(Display_Handle * dh, Retry_Operation retry_type, DDCA_Status ddcrc, int tryct) {
    bool debug = false;
    DBGMSF(debug, "retry_type = %d - %s,  ddcrc=%d, tryct=%d",
                  retry_type, retry_type_name(retry_type), ddcrc, tryct);
 
    trd_record_cur_thread_tries(retry_type, ddcrc, tryct);
+   pdd_record_tries(dh, retry_type, ddcrc, tryct);
 
    Try_Data2 * stats_rec = &try_data[retry_type];
    bool locked_by_this_func = lock_if_unlocked();
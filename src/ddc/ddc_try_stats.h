@@ -2,7 +2,8 @@
  *
  *  Maintains statistics on DDC retries and also maxtries settings.
  *
- *  These statistics are global, not broken out by thread.
+ *  These statistics are global, not broken out by thread.  Tries are
+ *  also recorded per thread and per display.
  */
 
 // Copyright (C) 2014-2021 Sanford Rockowitz <rockowitz@minsoft.com>
@@ -16,6 +17,7 @@
 #include "ddcutil_types.h"
 
 #include "base/core.h"
+#include "base/displays.h"
 #include "base/parms.h"
 #include "base/per_thread_data.h"
 
@@ -27,7 +29,7 @@ Retry_Op_Value
          try_data_get_maxtries2(Retry_Operation retry_type);
 void     try_data_set_maxtries2(Retry_Operation retry_type, Retry_Op_Value new_maxtries);
 void     try_data_reset2_all();
-void     try_data_record_tries2(Retry_Operation retry_type, DDCA_Status rc, int tryct);
+void     try_data_record_tries2(Display_Handle * dh, Retry_Operation retry_type, DDCA_Status rc, int tryct);
 
 void     ddc_report_max_tries(int depth);
 void     ddc_report_ddc_stats(int depth);
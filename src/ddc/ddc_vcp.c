@@ -25,6 +25,7 @@
 #include "base/ddc_errno.h"
 #include "base/ddc_packets.h"
 #include "base/displays.h"
+#include "base/parms.h"
 #include "base/rtti.h"
 #include "base/status_code_mgt.h"
 
@@ -45,6 +46,7 @@
 
 #include "ddc/ddc_multi_part_io.h"
 #include "ddc/ddc_packet_io.h"
+#include "ddc/ddc_vcp_value_cache.h"
 #include "ddc/ddc_vcp_version.h"
 
 #include "ddc/ddc_vcp.h"
@@ -57,8 +59,15 @@ static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
 
 typedef struct {
    bool   verify_setvcp;
+   bool   defer_verify;
 } Thread_Vcp_Settings;
 
+static Deferred_Verify_Failure_Func deferred_verify_failure_func = NULL;
+
+// Guards Display_Handle.pending_verifies, which is updated both by the thread
+// using the handle and by the display's request executor thread
+static GMutex pending_verifies_mutex;
+
 static Thread_Vcp_Settings *  get_thread_vcp_settings() {
    static GPrivate per_thread_key = G_PRIVATE_INIT(g_free);
 
@@ -165,6 +174,8 @@ ddc_set_nontable_vcp_value(
       if (request_packet_ptr)
          free_ddc_packet(request_packet_ptr);
    }
+   // even a failed write may have changed the value
+   ddc_note_vcp_write(dh->dref, feature_code);
 
    if ( psc==DDCRC_RETRIES )
       DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Try errors: %s", errinfo_causes_string(ddc_excp));  // needed?
@@ -252,6 +263,42 @@ bool ddc_get_verify_setvcp() {
 }
 
 
+/** Sets whether setvcp verification is deferred for the current thread.
+ *
+ *  If deferred, and verification is enabled, setvcp returns once the value
+ *  has been written.  The value is verified later, together with other values
+ *  pending verification on the same display handle.  See #ddc_flush_deferred_verifies().
+ *
+ *  \param onoff  **true** to defer verification, **false** to verify immediately
+ *  \return prior setting
+ */
+bool ddc_set_deferred_verify(bool onoff) {
+   Thread_Vcp_Settings * settings = get_thread_vcp_settings();
+   bool old_value = settings->defer_verify;
+   settings->defer_verify = onoff;
+   return old_value;
+}
+
+
+/** Gets whether setvcp verification is deferred for the current thread.
+ *
+ *  \return **true** if verification is deferred, **false** if not
+ */
+bool ddc_get_deferred_verify() {
+   Thread_Vcp_Settings * settings = get_thread_vcp_settings();
+   return settings->defer_verify;
+}
+
+
+/** Sets the function called when a deferred verification fails.
+ *
+ *  \param func  function to call, NULL for none
+ */
+void ddc_set_deferred_verify_failure_func(Deferred_Verify_Failure_Func func) {
+   deferred_verify_failure_func = func;
+}
+
+
 static bool
 is_rereadable_feature(
       Display_Handle * dh,
@@ -345,6 +392,170 @@ single_vcp_value_equal(
 }
 
 
+/** Reads a feature value after it has been written, and checks that
+ *  the display has actually changed the value.
+ *
+ *  \param  dh                display handle for open display
+ *  \param  vrec              value written
+ *  \param  newval_loc        if non-null, address at which to return value read
+ *  \param  verbose_msg_dest  where to write verbose messages, NULL for none
+ *  \return NULL if success or the feature cannot be verified,
+ *          pointer to #Error_Info if failure
+ */
+static Error_Info *
+verify_vcp_value(
+      Display_Handle *      dh,
+      DDCA_Any_Vcp_Value *  vrec,
+      DDCA_Any_Vcp_Value ** newval_loc,
+      FILE *                verbose_msg_dest)
+{
+   Public_Status_Code psc = 0;
+   Error_Info * ddc_excp = NULL;
+   if ( is_rereadable_feature(dh, vrec->opcode) &&
+        ( vrec->value_type != DDCA_NON_TABLE_VCP_VALUE ||
+          !is_unreadable_sl_value(vrec->opcode, vrec->val.c_nc.sl)
+        )
+      )
+   {
+      f0printf(verbose_msg_dest, "Verifying that value of feature 0x%02x successfully set...\n", vrec->opcode);
+      DDCA_Any_Vcp_Value * newval = NULL;
+      ddc_excp = ddc_get_vcp_value(
+          dh,
+          vrec->opcode,
+          vrec->value_type,
+          &newval);
+      psc = (ddc_excp) ? ddc_excp->status_code : 0;
+      if (ddc_excp) {
+         f0printf(verbose_msg_dest, "(%s) Read after write failed. get_vcp_value() returned: %s\n",
+                        __func__, psc_desc(psc));
+         if (psc == DDCRC_RETRIES)
+            f0printf(verbose_msg_dest, "(%s)    Try errors: %s\n", __func__, errinfo_causes_string(ddc_excp));
+         // psc = DDCRC_VERIFY;
+      }
+      else {
+         assert(vrec && newval);    // silence clang complaint
+         // dbgrpt_ddca_single_vcp_value(vrec, 2);
+         // dbgrpt_ddca_single_vcp_value(newval, 3);
+
+         if (! single_vcp_value_equal(vrec,newval)) {
+            psc = DDCRC_VERIFY;
+            ddc_excp = errinfo_new(DDCRC_VERIFY, __func__);
+            f0printf(verbose_msg_dest, "Current value does not match value set.\n");
+         }
+         else {
+            f0printf(verbose_msg_dest, "Verification succeeded\n");
+         }
+         if (newval_loc)
+            *newval_loc = newval;
+         else
+            free_single_vcp_value(newval);
+      }
+   }
+   else {
+      if (!is_rereadable_feature(dh, vrec->opcode) )
+         f0printf(verbose_msg_dest, "Feature 0x%02x does not support verification\n", vrec->opcode);
+      else
+         f0printf(verbose_msg_dest, "Feature 0x%02x, value 0x%02x does not support verification\n",
+                                    vrec->opcode,
+                                    vrec->val.c_nc.sl);
+   }
+   return ddc_excp;
+}
+
+
+/** Verifies the values written using a display handle whose verification
+ *  has been deferred.
+ *
+ *  The values are read in sequence, with post-read sleeps deferred as for
+ *  #ddc_get_vcp_values().  For each value that does not verify, the function
+ *  set by #ddc_set_deferred_verify_failure_func() is called.
+ *
+ *  The pending values are taken from the handle before they are read, so
+ *  values written meanwhile by another thread remain pending.
+ *
+ *  \param  dh  display handle for open display
+ *  \return NULL if all values verified,\n
+ *          otherwise an #Error_Info with status DDCRC_VERIFY,
+ *          and the per-feature errors as causes
+ */
+Error_Info *
+ddc_flush_deferred_verifies(Display_Handle * dh) {
+   bool debug = false;
+   g_mutex_lock(&pending_verifies_mutex);
+   GPtrArray * pending = dh->pending_verifies;
+   if (pending)
+      dh->pending_verifies = g_ptr_array_new_with_free_func((GDestroyNotify) free_single_vcp_value);
+   g_mutex_unlock(&pending_verifies_mutex);
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dh=%s, pending ct=%d",
+                   dh_repr_t(dh), (pending) ? pending->len : 0);
+
+   Error_Info * master_excp = NULL;
+   if (pending && pending->len > 0) {
+      bool saved_defer_sleeps = dh->defer_sleeps;
+      dh->defer_sleeps = true;
+
+      for (int ndx = 0; ndx < pending->len; ndx++) {
+         DDCA_Any_Vcp_Value * vrec = g_ptr_array_index(pending, ndx);
+         DDCA_Any_Vcp_Value * newval = NULL;
+         Error_Info * cur_excp = verify_vcp_value(dh, vrec, &newval, NULL);
+         if (cur_excp) {
+            DBGTRC_NOPREFIX(debug, TRACE_GROUP, "feature 0x%02x: %s",
+                                                vrec->opcode, errinfo_summary(cur_excp));
+            if (deferred_verify_failure_func)
+               deferred_verify_failure_func(dh, cur_excp, vrec, newval);
+            if (!master_excp)
+               master_excp = errinfo_new(DDCRC_VERIFY, __func__);
+            errinfo_add_cause(master_excp, cur_excp);
+         }
+         if (newval)
+            free_single_vcp_value(newval);
+      }
+      dh->defer_sleeps = saved_defer_sleeps;
+   }
+   if (pending)
+      g_ptr_array_free(pending, true);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning: %s", errinfo_summary(master_excp));
+   return master_excp;
+}
+
+
+/** Records a value just written, for later verification.
+ *
+ *  A value pending verification for the same feature is replaced, since
+ *  only the latest value written can be read back.  When the number of
+ *  pending values reaches #DEFERRED_VERIFY_MAX_PENDING they are verified.
+ *
+ *  \param  dh    display handle for open display
+ *  \param  vrec  value written
+ *  \return result of #ddc_flush_deferred_verifies() if verification was
+ *          performed, NULL otherwise
+ */
+static Error_Info *
+defer_verify(Display_Handle * dh, DDCA_Any_Vcp_Value * vrec) {
+   g_mutex_lock(&pending_verifies_mutex);
+   if (!dh->pending_verifies)
+      dh->pending_verifies = g_ptr_array_new_with_free_func((GDestroyNotify) free_single_vcp_value);
+
+   int ndx = 0;
+   for (; ndx < dh->pending_verifies->len; ndx++) {
+      DDCA_Any_Vcp_Value * cur = g_ptr_array_index(dh->pending_verifies, ndx);
+      if (cur->opcode == vrec->opcode)
+         break;
+   }
+   if (ndx < dh->pending_verifies->len)
+      g_ptr_array_remove_index(dh->pending_verifies, ndx);
+   g_ptr_array_add(dh->pending_verifies, clone_single_vcp_value(vrec));
+   bool flush_needed = (dh->pending_verifies->len >= DEFERRED_VERIFY_MAX_PENDING);
+   g_mutex_unlock(&pending_verifies_mutex);
+
+   Error_Info * excp = NULL;
+   if (flush_needed)
+      excp = ddc_flush_deferred_verifies(dh);
+   return excp;
+}
+
+
 // TODO: Consider wrapping set_vcp_value() in set_vcp_value_with_retry(), which would
 // retry in case verification fails
 
@@ -356,7 +567,9 @@ single_vcp_value_equal(
  *  \return NULL if success, pointer to #Error_Info if failure
  *
  *  If write verification is turned on, reads the feature value after writing it
- *  to ensure the display has actually changed the value.
+ *  to ensure the display has actually changed the value.  If verification is
+ *  also deferred (see #ddc_set_deferred_verify()), the value is instead saved
+ *  for later verification, and no value is returned at **newval_loc**.
  *
  * The caller is responsible for freeing the value returned at **newval_loc**.
  *  \remark
@@ -390,54 +603,11 @@ ddc_set_vcp_value(
    }
 
    if (!ddc_excp && ddc_get_verify_setvcp()) {
-      if ( is_rereadable_feature(dh, vrec->opcode) &&
-           ( vrec->value_type != DDCA_NON_TABLE_VCP_VALUE ||
-             !is_unreadable_sl_value(vrec->opcode, vrec->val.c_nc.sl)
-           )
-         )
-      {
-         f0printf(verbose_msg_dest, "Verifying that value of feature 0x%02x successfully set...\n", vrec->opcode);
-         DDCA_Any_Vcp_Value * newval = NULL;
-         ddc_excp = ddc_get_vcp_value(
-             dh,
-             vrec->opcode,
-             vrec->value_type,
-             &newval);
-         psc = (ddc_excp) ? ddc_excp->status_code : 0;
-         if (ddc_excp) {
-            f0printf(verbose_msg_dest, "(%s) Read after write failed. get_vcp_value() returned: %s\n",
-                           __func__, psc_desc(psc));
-            if (psc == DDCRC_RETRIES)
-               f0printf(verbose_msg_dest, "(%s)    Try errors: %s\n", __func__, errinfo_causes_string(ddc_excp));
-            // psc = DDCRC_VERIFY;
-         }
-         else {
-            assert(vrec && newval);    // silence clang complaint
-            // dbgrpt_ddca_single_vcp_value(vrec, 2);
-            // dbgrpt_ddca_single_vcp_value(newval, 3);
-
-            if (! single_vcp_value_equal(vrec,newval)) {
-               psc = DDCRC_VERIFY;
-               ddc_excp = errinfo_new(DDCRC_VERIFY, __func__);
-               f0printf(verbose_msg_dest, "Current value does not match value set.\n");
-            }
-            else {
-               f0printf(verbose_msg_dest, "Verification succeeded\n");
-            }
-            if (newval_loc)
-               *newval_loc = newval;
-            else
-               free_single_vcp_value(newval);
-         }
-      }
-      else {
-         if (!is_rereadable_feature(dh, vrec->opcode) )
-            f0printf(verbose_msg_dest, "Feature 0x%02x does not support verification\n", vrec->opcode);
-         else
-            f0printf(verbose_msg_dest, "Feature 0x%02x, value 0x%02x does not support verification\n",
-                                       vrec->opcode,
-                                       vrec->val.c_nc.sl);
-      }
+      if (ddc_get_deferred_verify())
+         ddc_excp = defer_verify(dh, vrec);
+      else
+         ddc_excp = verify_vcp_value(dh, vrec, newval_loc, verbose_msg_dest);
+      psc = (ddc_excp) ? ddc_excp->status_code : 0;
    }
 
    DBGMSF(debug, "Returning: %s", psc_desc(psc));
@@ -546,6 +716,11 @@ ddc_get_nontable_vcp_value(
       return mock_errinfo;
    }
 
+   if (ddc_get_cached_vcp_value(dh->dref, feature_code, ppInterpretedCode)) {
+      DBGTRC_DONE(debug, TRACE_GROUP, "Returning cached value for feature x%02x", feature_code);
+      return NULL;
+   }
+
    DDC_Packet * request_packet_ptr  = NULL;
    DDC_Packet * response_packet_ptr = NULL;
    request_packet_ptr = create_ddc_getvcp_request_packet(
@@ -640,6 +815,7 @@ ddc_get_nontable_vcp_value(
       // errinfo_report(excp, 1);
    }
    else {
+      ddc_note_vcp_value(dh->dref, parsed_response);
       DBGTRC_DONE(debug, TRACE_GROUP, "Success reading feature x%02x. *ppinterpreted_code=%p",
                                       feature_code, parsed_response);
       DBGTRC_NOPREFIX(debug, TRACE_GROUP,
@@ -827,11 +1003,102 @@ ddc_get_vcp_value(
 }
 
 
+/** Gets the values of multiple VCP features as a single batch.
+ *
+ *  The display's I/O lock is held for the entire batch, so that operations
+ *  from other threads, e.g. queued requests performed by the display's
+ *  executor thread, cannot be interleaved with it.  The batch therefore
+ *  follows a single sleep schedule: rather than sleeping unconditionally
+ *  after each read, the time of the earliest permissible next operation is
+ *  recorded in the display reference (see #check_deferred_sleep()), and
+ *  the next read starts as soon as that time is reached, with response
+ *  interpretation overlapping the inter-command delay.  Any sleep still
+ *  pending when the batch ends is honored by the next operation.
+ *
+ *  A feature requested more than once is read only once.
+ *
+ * \param  dh              handle for open display
+ * \param  feature_ct      number of features
+ * \param  feature_codes   array of **feature_ct** feature codes
+ * \param  value_types     array of **feature_ct** value types
+ * \param  valrecs         array of **feature_ct** locations where values are returned,
+ *                         set to NULL for any feature whose read failed
+ * \param  statuses        if non-NULL, array of **feature_ct** per-feature status codes
+ * \return NULL if all features were read successfully,\n
+ *         otherwise an #Error_Info with status DDCRC_MULTI_FEATURE_ERROR,
+ *         and the per-feature errors as causes
+ *
+ * The caller is responsible for freeing the values returned in **valrecs**.
+ */
+Error_Info *
+ddc_get_vcp_values(
+       Display_Handle *       dh,
+       int                    feature_ct,
+       Byte *                 feature_codes,
+       DDCA_Vcp_Value_Type *  value_types,
+       DDCA_Any_Vcp_Value **  valrecs,
+       DDCA_Status *          statuses)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dh=%s, feature_ct=%d", dh_repr_t(dh), feature_ct);
+
+   Error_Info * master_excp = NULL;
+   DDCA_Status * batch_statuses = calloc(feature_ct+1, sizeof(DDCA_Status));
+
+   Display_Async_Rec * async_rec = dh->dref->async_rec;
+   bool display_locked = false;
+   if (async_rec && async_rec->thread_owning_display_lock != g_thread_self())
+      display_locked = lock_display_lock(async_rec, true);
+   bool saved_defer_sleeps = dh->defer_sleeps;
+   dh->defer_sleeps = true;
+
+   for (int ndx = 0; ndx < feature_ct; ndx++) {
+      int prior = -1;
+      for (int prior_ndx = 0; prior_ndx < ndx && prior < 0; prior_ndx++) {
+         if (feature_codes[prior_ndx] == feature_codes[ndx] &&
+             value_types[prior_ndx]   == value_types[ndx])
+            prior = prior_ndx;
+      }
+
+      Error_Info * cur_excp = NULL;
+      if (prior < 0) {
+         cur_excp = ddc_get_vcp_value(dh, feature_codes[ndx], value_types[ndx], &valrecs[ndx]);
+      }
+      else if (valrecs[prior]) {
+         valrecs[ndx] = clone_single_vcp_value(valrecs[prior]);
+      }
+      else {
+         valrecs[ndx] = NULL;
+         cur_excp = errinfo_new2(batch_statuses[prior], __func__,
+                                 "Feature 0x%02x already failed in this batch", feature_codes[ndx]);
+      }
+      batch_statuses[ndx] = ERRINFO_STATUS(cur_excp);
+      if (cur_excp) {
+         if (!master_excp)
+            master_excp = errinfo_new(DDCRC_MULTI_FEATURE_ERROR, __func__);
+         errinfo_add_cause(master_excp, cur_excp);
+      }
+   }
+
+   dh->defer_sleeps = saved_defer_sleeps;
+   if (display_locked)
+      unlock_display_lock(async_rec);
+
+   if (statuses)
+      memcpy(statuses, batch_statuses, feature_ct * sizeof(DDCA_Status));
+   free(batch_statuses);
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning: %s", errinfo_summary(master_excp));
+   return master_excp;
+}
+
+
 static void init_ddc_vcp_func_name_table() {
 #define ADD_FUNC(_NAME) rtti_func_name_table_add(_NAME, #_NAME);
    ADD_FUNC(ddc_get_nontable_vcp_value);
    ADD_FUNC(ddc_get_table_vcp_value);
    ADD_FUNC(ddc_get_vcp_value);
+   ADD_FUNC(ddc_get_vcp_values);
+   ADD_FUNC(ddc_flush_deferred_verifies);
 #undef ADD_FUNC
 }
 
@@ -29,6 +29,34 @@ ddc_set_verify_setvcp(
 bool
 ddc_get_verify_setvcp();
 
+/** Signature of function called when a deferred verification fails.
+ *
+ *  \param  dh        display handle
+ *  \param  excp      reason for failure
+ *  \param  expected  value written
+ *  \param  actual    value read, NULL if the read failed
+ */
+typedef void (*Deferred_Verify_Failure_Func)(
+      Display_Handle *          dh,
+      Error_Info *              excp,
+      DDCA_Any_Vcp_Value *      expected,
+      DDCA_Any_Vcp_Value *      actual);
+
+bool
+ddc_set_deferred_verify(
+      bool                      onoff);
+
+bool
+ddc_get_deferred_verify();
+
+void
+ddc_set_deferred_verify_failure_func(
+      Deferred_Verify_Failure_Func func);
+
+Error_Info *
+ddc_flush_deferred_verifies(
+      Display_Handle *          dh);
+
 Error_Info *
 ddc_save_current_settings(
       Display_Handle *          dh);
@@ -64,6 +92,15 @@ ddc_get_vcp_value(
        DDCA_Vcp_Value_Type      call_type,
        DDCA_Any_Vcp_Value **    valrec_loc);
 
+Error_Info *
+ddc_get_vcp_values(
+       Display_Handle *         dh,
+       int                      feature_ct,
+       Byte *                   feature_codes,
+       DDCA_Vcp_Value_Type *    value_types,
+       DDCA_Any_Vcp_Value **    valrecs,
+       DDCA_Status *            statuses);
+
 void
 init_ddc_vcp();
 
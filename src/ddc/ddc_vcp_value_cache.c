@@ -0,0 +1,284 @@
+/** \file ddc_vcp_value_cache.c
+ *
+ *  Optional per-display cache of non-table VCP feature values.
+ *
+ *  Whether and for how long a value is served from the cache depends on
+ *  the feature's volatility class, as declared in the VCP feature table
+ *  and optionally overridden by a user defined feature file:
+ *
+ *  - VCP_VOLATILITY_STATIC             cached for the life of the display reference
+ *  - VCP_VOLATILITY_WRITE_INVALIDATED  cached until the feature is written or
+ *                                      a change is reported using features x02/x52
+ *  - VCP_VOLATILITY_TTL                as above, but also expires after the TTL
+ *  - VCP_VOLATILITY_LIVE (or unset)    never cached
+ *
+ *  Writes of a feature by this process always invalidate its cached value.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/report_util.h"
+
+#include "base/core.h"
+#include "base/displays.h"
+#include "base/dynamic_features.h"
+#include "base/parms.h"
+#include "base/rtti.h"
+
+#include "vcp/vcp_feature_codes.h"
+
+#include "ddc/ddc_vcp_value_cache.h"
+
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
+
+/** Cached value of a single non-table feature */
+typedef struct Vcp_Value_Cache_Entry {
+   Parsed_Nontable_Vcp_Response  value;
+   gint64                        read_time;     // monotonic microseconds, 0 if not cached
+} Vcp_Value_Cache_Entry;
+
+static bool    vcp_value_cache_enabled = DEFAULT_ENABLE_VCP_VALUE_CACHE;
+static int     vcp_value_cache_ttl_millis = DEFAULT_VCP_VALUE_CACHE_TTL_MILLIS;
+static GMutex  vcp_value_cache_mutex;
+
+
+/** Enables or disables the VCP value cache.
+ *
+ *  \param  onoff  true to enable, false to disable
+ *  \return prior setting
+ */
+bool enable_vcp_value_cache(bool onoff) {
+   bool old = vcp_value_cache_enabled;
+   vcp_value_cache_enabled = onoff;
+   return old;
+}
+
+
+/** Reports whether the VCP value cache is enabled.
+ *
+ *  \return true if enabled, false if not
+ */
+bool is_vcp_value_cache_enabled() {
+   return vcp_value_cache_enabled;
+}
+
+
+/** Sets the time for which values of VCP_VOLATILITY_TTL features remain valid.
+ *
+ *  \param  millisec  lifetime in milliseconds
+ */
+void set_vcp_value_cache_ttl(int millisec) {
+   assert(millisec >= 0);
+   vcp_value_cache_ttl_millis = millisec;
+}
+
+
+/** Returns the time for which values of VCP_VOLATILITY_TTL features remain valid.
+ *
+ *  \return lifetime in milliseconds
+ */
+int get_vcp_value_cache_ttl() {
+   return vcp_value_cache_ttl_millis;
+}
+
+
+/** Returns the volatility class of a feature for a display.
+ *
+ *  A class specified in a user defined feature file takes precedence
+ *  over the class in the VCP feature table.
+ *
+ *  \param  dref          display reference
+ *  \param  feature_code  VCP feature code
+ *  \return volatility class, never VCP_VOLATILITY_UNSET
+ */
+Vcp_Volatility
+ddc_get_feature_volatility(Display_Ref * dref, DDCA_Vcp_Feature_Code feature_code) {
+   Vcp_Volatility result = get_dynamic_feature_volatility(dref->dfr, feature_code);
+   if (result == VCP_VOLATILITY_UNSET) {
+      VCP_Feature_Table_Entry * vfte = vcp_find_feature_by_hexid(feature_code);
+      if (vfte)
+         result = vfte->volatility;
+   }
+   if (result == VCP_VOLATILITY_UNSET)
+      result = VCP_VOLATILITY_LIVE;
+   return result;
+}
+
+
+// must be called with vcp_value_cache_mutex held
+static bool is_entry_valid(
+      Display_Ref *           dref,
+      Vcp_Value_Cache_Entry * entry,
+      DDCA_Vcp_Feature_Code   feature_code)
+{
+   if (!entry->read_time)
+      return false;
+   switch(ddc_get_feature_volatility(dref, feature_code)) {
+   case VCP_VOLATILITY_STATIC:
+   case VCP_VOLATILITY_WRITE_INVALIDATED:
+      return true;
+   case VCP_VOLATILITY_TTL:
+      return (g_get_monotonic_time() - entry->read_time) < vcp_value_cache_ttl_millis * (gint64) 1000;
+   default:
+      return false;
+   }
+}
+
+
+/** Looks up a feature value in the cache.
+ *
+ *  \param  dref          display reference
+ *  \param  feature_code  VCP feature code
+ *  \param  response_loc  where to return a newly allocated copy of the value
+ *  \return true if a valid cached value was found, false if not
+ */
+bool
+ddc_get_cached_vcp_value(
+      Display_Ref *                   dref,
+      DDCA_Vcp_Feature_Code           feature_code,
+      Parsed_Nontable_Vcp_Response ** response_loc)
+{
+   bool debug = false;
+   bool found = false;
+   *response_loc = NULL;
+   if (vcp_value_cache_enabled) {
+      g_mutex_lock(&vcp_value_cache_mutex);
+      if (dref->vcp_value_cache) {
+         Vcp_Value_Cache_Entry * entry = &dref->vcp_value_cache[feature_code];
+         if (is_entry_valid(dref, entry, feature_code)) {
+            *response_loc = malloc(sizeof(Parsed_Nontable_Vcp_Response));
+            memcpy(*response_loc, &entry->value, sizeof(Parsed_Nontable_Vcp_Response));
+            found = true;
+         }
+      }
+      g_mutex_unlock(&vcp_value_cache_mutex);
+   }
+   DBGTRC(debug, TRACE_GROUP, "dref=%s, feature_code=0x%02x, returning %s",
+                              dref_repr_t(dref), feature_code, sbool(found));
+   return found;
+}
+
+
+// must be called with vcp_value_cache_mutex held
+static void invalidate_all(Display_Ref * dref, bool include_static) {
+   if (dref->vcp_value_cache) {
+      for (int code = 0; code < 256; code++) {
+         if (include_static ||
+             ddc_get_feature_volatility(dref, code) != VCP_VOLATILITY_STATIC)
+            dref->vcp_value_cache[code].read_time = 0;
+      }
+   }
+}
+
+
+/** Records a value read from a display.
+ *
+ *  The value is saved if its feature's volatility class permits.
+ *  Change notifications reported by features x02 (New Control Value) and
+ *  x52 (Active Control) invalidate the affected cached values.
+ *
+ *  \param  dref      display reference
+ *  \param  response  value read
+ */
+void
+ddc_note_vcp_value(
+      Display_Ref *                  dref,
+      Parsed_Nontable_Vcp_Response * response)
+{
+   bool debug = false;
+   if (!vcp_value_cache_enabled)
+      return;
+   DDCA_Vcp_Feature_Code feature_code = response->vcp_code;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dref=%s, feature_code=0x%02x", dref_repr_t(dref), feature_code);
+
+   Vcp_Volatility volatility = ddc_get_feature_volatility(dref, feature_code);
+   g_mutex_lock(&vcp_value_cache_mutex);
+   if (feature_code == 0x52 && response->sl != 0x00) {
+      // Active Control: sl is the feature code of a changed control
+      if (dref->vcp_value_cache)
+         dref->vcp_value_cache[response->sl].read_time = 0;
+   }
+   else if (feature_code == 0x02 && response->sl == 0x02) {
+      // New Control Value: new control values are present
+      invalidate_all(dref, false);
+   }
+
+   if (volatility != VCP_VOLATILITY_LIVE) {
+      if (!dref->vcp_value_cache)
+         dref->vcp_value_cache = calloc(256, sizeof(Vcp_Value_Cache_Entry));
+      Vcp_Value_Cache_Entry * entry = &dref->vcp_value_cache[feature_code];
+      memcpy(&entry->value, response, sizeof(Parsed_Nontable_Vcp_Response));
+      entry->read_time = g_get_monotonic_time();
+   }
+   g_mutex_unlock(&vcp_value_cache_mutex);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "volatility=%s", vcp_volatility_name(volatility));
+}
+
+
+/** Discards the cached value of a feature, e.g. because it has been written.
+ *
+ *  \param  dref          display reference
+ *  \param  feature_code  VCP feature code
+ */
+void
+ddc_invalidate_cached_vcp_value(Display_Ref * dref, DDCA_Vcp_Feature_Code feature_code) {
+   g_mutex_lock(&vcp_value_cache_mutex);
+   if (dref->vcp_value_cache)
+      dref->vcp_value_cache[feature_code].read_time = 0;
+   g_mutex_unlock(&vcp_value_cache_mutex);
+}
+
+
+/** Discards cached values affected by writing a feature.
+ *
+ *  Writing one of the restore defaults features, or restoring saved
+ *  settings, can change any value.
+ *
+ *  \param  dref          display reference
+ *  \param  feature_code  VCP feature code written
+ */
+void
+ddc_note_vcp_write(Display_Ref * dref, DDCA_Vcp_Feature_Code feature_code) {
+   g_mutex_lock(&vcp_value_cache_mutex);
+   switch(feature_code) {
+   case 0x04:      // Restore factory defaults
+   case 0x05:      // Restore factory brightness/contrast defaults
+   case 0x06:      // Restore factory geometry defaults
+   case 0x08:      // Restore color defaults
+   case 0x0a:      // Restore factory TV defaults
+   case 0xb0:      // Settings, store/restore
+      invalidate_all(dref, false);
+      break;
+   default:
+      if (dref->vcp_value_cache)
+         dref->vcp_value_cache[feature_code].read_time = 0;
+   }
+   g_mutex_unlock(&vcp_value_cache_mutex);
+}
+
+
+/** Discards all cached values for a display.
+ *
+ *  \param  dref            display reference
+ *  \param  include_static  if false, values of VCP_VOLATILITY_STATIC features are kept
+ */
+void
+ddc_invalidate_cached_vcp_values(Display_Ref * dref, bool include_static) {
+   g_mutex_lock(&vcp_value_cache_mutex);
+   invalidate_all(dref, include_static);
+   g_mutex_unlock(&vcp_value_cache_mutex);
+}
+
+
+void init_ddc_vcp_value_cache() {
+   RTTI_ADD_FUNC(ddc_get_cached_vcp_value);
+   RTTI_ADD_FUNC(ddc_note_vcp_value);
+}
@@ -0,0 +1,30 @@
+/** \file ddc_vcp_value_cache.h */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_VCP_VALUE_CACHE_H_
+#define DDC_VCP_VALUE_CACHE_H_
+
+#include <stdbool.h>
+
+#include "public/ddcutil_types.h"
+
+#include "base/ddc_packets.h"
+#include "base/displays.h"
+#include "base/feature_metadata.h"
+
+bool           enable_vcp_value_cache(bool onoff);
+bool           is_vcp_value_cache_enabled();
+void           set_vcp_value_cache_ttl(int millisec);
+int            get_vcp_value_cache_ttl();
+Vcp_Volatility ddc_get_feature_volatility(Display_Ref * dref, DDCA_Vcp_Feature_Code feature_code);
+bool           ddc_get_cached_vcp_value(Display_Ref * dref, DDCA_Vcp_Feature_Code feature_code,
+                                        Parsed_Nontable_Vcp_Response ** response_loc);
+void           ddc_note_vcp_value(Display_Ref * dref, Parsed_Nontable_Vcp_Response * response);
+void           ddc_note_vcp_write(Display_Ref * dref, DDCA_Vcp_Feature_Code feature_code);
+void           ddc_invalidate_cached_vcp_value(Display_Ref * dref, DDCA_Vcp_Feature_Code feature_code);
+void           ddc_invalidate_cached_vcp_values(Display_Ref * dref, bool include_static);
+void           init_ddc_vcp_value_cache();
+
+#endif /* DDC_VCP_VALUE_CACHE_H_ */
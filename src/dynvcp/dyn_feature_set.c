@@ -406,6 +406,31 @@ void dyn_free_feature_set(
 }
 
 
+/** Removes the members of a feature set for which the filter function
+ *  returns false.
+ *
+ *  \param fset  feature set
+ *  \param func  filter function
+ */
+void
+filter_feature_set2(
+      Dyn_Feature_Set *            fset,
+      Dyn_Feature_Set_Filter_Func  func)
+{
+   bool debug = false;
+   assert( fset && memcmp(fset->marker, DYN_FEATURE_SET_MARKER, 4) == 0);
+
+   for (int ndx = fset->members_dfm->len -1; ndx >= 0; ndx--) {
+      Display_Feature_Metadata * dfm = g_ptr_array_index(fset->members_dfm, ndx);
+      if (!func(dfm)) {
+         DBGMSF(debug, "Removing feature 0x%02x", dfm->feature_code);
+         g_ptr_array_remove_index(fset->members_dfm, ndx);
+         dfm_free(dfm);
+      }
+   }
+}
+
+
 // or, take DDCA_Feature_List address as parm
 DDCA_Feature_List
 feature_list_from_dyn_feature_set(Dyn_Feature_Set * fset)
@@ -48,6 +48,7 @@
 #include "base/status_code_mgt.h"
 #include "base/tuned_sleep.h"
 #include "base/per_thread_data.h"
+#include "base/worker_pool.h"
 
 #ifdef TARGET_BSD
 #include "bsd/i2c-dev.h"
@@ -665,6 +666,47 @@ i2c_get_parsed_edid_by_fd(int fd, Parsed_Edid ** edid_ptr_loc)
 }
 
 
+/** Returns a parsed EDID record for the monitor on an I2C bus, using the
+ *  EDID exposed by the corresponding DRM connector in sysfs.  No I2C
+ *  traffic is required.
+ *
+ * @param busno        I2C bus number
+ * @param edid_ptr_loc where to return pointer to newly allocated #Parsed_Edid,
+ *                     or NULL if error
+ *
+ * @retval  0                  success
+ * @retval  -ENOENT            bus has no DRM connector or connector has no EDID
+ * @retval  DDCRC_INVALID_EDID EDID failed header or checksum validation
+ */
+static Status_Errno_DDC
+i2c_get_parsed_edid_by_sysfs(int busno, Parsed_Edid ** edid_ptr_loc)
+{
+   bool debug  = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "busno=%d", busno);
+   Status_Errno_DDC rc = -ENOENT;
+   *edid_ptr_loc = NULL;
+
+   char * connector = find_sysfs_drm_connector_name(busno);
+   if (connector) {
+      GByteArray * edid_bytes = get_sysfs_drm_connector_edid(connector);
+      if (edid_bytes && edid_bytes->len > 0) {
+         if (is_valid_raw_edid(edid_bytes->data, edid_bytes->len)) {
+            *edid_ptr_loc = create_parsed_edid(edid_bytes->data);
+            rc = (*edid_ptr_loc) ? 0 : DDCRC_INVALID_EDID;
+         }
+         else
+            rc = DDCRC_INVALID_EDID;
+      }
+      if (edid_bytes)
+         g_byte_array_free(edid_bytes, true);
+   }
+
+   DBGTRC_RETURNING(debug, TRACE_GROUP, rc, "connector=%s", connector);
+   free(connector);
+   return rc;
+}
+
+
 //
 // I2C Bus Inspection - Fill in and report Bus_Info
 
@@ -771,9 +813,21 @@ void i2c_check_bus(I2C_Bus_Info * bus_info) {
 
           bus_info->functionality = i2c_get_functionality_flags_by_fd(fd);
 
-          DDCA_Status ddcrc = i2c_get_parsed_edid_by_fd(fd, &bus_info->edid);
-          DBGMSF(debug, "i2c_get_parsed_edid_by_fd() returned %s", psc_desc(ddcrc));
+          // prefer the EDID exposed by the DRM connector, fall back to reading it over I2C
+          DDCA_Status ddcrc = -ENOENT;
+          if (EDID_Read_Uses_Sysfs) {
+             ddcrc = i2c_get_parsed_edid_by_sysfs(bus_info->busno, &bus_info->edid);
+             DBGMSF(debug, "i2c_get_parsed_edid_by_sysfs() returned %s", psc_desc(ddcrc));
+             if (ddcrc == 0)
+                bus_info->flags |= I2C_BUS_SYSFS_EDID;
+          }
+          if (ddcrc != 0) {
+             ddcrc = i2c_get_parsed_edid_by_fd(fd, &bus_info->edid);
+             DBGMSF(debug, "i2c_get_parsed_edid_by_fd() returned %s", psc_desc(ddcrc));
+          }
           if (ddcrc == 0) {
+             // If the EDID came from sysfs, address 0x50 was not probed.  The
+             // DRM connector read it over this bus, so its presence is inferred.
              bus_info->flags |= I2C_BUS_ADDR_0X50;
              if ( IS_EDP_DEVICE(bus_info->busno) ) {
                 DBGMSF(debug, "eDP device detected");
@@ -854,8 +908,10 @@ void i2c_dbgrpt_bus_info(I2C_Bus_Info * bus_info, int depth) {
       rpt_vstring(depth, "Address 0x30 present:    %s", sbool(bus_info->flags & I2C_BUS_ADDR_0X30));
 #endif
       rpt_vstring(depth, "Address 0x37 present:    %s", sbool(bus_info->flags & I2C_BUS_ADDR_0X37));
-      rpt_vstring(depth, "Address 0x50 present:    %s", sbool(bus_info->flags & I2C_BUS_ADDR_0X50));
+      rpt_vstring(depth, "Address 0x50 present:    %s%s", sbool(bus_info->flags & I2C_BUS_ADDR_0X50),
+                         (bus_info->flags & I2C_BUS_SYSFS_EDID) ? " (inferred, EDID read from sysfs)" : "");
       rpt_vstring(depth, "Device busy:             %s", sbool(bus_info->flags & I2C_BUS_BUSY));
+      rpt_vstring(depth, "EDID read from sysfs:    %s", sbool(bus_info->flags & I2C_BUS_SYSFS_EDID));
       // not useful and clutters the output
       // i2c_report_functionality_flags(bus_info->functionality, /* maxline */ 90, depth);
       if ( bus_info->flags & I2C_BUS_ADDR_0X50) {
@@ -904,7 +960,8 @@ void i2c_report_active_display(I2C_Bus_Info * businfo, int depth) {
       rpt_vstring(depth+1, "I2C address 0x30 (EDID block#)  present: %-5s", srepr(businfo->flags & I2C_BUS_ADDR_0X30));
       rpt_vstring(depth+1, "I2C address 0x37 (DDC)          present: %-5s", srepr(businfo->flags & I2C_BUS_ADDR_0X37));
 #endif
-      rpt_vstring(depth+1, "I2C address 0x50 (EDID) responsive: %-5s", sbool(businfo->flags & I2C_BUS_ADDR_0X50));
+      rpt_vstring(depth+1, "I2C address 0x50 (EDID) responsive: %-5s%s", sbool(businfo->flags & I2C_BUS_ADDR_0X50),
+                           (businfo->flags & I2C_BUS_SYSFS_EDID) ? " (inferred, EDID read from sysfs)" : "");
       rpt_vstring(depth+1, "Is eDP device:                      %-5s", sbool(businfo->flags & I2C_BUS_EDP));
       rpt_vstring(depth+1, "Is LVDS device:                     %-5s", sbool(businfo->flags & I2C_BUS_LVDS));
 
@@ -1016,6 +1073,19 @@ Byte_Value_Array get_i2c_devices_by_existence_test() {
 }
 
 
+static void pooled_check_bus(gpointer data, gpointer arg) {
+   i2c_check_bus(data);
+}
+
+
+/** Detects all I2C buses and probes them for a monitor.
+ *
+ *  Buses are probed independently (open, EDID read, slave address x37 check)
+ *  using the worker pool, so that elapsed time approaches that of the slowest
+ *  bus rather than the sum of all buses.
+ *
+ *  @return number of buses detected
+ */
 int i2c_detect_buses() {
    bool debug = false;
    DBGTRC_STARTING(debug, DDCA_TRC_I2C, "i2c_buses = %p", i2c_buses);
@@ -1030,16 +1100,19 @@ int i2c_detect_buses() {
       g_ptr_array_set_free_func(i2c_buses, i2c_free_bus_info_gdestroy);
       for (int ndx = 0; ndx < bva_length(i2c_bus_bva); ndx++) {
          int busno = bva_get(i2c_bus_bva, ndx);
-         DBGMSF(debug, "Checking busno = %d", busno);
+         DBGMSF(debug, "Valid bus: /dev/"I2C"-%d", busno);
          I2C_Bus_Info * businfo = i2c_new_bus_info(busno);
          businfo->flags = I2C_BUS_EXISTS | I2C_BUS_VALID_NAME_CHECKED | I2C_BUS_HAS_VALID_NAME;
-         i2c_check_bus(businfo);
-         if (debug || IS_TRACING() )
-            i2c_dbgrpt_bus_info(businfo, 0);
-         DBGMSF(debug, "Valid bus: /dev/"I2C"-%d", busno);
          g_ptr_array_add(i2c_buses, businfo);
       }
       bva_free(i2c_bus_bva);
+
+      // probe buses concurrently, order of i2c_buses is unchanged
+      run_in_worker_pool(i2c_buses, pooled_check_bus, NULL);
+      if (debug || IS_TRACING() ) {
+         for (int ndx = 0; ndx < i2c_buses->len; ndx++)
+            i2c_dbgrpt_bus_info(g_ptr_array_index(i2c_buses, ndx), 0);
+      }
    }
    int result = i2c_buses->len;
    DBGTRC_DONE(debug, DDCA_TRC_I2C, "Returning: %d", result);
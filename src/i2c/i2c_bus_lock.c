@@ -0,0 +1,258 @@
+/** \file i2c_bus_lock.c
+ *
+ *  Advisory locks on I2C buses shared by all ddcutil processes of a user.
+ *
+ *  Locking of displays in ddc_display_lock.c serializes threads within
+ *  a single process.  Without coordination, two processes addressing the
+ *  same bus interleave packets, and both fall into retry loops.  For the
+ *  duration of each DDC transaction, i.e. a write and its response read
+ *  including the sleeps that follow them, the process holds an exclusive
+ *  flock() lock on file i2c-<busno>.lock in $XDG_RUNTIME_DIR/ddcutil, or if
+ *  XDG_RUNTIME_DIR is not set in /tmp/ddcutil-<uid>.  The lock file is kept
+ *  open while the display is open.  Lock files are used only if their
+ *  directory is owned by the current user and not accessible by others.
+ *
+ *  The lock file also contains a small record of when the bus was last used,
+ *  and the time before which it should not be used again, i.e. any deferred
+ *  sleep still pending when the previous transaction completed.  A process
+ *  that finds a valid record need only wait for the remainder of that
+ *  interval, rather than assuming the bus was just used.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/** \cond */
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <glib-2.0/glib.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include "util/file_util.h"
+#include "util/report_util.h"
+#include "util/timestamp.h"
+/** \endcond */
+
+#include "public/ddcutil_status_codes.h"
+
+#include "base/core.h"
+#include "base/parms.h"
+#include "base/rtti.h"
+
+#include "i2c/i2c_bus_lock.h"
+
+// Default trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_I2C;
+
+#define I2C_BUS_LOCK_RECORD_MARKER 0x4b4c4249   // "IBLK"
+
+/** Record kept at the start of each lock file */
+typedef struct {
+   uint32_t  marker;
+   uint64_t  last_io_finish;   // realtime clock, nanosec
+   uint64_t  next_io_after;    // realtime clock, nanosec
+} I2C_Bus_Lock_Record;
+
+static bool i2c_bus_locks_enabled = DEFAULT_ENABLE_I2C_BUS_LOCKS;
+
+
+/** Enables or disables cross-process bus locks.
+ *
+ *  \param  onoff  true to enable, false to disable
+ *  \return prior setting
+ */
+bool enable_i2c_bus_locks(bool onoff) {
+   bool old = i2c_bus_locks_enabled;
+   i2c_bus_locks_enabled = onoff;
+   return old;
+}
+
+
+/** Reports whether cross-process bus locks are enabled.
+ *
+ *  \return true if enabled, false if not
+ */
+bool is_i2c_bus_locks_enabled() {
+   return i2c_bus_locks_enabled;
+}
+
+
+/** Returns the name of the directory containing the bus lock files.
+ *
+ *  \return directory name, caller must free
+ */
+static char * i2c_bus_lock_dir_name() {
+   char * result = NULL;
+   const char * runtime_dir = getenv("XDG_RUNTIME_DIR");
+   if (runtime_dir && strlen(runtime_dir) > 0)
+      result = g_strdup_printf("%s/ddcutil", runtime_dir);
+   else
+      result = g_strdup_printf("/tmp/ddcutil-%d", (int) getuid());
+   return result;
+}
+
+
+/** Returns the name of the lock file for an I2C bus.
+ *
+ *  \param  busno  I2C bus number
+ *  \return fully qualified file name, caller must free
+ */
+char * i2c_bus_lock_file_name(int busno) {
+   char * dir = i2c_bus_lock_dir_name();
+   char * result = g_strdup_printf("%s/i2c-%d.lock", dir, busno);
+   free(dir);
+   return result;
+}
+
+
+/** Opens the lock file for an I2C bus, creating it if necessary.
+ *  The lock is not acquired.
+ *
+ *  \param  busno  I2C bus number
+ *  \return file descriptor of the lock file,
+ *          -EPERM if the lock file directory is not private to the current user,
+ *          -errno if other error
+ */
+int i2c_open_bus_lock(int busno) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "busno=%d", busno);
+
+   int lockfd = 0;
+   char * dir = i2c_bus_lock_dir_name();
+   char * fn  = i2c_bus_lock_file_name(busno);
+   int rc = private_directory_check(dir, true, (debug) ? ferr() : NULL);
+   if (rc < 0) {
+      lockfd = rc;
+   }
+   else {
+      lockfd = open(fn, O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0600);
+      if (lockfd < 0) {
+         lockfd = -errno;
+         DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Error opening %s: %s", fn, strerror(errno));
+      }
+   }
+   free(fn);
+   free(dir);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %d", lockfd);
+   return lockfd;
+}
+
+
+/** Closes a lock file opened by #i2c_open_bus_lock().
+ *
+ *  \param  lockfd  file descriptor of the lock file
+ */
+void i2c_close_bus_lock(int lockfd) {
+   if (lockfd >= 0)
+      close(lockfd);
+}
+
+
+/** Acquires the cross-process lock for an I2C bus.
+ *
+ *  \param  lockfd             file descriptor returned by #i2c_open_bus_lock()
+ *  \param  timeout_millis     maximum wait in milliseconds, < 0 to wait indefinitely
+ *  \param  next_io_after_loc  where to return the time (realtime clock, nanosec)
+ *                             before which the bus should not be used,
+ *                             0 if not known
+ *  \return 0 if success,
+ *          DDCRC_LOCKED if the lock is held by another process,
+ *          -errno if the lock cannot be acquired
+ *
+ *  \remark
+ *  The time is not known if the bus has not been used since the lock file
+ *  was created.
+ */
+int i2c_lock_bus(int lockfd, int timeout_millis, uint64_t * next_io_after_loc) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "lockfd=%d, timeout_millis=%d", lockfd, timeout_millis);
+   assert(lockfd >= 0);
+
+   *next_io_after_loc = 0;
+   int rc = 0;
+   if (timeout_millis < 0) {
+      while ( (rc = flock(lockfd, LOCK_EX)) < 0 && errno == EINTR )
+         ;
+   }
+   else {
+      // poll, since flock() has no timeout
+      int waited_millis = 0;
+      while ( (rc = flock(lockfd, LOCK_EX | LOCK_NB)) < 0 &&
+              (errno == EWOULDBLOCK || errno == EINTR) &&
+              waited_millis < timeout_millis )
+      {
+         usleep(10*1000);
+         waited_millis += 10;
+      }
+   }
+   if (rc < 0) {
+      rc = (errno == EWOULDBLOCK) ? DDCRC_LOCKED : -errno;
+   }
+   else {
+      I2C_Bus_Lock_Record rec;
+      if (pread(lockfd, &rec, sizeof(rec), 0) == sizeof(rec) &&
+          rec.marker == I2C_BUS_LOCK_RECORD_MARKER)
+      {
+         DBGTRC_NOPREFIX(debug, TRACE_GROUP,
+               "last_io_finish=%"PRIu64", next_io_after=%"PRIu64" (millisec)",
+               rec.last_io_finish/(1000*1000), rec.next_io_after/(1000*1000));
+         *next_io_after_loc = MAX(rec.last_io_finish, rec.next_io_after);
+      }
+   }
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Returning %d, *next_io_after_loc=%"PRIu64,
+                                   rc, *next_io_after_loc);
+   return rc;
+}
+
+
+/** Releases the lock acquired by #i2c_lock_bus() without updating the
+ *  record of when the bus was last used, e.g. because no I/O was performed.
+ *
+ *  \param  lockfd  file descriptor returned by #i2c_open_bus_lock()
+ */
+void i2c_release_bus(int lockfd) {
+   assert(lockfd >= 0);
+   flock(lockfd, LOCK_UN);
+}
+
+
+/** Records when the bus was last used and releases the lock acquired by
+ *  #i2c_lock_bus().
+ *
+ *  \param  lockfd          file descriptor returned by #i2c_open_bus_lock()
+ *  \param  last_io_finish  time the last I/O operation completed (realtime clock, nanosec)
+ *  \param  next_io_after   time before which the bus should not be used (realtime clock, nanosec)
+ */
+void i2c_unlock_bus(int lockfd, uint64_t last_io_finish, uint64_t next_io_after) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "lockfd=%d, last_io_finish=%"PRIu64", next_io_after=%"PRIu64,
+                                       lockfd, last_io_finish, next_io_after);
+   assert(lockfd >= 0);
+
+   I2C_Bus_Lock_Record rec;
+   memset(&rec, 0, sizeof(rec));    // no uninitialized padding in the file
+   rec.marker         = I2C_BUS_LOCK_RECORD_MARKER;
+   rec.last_io_finish = last_io_finish;
+   rec.next_io_after  = next_io_after;
+   if (pwrite(lockfd, &rec, sizeof(rec), 0) != sizeof(rec))
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Error writing lock file: %s", strerror(errno));
+   flock(lockfd, LOCK_UN);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+void init_i2c_bus_lock() {
+   RTTI_ADD_FUNC(i2c_open_bus_lock);
+   RTTI_ADD_FUNC(i2c_lock_bus);
+   RTTI_ADD_FUNC(i2c_unlock_bus);
+}
@@ -0,0 +1,25 @@
+/** \file i2c_bus_lock.h
+ *
+ *  Advisory locks on I2C buses shared by all ddcutil processes of a user
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef I2C_BUS_LOCK_H_
+#define I2C_BUS_LOCK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+bool   enable_i2c_bus_locks(bool onoff);
+bool   is_i2c_bus_locks_enabled();
+char * i2c_bus_lock_file_name(int busno);
+int    i2c_open_bus_lock(int busno);
+void   i2c_close_bus_lock(int lockfd);
+int    i2c_lock_bus(int lockfd, int timeout_millis, uint64_t * next_io_after_loc);
+void   i2c_release_bus(int lockfd);
+void   i2c_unlock_bus(int lockfd, uint64_t last_io_finish, uint64_t next_io_after);
+void   init_i2c_bus_lock();
+
+#endif /* I2C_BUS_LOCK_H_ */
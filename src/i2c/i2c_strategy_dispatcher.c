@@ -26,6 +26,7 @@ bool EDID_Write_Before_Read          = DEFAULT_EDID_WRITE_BEFORE_READ;
 bool I2C_Read_Bytewise               = DEFAULT_I2C_READ_BYTEWISE;
 bool EDID_Read_Bytewise              = DEFAULT_EDID_READ_BYTEWISE;
 int  EDID_Read_Size                  = DEFAULT_EDID_READ_SIZE;
+bool EDID_Read_Uses_Sysfs            = DEFAULT_EDID_READ_USES_SYSFS;
 
 
 
@@ -40,6 +40,7 @@ extern bool EDID_Read_Uses_I2C_Layer;
 extern bool EDID_Read_Bytewise;
 extern bool EDID_Write_Before_Read;
 extern int  EDID_Read_Size;
+extern bool EDID_Read_Uses_Sysfs;
 
 
 Status_Errno_DDC
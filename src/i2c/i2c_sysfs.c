@@ -11,6 +11,7 @@
 
 /** \cond */
 #include <assert.h>
+#include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <glib-2.0/glib.h>
@@ -444,3 +445,71 @@ void dbgrpt_sys_bus_i2c(int depth) {
    dir_ordered_foreach("/sys/bus/i2c/devices", NULL, i2c_compare, report_one_bus_i2c, NULL, depth);
 }
 
+
+/** Finds the DRM connector whose DDC channel is a given I2C bus.
+ *
+ *  For DisplayPort connectors the I2C device is a child of the connector
+ *  node.  For other connectors it is reached through the connector's
+ *  ddc link.
+ *
+ *  \param  busno  I2C bus number
+ *  \return connector name, e.g. card0-DP-1, NULL if not found
+ *
+ *  \remark
+ *  Caller is responsible for freeing the returned value.
+ */
+char * find_sysfs_drm_connector_name(int busno) {
+   bool debug = false;
+   char * result = NULL;
+   DIR * dir = opendir("/sys/class/drm");
+   if (dir) {
+      struct dirent * dent;
+      while (!result && (dent = readdir(dir))) {
+         if (!str_starts_with(dent->d_name, "card") || !strchr(dent->d_name, '-'))
+            continue;
+         char path[PATH_MAX];
+         g_snprintf(path, PATH_MAX, "/sys/class/drm/%s/i2c-%d", dent->d_name, busno);
+         if (directory_exists(path))
+            result = strdup(dent->d_name);
+         else {
+            g_snprintf(path, PATH_MAX, "/sys/class/drm/%s/ddc/i2c-dev/i2c-%d", dent->d_name, busno);
+            if (directory_exists(path))
+               result = strdup(dent->d_name);
+         }
+      }
+      closedir(dir);
+   }
+   DBGMSF(debug, "busno=%d, returning %s", busno, result);
+   return result;
+}
+
+
+/** Reads the EDID exposed by a DRM connector.
+ *
+ *  \param  connector_name  e.g. card0-DP-1
+ *  \return EDID bytes, NULL if unavailable. The array is empty if no
+ *          monitor is connected.
+ *
+ *  \remark
+ *  Caller is responsible for freeing the returned value.
+ */
+GByteArray * get_sysfs_drm_connector_edid(const char * connector_name) {
+   char path[PATH_MAX];
+   g_snprintf(path, PATH_MAX, "/sys/class/drm/%s", connector_name);
+   return read_binary_sysfs_attr(path, "edid", 256, false);
+}
+
+
+/** Reads the status attribute of a DRM connector.
+ *
+ *  \param  connector_name  e.g. card0-DP-1
+ *  \return status string, e.g. "connected", NULL if unavailable
+ *
+ *  \remark
+ *  Caller is responsible for freeing the returned value.
+ */
+char * get_sysfs_drm_connector_status(const char * connector_name) {
+   char path[PATH_MAX];
+   g_snprintf(path, PATH_MAX, "/sys/class/drm/%s", connector_name);
+   return read_sysfs_attr(path, "status", false);
+}
@@ -9,6 +9,9 @@
 #ifndef I2C_SYSFS_H_
 #define I2C_SYSFS_H_
 
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+
 typedef struct {
    int     busno;
    bool    is_display_port;
@@ -32,5 +35,8 @@ void           free_i2c_sys_info(I2C_Sys_Info * info);
 I2C_Sys_Info * get_i2c_sys_info(int busno, int depth);
 void           report_i2c_sys_info(I2C_Sys_Info * info, int depth);
 void           dbgrpt_sys_bus_i2c(int depth);
+char *         find_sysfs_drm_connector_name(int busno);
+char *         get_sysfs_drm_connector_status(const char * connector_name);
+GByteArray *   get_sysfs_drm_connector_edid(const char * connector_name);
 
 #endif /* I2C_SYSFS_H_ */
@@ -28,7 +28,9 @@
 #include "base/build_info.h"
 #include "base/core.h"
 #include "base/core_per_thread_settings.h"
+#include "base/execution_stats.h"
 #include "base/parms.h"
+#include "base/per_display_data.h"
 #include "base/per_thread_data.h"
 #include "base/thread_retry_data.h"
 #include "base/thread_sleep_data.h"
@@ -42,6 +44,7 @@
 #include "ddc/ddc_displays.h"
 #include "ddc/ddc_multi_part_io.h"
 #include "ddc/ddc_packet_io.h"
+#include "ddc/ddc_request_queue.h"
 #include "ddc/ddc_services.h"
 #include "ddc/ddc_try_stats.h"
 #include "ddc/ddc_vcp.h"
@@ -51,6 +54,7 @@
 
 #include "libmain/api_error_info_internal.h"
 #include "libmain/api_base_internal.h"
+#include "libmain/api_displays_internal.h"
 #include "libmain/api_services_internal.h"
 
 
@@ -356,7 +360,9 @@ _ddca_terminate(void) {
    bool debug = false;
    DBGTRC_STARTING(debug, DDCA_TRC_API, "library_initialized = %s", SBOOL(library_initialized));
    if (library_initialized) {
+      ddc_stop_display_request_threads();
       ddc_discard_detected_displays();
+      release_ddc_services();
       release_base_services();
       ddc_stop_watch_displays();
       free_regex_hash_table();
@@ -669,6 +675,30 @@ ddca_is_verify_enabled() {
    return ddc_get_verify_setvcp();
 }
 
+
+bool
+ddca_enable_setvcp_coalescing(bool onoff) {
+   return ddc_enable_setvcp_coalescing(onoff);
+}
+
+
+bool
+ddca_is_setvcp_coalescing_enabled() {
+   return ddc_is_setvcp_coalescing_enabled();
+}
+
+
+bool
+ddca_enable_deferred_verify(bool onoff) {
+   return ddc_set_deferred_verify(onoff);
+}
+
+
+bool
+ddca_is_deferred_verify_enabled() {
+   return ddc_get_deferred_verify();
+}
+
 #ifdef NOT_NEEDED
 void ddca_lock_default_sleep_multiplier() {
    lock_default_sleep_multiplier();
@@ -883,3 +913,37 @@ ddca_show_stats(
 }
 
 
+DDCA_Status
+ddca_get_io_stats(
+      DDCA_Display_Ref        ddca_dref,
+      DDCA_IO_Event_Type      event_type,
+      DDCA_IO_Latency_Stats * stats_loc)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_API, "ddca_dref=%p, event_type=%d", ddca_dref, event_type);
+   API_PRECOND(stats_loc);
+
+   DDCA_Status psc = 0;
+   Latency_Histogram histogram;
+   // DDCA_IO_Event_Type values are identical to IO_Event_Type values
+   if (event_type < DDCA_IO_EVENT_WRITE || event_type > DDCA_IO_EVENT_OTHER) {
+      psc = DDCRC_ARG;
+   }
+   else if (ddca_dref) {
+      Display_Ref * dref = validated_ddca_display_ref(ddca_dref);
+      if (!dref)
+         psc = DDCRC_ARG;
+      else
+         pdd_get_io_latency(dref->async_rec->pdd, (IO_Event_Type) event_type, &histogram);
+   }
+   else {
+      get_io_event_latency((IO_Event_Type) event_type, &histogram);
+   }
+   if (psc == 0)
+      latency_histogram_summarize(&histogram, stats_loc);
+
+   DBGTRC_RETURNING(debug, DDCA_TRC_API, psc, "");
+   return psc;
+}
+
+
@@ -139,7 +139,7 @@ ddca_parse_capabilities_string(
    DDCA_Capabilities * result = NULL;
 
    // need to control messages?
-   Parsed_Capabilities * pcaps = parse_capabilities_string(capabilities_string);
+   Parsed_Capabilities * pcaps = get_parsed_capabilities(capabilities_string);
    if (pcaps) {
       if (debug) {
          DBGMSG("Parsing succeeded: ");
@@ -398,7 +398,7 @@ ddca_parse_and_report_capabilities(
       DDCA_Display_Ref          dref,
       int                       depth)
 {
-      Parsed_Capabilities* pcaps = parse_capabilities_string(capabilities_string);
+      Parsed_Capabilities* pcaps = get_parsed_capabilities(capabilities_string);
       dyn_report_parsed_capabilities(pcaps, NULL, dref, 0);
       free_parsed_capabilities(pcaps);
 }
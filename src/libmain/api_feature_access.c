@@ -9,7 +9,12 @@
 #include "config.h"
 
 #include <assert.h>
+#include <errno.h>
+#include <glib-2.0/glib.h>
+#include <stdint.h>
 #include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 #include "public/ddcutil_c_api.h"
 #include "public/ddcutil_status_codes.h"
@@ -27,6 +32,7 @@
 #include "dynvcp/dyn_feature_codes.h"
 
 #include "ddc/ddc_dumpload.h"
+#include "ddc/ddc_request_queue.h"
 #include "ddc/ddc_vcp_version.h"
 #include "ddc/ddc_vcp.h"
 
@@ -174,6 +180,10 @@ ddca_get_vcp_value(
    DBGTRC_STARTING(debug, DDCA_TRC_API,
           "ddca_dh=%p, feature_code=0x%02x, call_type=%d, pvalrec=%p",
           ddca_dh, feature_code, call_type, pvalrec);
+   if (call_type != DDCA_NON_TABLE_VCP_VALUE && call_type != DDCA_TABLE_VCP_VALUE) {
+      DBGTRC_RETURNING(debug, DDCA_TRC_API, DDCRC_ARG, "Invalid call_type: %d", call_type);
+      return DDCRC_ARG;
+   }
 
    Error_Info * ddc_excp = NULL;
    WITH_VALIDATED_DH2(ddca_dh,
@@ -295,6 +305,41 @@ ddca_get_any_vcp_value_using_implicit_type(
 }
 
 
+DDCA_Status
+ddca_get_vcp_values(
+      DDCA_Display_Handle       ddca_dh,
+      int                       feature_ct,
+      DDCA_Vcp_Feature_Code *   feature_codes,
+      DDCA_Any_Vcp_Value **     valrecs,
+      DDCA_Status *             statuses)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_API, "ddca_dh=%p, feature_ct=%d", ddca_dh, feature_ct);
+   API_PRECOND(feature_ct >= 0);
+   API_PRECOND(feature_ct == 0 || (feature_codes && valrecs));
+
+   WITH_VALIDATED_DH2(ddca_dh,
+      {
+         DDCA_Vcp_Value_Type * value_types = calloc(feature_ct+1, sizeof(DDCA_Vcp_Value_Type));
+         for (int ndx = 0; ndx < feature_ct; ndx++) {
+            valrecs[ndx] = NULL;
+            value_types[ndx] = DDCA_NON_TABLE_VCP_VALUE;   // if not a known code
+            get_value_type(dh, feature_codes[ndx], &value_types[ndx]);
+         }
+         Error_Info * ddc_excp =
+               ddc_get_vcp_values(dh, feature_ct, feature_codes, value_types, valrecs, statuses);
+         free(value_types);
+         psc = ERRINFO_STATUS(ddc_excp);
+         if (ddc_excp) {
+            save_thread_error_detail(error_info_to_ddca_detail(ddc_excp));
+            errinfo_free(ddc_excp);
+         }
+         DBGTRC_RETURNING(debug, DDCA_TRC_API, psc, "");
+      }
+   );
+}
+
+
 void
 ddca_free_table_vcp_value(
       DDCA_Table_Vcp_Value * table_value)
@@ -672,13 +717,74 @@ set_single_vcp_value(
 
       Error_Info * ddc_excp = NULL;
       WITH_VALIDATED_DH2(ddca_dh,  {
-            ddc_excp = ddc_set_vcp_value(dh, valrec, verified_value_loc);
+            if (ddc_is_setvcp_coalescing_enabled()) {
+               // pass through the display's queue so that writes from other
+               // threads can be coalesced with this one
+               Display_Request * request =
+                     ddc_queue_set_vcp_request(dh, clone_single_vcp_value(valrec), NULL, NULL);
+               ddc_wait_display_request(request);
+               ddc_excp = request->excp;
+               request->excp = NULL;
+               if (verified_value_loc) {
+                  *verified_value_loc = request->result_value;
+                  request->result_value = NULL;
+               }
+               ddc_free_display_request(request);
+            }
+            else {
+               ddc_excp = ddc_set_vcp_value(dh, valrec, verified_value_loc);
+            }
             psc = (ddc_excp) ? ddc_excp->status_code : 0;
             errinfo_free(ddc_excp);
             DBGTRC_RETURNING(debug, DDCA_TRC_API, psc, "");
          } );
 }
 
+static DDCA_Verify_Failure_Callback verify_failure_callback = NULL;
+
+static void
+deferred_verify_failed(
+      Display_Handle *      dh,
+      Error_Info *          excp,
+      DDCA_Any_Vcp_Value *  expected,
+      DDCA_Any_Vcp_Value *  actual)
+{
+   DDCA_Verify_Failure_Callback func = verify_failure_callback;
+   if (func)
+      func(dh, excp->status_code, expected, actual);
+}
+
+
+void
+ddca_set_verify_failure_callback(
+      DDCA_Verify_Failure_Callback func)
+{
+   verify_failure_callback = func;
+   ddc_set_deferred_verify_failure_func( (func) ? deferred_verify_failed : NULL);
+}
+
+
+DDCA_Status
+ddca_flush_deferred_verifies(
+      DDCA_Display_Handle   ddca_dh)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_API, "ddca_dh=%p", ddca_dh);
+
+   WITH_VALIDATED_DH2(ddca_dh,
+      {
+         Error_Info * ddc_excp = ddc_flush_deferred_verifies(dh);
+         if (ddc_excp) {
+            psc = ddc_excp->status_code;
+            save_thread_error_detail(error_info_to_ddca_detail(ddc_excp));
+            errinfo_free(ddc_excp);
+         }
+         DBGTRC_RETURNING(debug, DDCA_TRC_API, psc, "");
+      }
+   );
+}
+
+
 // UNPUBLISHED
 /** Sets a Continuous VCP value.
  *
@@ -996,6 +1102,209 @@ ddca_set_profile_related_values(
 }
 
 
+//
+// Asynchronous get and set VCP value
+//
+
+#define ASYNC_API_REQUEST_MARKER "AAPR"
+typedef struct {
+   char                 marker[4];
+   DDCA_Async_Callback  callback;
+   void *               user_data;
+   bool                 completed;
+   Error_Info *         excp;
+   DDCA_Any_Vcp_Value * valrec;
+} Async_Api_Request;
+
+// protects completed flag of all Async_Api_Requests
+static GMutex async_api_mutex;
+static GCond  async_api_cond;
+static int    async_event_fd = -1;
+
+
+static void free_async_api_request(Async_Api_Request * api_req) {
+   if (api_req) {
+      assert(memcmp(api_req->marker, ASYNC_API_REQUEST_MARKER, 4) == 0);
+      api_req->marker[3] = 'x';
+      free(api_req);
+   }
+}
+
+
+// Display_Request_Callback, called on the display's executor thread
+static void async_api_request_completed(Display_Request * request) {
+   bool debug = false;
+   Async_Api_Request * api_req = request->callback_data;
+   assert(memcmp(api_req->marker, ASYNC_API_REQUEST_MARKER, 4) == 0);
+   DBGTRC_STARTING(debug, DDCA_TRC_API, "api_req=%p, excp=%s", api_req, errinfo_summary(request->excp));
+
+   // take ownership of results from request
+   Error_Info *         excp   = request->excp;
+   DDCA_Any_Vcp_Value * valrec = request->result_value;
+   request->excp = NULL;
+   request->result_value = NULL;
+
+   if (api_req->callback) {
+      DDCA_Status psc = (excp) ? excp->status_code : 0;
+      errinfo_free(excp);
+      api_req->callback(api_req, psc, valrec, api_req->user_data);
+      free_async_api_request(api_req);
+   }
+   else {
+      g_mutex_lock(&async_api_mutex);
+      api_req->excp = excp;
+      api_req->valrec = valrec;
+      api_req->completed = true;
+      g_cond_broadcast(&async_api_cond);
+      int fd = async_event_fd;
+      g_mutex_unlock(&async_api_mutex);
+      if (fd >= 0) {
+         uint64_t one = 1;
+         if (write(fd, &one, sizeof(one)) < 0)
+            DBGMSF(debug, "write to eventfd failed, errno=%d", errno);
+      }
+   }
+
+   DBGTRC_DONE(debug, DDCA_TRC_API, "");
+}
+
+
+static Async_Api_Request * async_api_request_new(DDCA_Async_Callback callback, void * user_data) {
+   Async_Api_Request * api_req = calloc(1, sizeof(Async_Api_Request));
+   memcpy(api_req->marker, ASYNC_API_REQUEST_MARKER, 4);
+   api_req->callback  = callback;
+   api_req->user_data = user_data;
+   return api_req;
+}
+
+
+DDCA_Status
+ddca_get_vcp_value_async(
+      DDCA_Display_Handle       ddca_dh,
+      DDCA_Vcp_Feature_Code     feature_code,
+      DDCA_Vcp_Value_Type       value_type,
+      DDCA_Async_Callback       callback,
+      void *                    user_data,
+      DDCA_Async_Request *      request_loc)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_API, "ddca_dh=%p, feature_code=0x%02x, value_type=%d, callback=%p",
+                                        ddca_dh, feature_code, value_type, callback);
+   API_PRECOND(request_loc);
+   *request_loc = NULL;
+   if (value_type != DDCA_NON_TABLE_VCP_VALUE && value_type != DDCA_TABLE_VCP_VALUE) {
+      DBGTRC_RETURNING(debug, DDCA_TRC_API, DDCRC_ARG, "Invalid value_type: %d", value_type);
+      return DDCRC_ARG;
+   }
+
+   WITH_VALIDATED_DH2(ddca_dh,
+      {
+         Async_Api_Request * api_req = async_api_request_new(callback, user_data);
+         *request_loc = api_req;     // set before queuing, callback may execute immediately
+         ddc_queue_get_vcp_request(dh, feature_code, value_type,
+                                   async_api_request_completed, api_req);
+         DBGTRC_RETURNING(debug, DDCA_TRC_API, psc, "*request_loc=%p", api_req);
+      }
+   );
+}
+
+
+DDCA_Status
+ddca_set_vcp_value_async(
+      DDCA_Display_Handle       ddca_dh,
+      DDCA_Any_Vcp_Value *      new_value,
+      DDCA_Async_Callback       callback,
+      void *                    user_data,
+      DDCA_Async_Request *      request_loc)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_API, "ddca_dh=%p, new_value=%p, callback=%p",
+                                        ddca_dh, new_value, callback);
+   API_PRECOND(new_value);
+   API_PRECOND(request_loc);
+   *request_loc = NULL;
+
+   WITH_VALIDATED_DH2(ddca_dh,
+      {
+         Async_Api_Request * api_req = async_api_request_new(callback, user_data);
+         *request_loc = api_req;
+         ddc_queue_set_vcp_request(dh, clone_single_vcp_value(new_value),
+                                   async_api_request_completed, api_req);
+         DBGTRC_RETURNING(debug, DDCA_TRC_API, psc, "*request_loc=%p", api_req);
+      }
+   );
+}
+
+
+DDCA_Status
+ddca_get_async_event_fd(
+      int *                     fd_loc)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_API, "");
+   API_PRECOND(fd_loc);
+   DDCA_Status psc = 0;
+
+   g_mutex_lock(&async_api_mutex);
+   if (async_event_fd < 0) {
+      async_event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+      if (async_event_fd < 0)
+         psc = -errno;
+   }
+   *fd_loc = async_event_fd;
+   g_mutex_unlock(&async_api_mutex);
+
+   DBGTRC_RETURNING(debug, DDCA_TRC_API, psc, "*fd_loc=%d", *fd_loc);
+   return psc;
+}
+
+
+DDCA_Status
+ddca_get_async_result(
+      DDCA_Async_Request        request,
+      bool                      wait,
+      DDCA_Any_Vcp_Value **     valrec_loc)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_API, "request=%p, wait=%s", request, sbool(wait));
+   free_thread_error_detail();
+   if (valrec_loc)
+      *valrec_loc = NULL;
+   DDCA_Status psc = 0;
+
+   Async_Api_Request * api_req = request;
+   if (!api_req || memcmp(api_req->marker, ASYNC_API_REQUEST_MARKER, 4) != 0 || api_req->callback) {
+      psc = DDCRC_ARG;
+   }
+   else {
+      g_mutex_lock(&async_api_mutex);
+      while (wait && !api_req->completed)
+         g_cond_wait(&async_api_cond, &async_api_mutex);
+      bool completed = api_req->completed;
+      g_mutex_unlock(&async_api_mutex);
+
+      if (!completed) {
+         psc = DDCRC_PENDING;
+      }
+      else {
+         if (api_req->excp) {
+            psc = api_req->excp->status_code;
+            save_thread_error_detail(error_info_to_ddca_detail(api_req->excp));
+            errinfo_free(api_req->excp);
+         }
+         if (valrec_loc)
+            *valrec_loc = api_req->valrec;
+         else
+            free_single_vcp_value(api_req->valrec);
+         free_async_api_request(api_req);
+      }
+   }
+
+   DBGTRC_RETURNING(debug, DDCA_TRC_API, psc, "");
+   return psc;
+}
+
+
 //
 // Vestiges of old experimental async API.
 // Never published, retained for ABI compatibility.
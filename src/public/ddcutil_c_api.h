@@ -241,6 +241,60 @@ ddca_enable_verify(
 bool
 ddca_is_verify_enabled(void);
 
+/** Controls whether queued set VCP value requests are coalesced.
+ *
+ *  If enabled, a request to set a feature that is queued while an earlier
+ *  request to set the same feature on the same display is still waiting
+ *  replaces the earlier request, so that only the latest value is written.
+ *  This keeps e.g. brightness slider drags responsive.  Each replaced request
+ *  completes with the status and value of the request that replaced it.
+ *
+ *  \param[in] onoff true/false
+ *  \return  prior value
+ *
+ *  \remark This setting is global to all threads.
+ *  \since 1.3.0
+ */
+bool
+ddca_enable_setvcp_coalescing(bool onoff);
+
+/** Query whether queued set VCP value requests are coalesced.
+ *
+ *  \return true/false
+ *  \since 1.3.0
+ */
+bool
+ddca_is_setvcp_coalescing_enabled(void);
+
+/** Controls whether verification of values set is deferred.
+ *
+ *  If enabled, and verification is enabled (see #ddca_enable_verify()),
+ *  a set function returns once the value has been written.  Values written
+ *  using a display handle are verified together, when #ddca_flush_deferred_verifies()
+ *  is called, when the display is closed, or when enough values are pending.
+ *  Only the latest value written for a feature is verified.
+ *  Failures are reported to the function registered using
+ *  #ddca_set_verify_failure_callback().
+ *
+ *  \param[in] onoff true/false
+ *  \return  prior value
+ *
+ *  \remark This setting is thread-specific.
+ *  \since 1.3.0
+ */
+bool
+ddca_enable_deferred_verify(bool onoff);
+
+/** Query whether verification of values set is deferred.
+ *
+ *  \return true/false
+ *
+ *  \remark This setting is thread-specific.
+ *  \since 1.3.0
+ */
+bool
+ddca_is_deferred_verify_enabled(void);
+
 
 /** Controls the force I2C slave address setting.
  *
@@ -525,7 +579,25 @@ ddca_show_stats(
       bool            include_per_thread_data,
       int             depth);
 
-// TODO: Add functions to get stats
+/** Gets latency statistics for an I/O event type.
+ *
+ *  \param[in]  ddca_dref   display reference, if NULL report for all displays
+ *  \param[in]  event_type  I/O event type
+ *  \param[out] stats_loc   where to return statistics
+ *  \retval     DDCRC_OK    success
+ *  \retval     DDCRC_ARG   invalid display reference or event type
+ *
+ *  @remark
+ *  Statistics for individual displays include only I/O performed
+ *  while the display is open.
+ *
+ *  @since 1.3.0
+ */
+DDCA_Status
+ddca_get_io_stats(
+      DDCA_Display_Ref        ddca_dref,
+      DDCA_IO_Event_Type      event_type,
+      DDCA_IO_Latency_Stats * stats_loc);
 
 /** Enable display of internal exception reports (Error_Info).
  *
@@ -1706,6 +1778,43 @@ ddca_format_any_vcp_value_by_dref(
       DDCA_Any_Vcp_Value *    valrec,
       char **                 formatted_value_loc);
 
+/** Gets the values of multiple VCP features in a single call.
+ *
+ *  The features are read in sequence as a single batch, which is not interleaved
+ *  with operations on the display from other threads.  Inter-command delays
+ *  are scheduled to minimize elapsed time, so this is faster than calling
+ *  #ddca_get_any_vcp_value_using_explicit_type() for each feature.
+ *  A feature code that appears more than once is read only once.
+ *
+ *  @param[in]  ddca_dh        display handle
+ *  @param[in]  feature_ct     number of features
+ *  @param[in]  feature_codes  array of **feature_ct** feature codes
+ *  @param[out] valrecs        array of **feature_ct** locations at which to
+ *                             return the feature values, NULL if a read failed
+ *  @param[out] statuses       if non-NULL, array of **feature_ct** locations at
+ *                             which to return per-feature status codes
+ *  @retval     DDCRC_OK                   all features read
+ *  @retval     DDCRC_MULTI_FEATURE_ERROR  at least one feature could not be read
+ *  @retval     DDCRC_ARG                  invalid display handle
+ *
+ *  @remark
+ *  The value type of each feature is determined from the feature metadata.
+ *  @remark
+ *  It is the responsibility of the caller to free each returned value
+ *  using #ddca_free_any_vcp_value().
+ *  @remark
+ *  If DDCRC_MULTI_FEATURE_ERROR is returned, a detailed error report
+ *  can be obtained using #ddca_get_error_detail().
+ *  @since 1.3.0
+ */
+DDCA_Status
+ddca_get_vcp_values(
+      DDCA_Display_Handle       ddca_dh,
+      int                       feature_ct,
+      DDCA_Vcp_Feature_Code *   feature_codes,
+      DDCA_Any_Vcp_Value **     valrecs,
+      DDCA_Status *             statuses);
+
 
 //
 // Set VCP value
@@ -1755,6 +1864,137 @@ ddca_set_any_vcp_value(
       DDCA_Vcp_Feature_Code   feature_code,
       DDCA_Any_Vcp_Value *    new_value);
 
+/** Verifies the values written using a display handle whose verification
+ *  has been deferred (see #ddca_enable_deferred_verify()).
+ *
+ *  \param[in]   ddca_dh        display handle
+ *  \return      DDCRC_OK if all values verified, DDCRC_VERIFY if any failed
+ *  \since 1.3.0
+ */
+DDCA_Status
+ddca_flush_deferred_verifies(
+      DDCA_Display_Handle     ddca_dh);
+
+/** Registers the function to be called when a deferred verification fails.
+ *
+ *  \param[in]   func  function to call, NULL to unregister
+ *  \since 1.3.0
+ */
+void
+ddca_set_verify_failure_callback(
+      DDCA_Verify_Failure_Callback func);
+
+
+//
+// Asynchronous get and set VCP value
+//
+// Requests are queued for execution on a per-display executor thread.
+// Requests for different displays execute concurrently; requests for
+// a single display execute in the order queued.
+//
+// Completion is reported either by calling a #DDCA_Async_Callback, or,
+// if no callback is specified, by signaling the file descriptor returned
+// by #ddca_get_async_event_fd().  In the latter case the result is
+// retrieved using #ddca_get_async_result().
+//
+
+/** Queues a request to read a VCP feature value.
+ *
+ *  @param[in]  ddca_dh       display handle
+ *  @param[in]  feature_code  VCP feature code
+ *  @param[in]  value_type    value type
+ *  @param[in]  callback      function to call on completion, may be NULL
+ *  @param[in]  user_data     passed to the callback
+ *  @param[out] request_loc   where to return the request token
+ *  @retval     DDCRC_ARG     invalid **value_type**
+ *  @return     otherwise status code of queuing the request
+ *
+ *  @remark
+ *  If **callback** is non-NULL, the token is invalid after the callback returns.
+ *  Otherwise, the token is valid until the result is retrieved
+ *  by #ddca_get_async_result().
+ *  @remark
+ *  #ddca_close_display() waits for outstanding requests on the handle to complete.
+ *  A callback may close the display handle used for its request, as described
+ *  for #DDCA_Async_Callback.
+ *  @since 1.3.0
+ */
+DDCA_Status
+ddca_get_vcp_value_async(
+      DDCA_Display_Handle       ddca_dh,
+      DDCA_Vcp_Feature_Code     feature_code,
+      DDCA_Vcp_Value_Type       value_type,
+      DDCA_Async_Callback       callback,
+      void *                    user_data,
+      DDCA_Async_Request *      request_loc);
+
+/** Queues a request to set a VCP feature value.
+ *
+ *  @param[in]  ddca_dh       display handle
+ *  @param[in]  new_value     value to set, copied
+ *  @param[in]  callback      function to call on completion, may be NULL
+ *  @param[in]  user_data     passed to the callback
+ *  @param[out] request_loc   where to return the request token
+ *  @return     status code of queuing the request
+ *
+ *  @remark
+ *  The value is verified if verification is enabled for the current thread
+ *  (see #ddca_enable_verify()) at the time the request is queued.
+ *  If verification is performed, the value read is reported on completion.
+ *  @remark
+ *  If coalescing is enabled (see #ddca_enable_setvcp_coalescing()), the request
+ *  may be replaced by a later request for the same feature.  It then reports the
+ *  status of the later request, and the value written.
+ *  @remark
+ *  Token lifetime is as for #ddca_get_vcp_value_async().
+ *  @since 1.3.0
+ */
+DDCA_Status
+ddca_set_vcp_value_async(
+      DDCA_Display_Handle       ddca_dh,
+      DDCA_Any_Vcp_Value *      new_value,
+      DDCA_Async_Callback       callback,
+      void *                    user_data,
+      DDCA_Async_Request *      request_loc);
+
+/** Returns a file descriptor, suitable for poll() or select(), that becomes
+ *  readable when an asynchronous request queued without a callback completes.
+ *
+ *  The descriptor is an eventfd.  The caller should read() its 8 byte counter
+ *  to reset it, then call #ddca_get_async_result() for outstanding requests.
+ *
+ *  @param[out] fd_loc  where to return the file descriptor
+ *  @return     status code, -errno if the descriptor cannot be created
+ *  @since 1.3.0
+ */
+DDCA_Status
+ddca_get_async_event_fd(
+      int *                     fd_loc);
+
+/** Retrieves the result of an asynchronous request queued without a callback.
+ *
+ *  @param[in]  request     request token
+ *  @param[in]  wait        if true, wait for the request to complete
+ *  @param[out] valrec_loc  where to return the value read or verified, may be NULL.
+ *                          The caller must free the value using #ddca_free_any_vcp_value().
+ *  @retval     DDCRC_PENDING  **wait** is false and the request has not completed
+ *  @retval     DDCRC_ARG      invalid request token
+ *  @return     otherwise the status code of the operation
+ *
+ *  @remark
+ *  Unless DDCRC_PENDING or DDCRC_ARG is returned, the request token is
+ *  no longer valid.
+ *  @remark
+ *  If the operation failed, a detailed error report can be obtained
+ *  using #ddca_get_error_detail().
+ *  @since 1.3.0
+ */
+DDCA_Status
+ddca_get_async_result(
+      DDCA_Async_Request        request,
+      bool                      wait,
+      DDCA_Any_Vcp_Value **     valrec_loc);
+
 
 //
 // Get or set multiple values
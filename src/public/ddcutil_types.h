@@ -175,6 +175,27 @@ typedef enum {
    DDCA_STATS_ALL      = 0xFF     ///< indicates all statistics types
 } DDCA_Stats_Type;
 
+//! I/O event types for which latency statistics are maintained
+typedef enum {
+   DDCA_IO_EVENT_WRITE,          ///< write calls
+   DDCA_IO_EVENT_READ,           ///< read calls
+   DDCA_IO_EVENT_WRITE_READ,     ///< write/read calls, typical for I2C
+   DDCA_IO_EVENT_OPEN,           ///< device file open
+   DDCA_IO_EVENT_CLOSE,          ///< device file close
+   DDCA_IO_EVENT_OTHER           ///< other I/O calls
+} DDCA_IO_Event_Type;
+
+//! Latency statistics for an I/O event type.
+//! Percentile values are approximate, within 12.5% of the actual value.
+typedef struct {
+   int      event_ct;             ///< number of events
+   uint64_t total_nanosec;        ///< total elapsed time
+   uint64_t p50_nanosec;          ///< median
+   uint64_t p90_nanosec;          ///< 90th percentile
+   uint64_t p99_nanosec;          ///< 99th percentile
+   uint64_t max_nanosec;          ///< maximum
+} DDCA_IO_Latency_Stats;
+
 
 //
 // Output capture
@@ -553,6 +574,51 @@ typedef struct {
 #define VALREC_CUR_VAL(valrec) ( valrec->val.c_nc.sh << 8 | valrec->val.c_nc.sl )
 #define VALREC_MAX_VAL(valrec) ( valrec->val.c_nc.mh << 8 | valrec->val.c_nc.ml )
 
+
+//
+// Asynchronous feature access
+//
+
+/** Opaque token identifying an outstanding asynchronous get or set VCP value request
+ *  @since 1.3.0
+ */
+typedef void * DDCA_Async_Request;
+
+/** Signature of function called when an asynchronous get or set VCP value
+ *  request completes.  The function is called on the display's executor thread.
+ *  It may close the display handle used for the request.  Requests for that
+ *  handle that are still queued then complete with status DDCRC_INVALID_OPERATION.
+ *
+ *  @param  request    token returned when the request was queued
+ *  @param  status     status code of the operation
+ *  @param  valrec     value read, for a set request the verified value if verification
+ *                     was performed, otherwise NULL. Ownership passes to the callback,
+ *                     which must free it using #ddca_free_any_vcp_value()
+ *  @param  user_data  as passed when the request was queued
+ *  @since 1.3.0
+ */
+typedef void (*DDCA_Async_Callback)(
+      DDCA_Async_Request    request,
+      DDCA_Status           status,
+      DDCA_Any_Vcp_Value *  valrec,
+      void *                user_data);
+
+/** Signature of function called when a deferred verification of a value
+ *  written fails.  The function is called on the thread performing the
+ *  verification.
+ *
+ *  @param  ddca_dh   display handle
+ *  @param  status    DDCRC_VERIFY if the value read differs, otherwise the status of the read
+ *  @param  expected  value written, owned by the library
+ *  @param  actual    value read, owned by the library, NULL if the read failed
+ *  @since 1.3.0
+ */
+typedef void (*DDCA_Verify_Failure_Callback)(
+      DDCA_Display_Handle   ddca_dh,
+      DDCA_Status           status,
+      DDCA_Any_Vcp_Value *  expected,
+      DDCA_Any_Vcp_Value *  actual);
+
 #ifdef __cplusplus
 }
 #endif
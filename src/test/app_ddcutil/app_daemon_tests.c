@@ -0,0 +1,199 @@
+/** @file app_daemon_tests.c
+ *
+ *  Testcases for forwarding of commands to the ddcutil daemon.
+ *
+ *  The daemon is run on a separate thread, listening on a socket in a
+ *  temporary directory that replaces $XDG_RUNTIME_DIR for the duration
+ *  of the testcase.  It is terminated by sending SIGTERM to that thread.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <glib-2.0/glib.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "util/string_util.h"
+
+#include "base/core.h"
+#include "base/displays.h"
+
+#include "cmdline/cmd_parser.h"
+#include "cmdline/parsed_cmd.h"
+
+#include "ddc/ddc_packet_io.h"
+
+#include "app_ddcutil/app_daemon.h"
+#include "app_ddcutil/app_dynamic_features.h"
+#include "app_ddcutil/app_getvcp.h"
+
+#include "test/testcases.h"
+
+#include "test/app_ddcutil/app_daemon_tests.h"
+
+
+typedef struct {
+   Parsed_Cmd *  parsed_cmd;
+   int           rc;
+   volatile bool done;
+} Daemon_Thread_Data;
+
+
+// Executes GETVCP as main() does for a display specified by bus number
+static int execute_getvcp(Parsed_Cmd * parsed_cmd) {
+   if (parsed_cmd->cmd_id != CMDID_GETVCP || !parsed_cmd->pdid ||
+       parsed_cmd->pdid->id_type != DISP_ID_BUSNO)
+   {
+      f0printf(ferr(), "Unexpected command\n");
+      return EXIT_FAILURE;
+   }
+   Display_Handle * dh = testcase_open_display(parsed_cmd->pdid->busno);
+   if (!dh)
+      return EXIT_FAILURE;
+   check_dynamic_features(dh->dref);
+   Public_Status_Code psc = app_show_feature_set_values_by_dh(dh, parsed_cmd);
+   ddc_close_display(dh);
+   return (psc == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+static void * run_daemon(void * arg) {
+   Daemon_Thread_Data * data = arg;
+   data->rc = app_daemon_serve(data->parsed_cmd, execute_getvcp);
+   data->done = true;
+   return NULL;
+}
+
+
+// Executes a command in process, capturing its output
+static int execute_directly(int argc, char ** argv, char ** out_loc) {
+   int rc = EXIT_FAILURE;
+   size_t out_len = 0;
+   FILE * outf = open_memstream(out_loc, &out_len);
+   FILE * saved_fout = fout();
+   set_fout(outf);
+   Parsed_Cmd * parsed_cmd = parse_command(argc, argv, MODE_DDCUTIL);
+   if (parsed_cmd) {
+      DDCA_Output_Level saved_ol = set_output_level(parsed_cmd->output_level);
+      rc = execute_getvcp(parsed_cmd);
+      set_output_level(saved_ol);
+      free_parsed_cmd(parsed_cmd);
+   }
+   set_fout(saved_fout);
+   fclose(outf);
+   return rc;
+}
+
+
+// Forwards a command to the daemon, capturing its output.
+// Retries until the daemon is listening, or has terminated.
+static bool forward_to_daemon(int argc, char ** argv, Daemon_Thread_Data * data,
+                              int * rc_loc, char ** out_loc)
+{
+   bool sent = false;
+   size_t out_len = 0;
+   FILE * outf = open_memstream(out_loc, &out_len);
+   FILE * saved_fout = fout();
+   set_fout(outf);
+   for (int tryctr = 0; tryctr < 50 && !sent && !data->done; tryctr++) {
+      sent = app_daemon_forward_cmd(argc, argv, rc_loc);
+      if (!sent)
+         usleep(100*1000);
+   }
+   set_fout(saved_fout);
+   fclose(outf);
+   return sent;
+}
+
+
+static int test_forward_getvcp(int busno, Daemon_Thread_Data * data, pthread_t daemon_thread) {
+   int failure_ct = 0;
+   char busno_buf[12];
+   snprintf(busno_buf, sizeof(busno_buf), "%d", busno);
+   char * argv[] = {"ddcutil", "getvcp", "10", "--bus", busno_buf, "--terse", NULL};
+   int argc = ARRAY_SIZE(argv) - 1;
+
+   char * forwarded_out = NULL;
+   int forwarded_rc = EXIT_FAILURE;
+   bool sent = forward_to_daemon(argc, argv, data, &forwarded_rc, &forwarded_out);
+   // once a reply is received, the daemon's signal handlers are installed
+   if (!data->done)
+      pthread_kill(daemon_thread, SIGTERM);
+   if (!testcase_check(sent, "command forwarded to daemon"))
+      failure_ct++;
+
+   char * direct_out = NULL;
+   int direct_rc = execute_directly(argc, argv, &direct_out);
+   if (!testcase_check(direct_rc == EXIT_SUCCESS && str_starts_with(direct_out, "VCP 10 "),
+                       "in process command reports value: %s", direct_out))
+      failure_ct++;
+   if (sent) {
+      if (!testcase_check(forwarded_rc == EXIT_SUCCESS && streq(forwarded_out, direct_out),
+                          "forwarded command reports same value, rc=%d: %s",
+                          forwarded_rc, forwarded_out))
+         failure_ct++;
+   }
+
+   free(forwarded_out);
+   free(direct_out);
+   return failure_ct;
+}
+
+
+/** Tests that getvcp forwarded to a daemon running in this process returns
+ *  the same output as when executed in process.
+ *
+ *  \param  busno  I2C bus number of display to test
+ */
+void test_daemon_forward_getvcp(int busno) {
+   int failure_ct = 0;
+   GError * error = NULL;
+   char * runtime_dir = g_dir_make_tmp("ddcutil-test-XXXXXX", &error);
+   if (!runtime_dir) {
+      testcase_check(false, "create temporary directory: %s", error->message);
+      g_error_free(error);
+      testcase_report_result(__func__, 1);
+      return;
+   }
+   char * saved_runtime_dir = g_strdup(getenv("XDG_RUNTIME_DIR"));
+   setenv("XDG_RUNTIME_DIR", runtime_dir, 1);
+
+   char * daemon_argv[] = {"ddcutil", "daemon", NULL};
+   Daemon_Thread_Data data = {0};
+   data.parsed_cmd = parse_command(ARRAY_SIZE(daemon_argv) - 1, daemon_argv, MODE_DDCUTIL);
+   pthread_t daemon_thread;
+   if (!data.parsed_cmd || pthread_create(&daemon_thread, NULL, run_daemon, &data) != 0) {
+      testcase_check(false, "start daemon thread");
+      failure_ct++;
+   }
+   else {
+      failure_ct += test_forward_getvcp(busno, &data, daemon_thread);
+      pthread_join(daemon_thread, NULL);
+      if (!testcase_check(data.rc == EXIT_SUCCESS, "daemon terminated normally"))
+         failure_ct++;
+      // the daemon's handlers would otherwise remain in effect
+      struct sigaction default_action = {.sa_handler = SIG_DFL};
+      sigaction(SIGINT,  &default_action, NULL);
+      sigaction(SIGTERM, &default_action, NULL);
+   }
+   if (data.parsed_cmd)
+      free_parsed_cmd(data.parsed_cmd);
+
+   if (saved_runtime_dir)
+      setenv("XDG_RUNTIME_DIR", saved_runtime_dir, 1);
+   else
+      unsetenv("XDG_RUNTIME_DIR");
+   g_free(saved_runtime_dir);
+   char * socket_dir = g_build_filename(runtime_dir, "ddcutil", NULL);
+   rmdir(socket_dir);     // socket is removed by the daemon
+   rmdir(runtime_dir);
+   g_free(socket_dir);
+   g_free(runtime_dir);
+   testcase_report_result(__func__, failure_ct);
+}
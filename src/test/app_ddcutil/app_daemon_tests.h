@@ -0,0 +1,14 @@
+/** @file app_daemon_tests.h
+ *
+ *  Testcases for forwarding of commands to the ddcutil daemon.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef APP_DAEMON_TESTS_H_
+#define APP_DAEMON_TESTS_H_
+
+void test_daemon_forward_getvcp(int busno);
+
+#endif /* APP_DAEMON_TESTS_H_ */
@@ -0,0 +1,148 @@
+/** @file ddc_deferred_verify_tests.c
+ *
+ *  Testcases for deferred setvcp verification.
+ *
+ *  Features x10 (Brightness) and x12 (Contrast) are written with their
+ *  current values, so the display settings are unchanged.  A verification
+ *  failure is simulated by adding a value that was never written to the
+ *  values pending verification.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "public/ddcutil_status_codes.h"
+
+#include "util/error_info.h"
+
+#include "base/displays.h"
+#include "base/status_code_mgt.h"
+
+#include "vcp/vcp_feature_values.h"
+
+#include "ddc/ddc_packet_io.h"
+#include "ddc/ddc_vcp.h"
+
+#include "test/testcases.h"
+
+#include "test/ddc/ddc_deferred_verify_tests.h"
+
+
+static int failure_func_ct = 0;
+static DDCA_Vcp_Feature_Code failure_func_feature_code = 0;
+
+static void record_verify_failure(
+      Display_Handle *          dh,
+      Error_Info *              excp,
+      DDCA_Any_Vcp_Value *      expected,
+      DDCA_Any_Vcp_Value *      actual)
+{
+   failure_func_ct++;
+   failure_func_feature_code = expected->opcode;
+}
+
+
+static int pending_ct(Display_Handle * dh) {
+   return (dh->pending_verifies) ? dh->pending_verifies->len : 0;
+}
+
+
+// Writes the current value of a feature, returning the value written
+static DDCA_Any_Vcp_Value *
+rewrite_current_value(Display_Handle * dh, DDCA_Vcp_Feature_Code feature_code, int * failure_ct_loc) {
+   DDCA_Any_Vcp_Value * valrec = NULL;
+   Error_Info * excp = ddc_get_vcp_value(dh, feature_code, DDCA_NON_TABLE_VCP_VALUE, &valrec);
+   if (!testcase_check(!excp, "read feature 0x%02x, status: %s", feature_code, errinfo_summary(excp))) {
+      (*failure_ct_loc)++;
+      errinfo_free(excp);
+      return NULL;
+   }
+   DDCA_Any_Vcp_Value * newval = NULL;
+   excp = ddc_set_vcp_value(dh, valrec, &newval);
+   if (!testcase_check(!excp && !newval,
+                       "write feature 0x%02x with verification deferred, status: %s",
+                       feature_code, errinfo_summary(excp)))
+      (*failure_ct_loc)++;
+   errinfo_free(excp);
+   if (newval)
+      free_single_vcp_value(newval);
+   return valrec;
+}
+
+
+static int test_deferral(Display_Handle * dh) {
+   int failure_ct = 0;
+
+   DDCA_Any_Vcp_Value * brightness = rewrite_current_value(dh, 0x10, &failure_ct);
+   DDCA_Any_Vcp_Value * contrast   = rewrite_current_value(dh, 0x12, &failure_ct);
+   if (!brightness || !contrast)
+      goto bye;
+   if (!testcase_check(pending_ct(dh) == 2, "2 values pending verification, found %d", pending_ct(dh)))
+      failure_ct++;
+
+   DDCA_Any_Vcp_Value * brightness2 = rewrite_current_value(dh, 0x10, &failure_ct);
+   if (brightness2)
+      free_single_vcp_value(brightness2);
+   if (!testcase_check(pending_ct(dh) == 2,
+                       "rewriting x10 replaces its pending value, found %d", pending_ct(dh)))
+      failure_ct++;
+
+   Error_Info * excp = ddc_flush_deferred_verifies(dh);
+   if (!testcase_check(!excp, "pending values verified, status: %s", errinfo_summary(excp)))
+      failure_ct++;
+   errinfo_free(excp);
+   if (!testcase_check(pending_ct(dh) == 0, "no values pending after flush, found %d", pending_ct(dh)))
+      failure_ct++;
+
+   // simulate a value that was written but not applied by the display
+   DDCA_Any_Vcp_Value * unapplied = clone_single_vcp_value(contrast);
+   unapplied->val.c_nc.sl ^= 0x01;
+   g_ptr_array_add(dh->pending_verifies, unapplied);
+   failure_func_ct = 0;
+   excp = ddc_flush_deferred_verifies(dh);
+   if (!testcase_check(excp && excp->status_code == DDCRC_VERIFY,
+                       "flush reports unapplied value, status: %s", errinfo_summary(excp)))
+      failure_ct++;
+   errinfo_free(excp);
+   if (!testcase_check(failure_func_ct == 1 && failure_func_feature_code == 0x12,
+                       "failure function called once for feature x12, call count %d", failure_func_ct))
+      failure_ct++;
+   if (!testcase_check(pending_ct(dh) == 0, "no values pending after failed flush, found %d", pending_ct(dh)))
+      failure_ct++;
+
+bye:
+   if (brightness)
+      free_single_vcp_value(brightness);
+   if (contrast)
+      free_single_vcp_value(contrast);
+   return failure_ct;
+}
+
+
+// Executes test_deferral() with verification enabled and deferred
+static int test_deferral_enabled(Display_Handle * dh) {
+   bool saved_verify = ddc_set_verify_setvcp(true);
+   bool saved_defer  = ddc_set_deferred_verify(true);
+   ddc_set_deferred_verify_failure_func(record_verify_failure);
+
+   int failure_ct = test_deferral(dh);
+
+   ddc_set_deferred_verify_failure_func(NULL);
+   ddc_set_deferred_verify(saved_defer);
+   ddc_set_verify_setvcp(saved_verify);
+   return failure_ct;
+}
+
+
+/** Tests deferred verification of setvcp, rewriting the current values
+ *  of features x10 and x12.
+ *
+ *  \param  busno  I2C bus number of display to test
+ */
+void test_deferred_verify(int busno) {
+   testcase_run_on_display(__func__, busno, test_deferral_enabled);
+}
@@ -0,0 +1,14 @@
+/** @file ddc_deferred_verify_tests.h
+ *
+ *  Testcases for deferred setvcp verification.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_DEFERRED_VERIFY_TESTS_H_
+#define DDC_DEFERRED_VERIFY_TESTS_H_
+
+void test_deferred_verify(int busno);
+
+#endif /* DDC_DEFERRED_VERIFY_TESTS_H_ */
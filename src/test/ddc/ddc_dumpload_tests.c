@@ -0,0 +1,80 @@
+/** @file ddc_dumpload_tests.c
+ *
+ *  Testcases for loadvcp.
+ *
+ *  Values are only read from the display, never written.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "util/error_info.h"
+
+#include "base/displays.h"
+
+#include "vcp/vcp_feature_values.h"
+
+#include "ddc/ddc_dumpload.h"
+#include "ddc/ddc_packet_io.h"
+#include "ddc/ddc_vcp.h"
+
+#include "test/testcases.h"
+
+#include "test/ddc/ddc_dumpload_tests.h"
+
+
+static DDCA_Any_Vcp_Value *
+read_value(Display_Handle * dh, DDCA_Vcp_Feature_Code feature_code, int * failure_ct_loc) {
+   DDCA_Any_Vcp_Value * valrec = NULL;
+   Error_Info * excp = ddc_get_vcp_value(dh, feature_code, DDCA_NON_TABLE_VCP_VALUE, &valrec);
+   if (!testcase_check(!excp, "read feature 0x%02x, status: %s", feature_code, errinfo_summary(excp)))
+      (*failure_ct_loc)++;
+   errinfo_free(excp);
+   return valrec;
+}
+
+
+/** Checks that of the values to be loaded, only those that differ
+ *  from the current values are selected for writing.
+ */
+static int test_changed_values(Display_Handle * dh) {
+   int failure_ct = 0;
+   DDCA_Any_Vcp_Value * brightness = read_value(dh, 0x10, &failure_ct);
+   DDCA_Any_Vcp_Value * contrast   = read_value(dh, 0x12, &failure_ct);
+   if (brightness && contrast) {
+      Byte cur_sl = contrast->val.c_nc.sl;
+      contrast->val.c_nc.sl = (cur_sl > 0) ? cur_sl-1 : cur_sl+1;
+
+      Vcp_Value_Set vset = vcp_value_set_new(2);
+      vcp_value_set_add(vset, brightness);     // vset takes ownership
+      vcp_value_set_add(vset, contrast);
+      brightness = NULL;
+      contrast   = NULL;
+
+      bool * changed = ddc_find_changed_values(dh, vset);
+      if (!testcase_check(!changed[0], "x10 set to its current value is unchanged"))
+         failure_ct++;
+      if (!testcase_check(changed[1], "x12 set to a value other than its current value is changed"))
+         failure_ct++;
+      free(changed);
+      free_vcp_value_set(vset);
+   }
+   if (brightness)
+      free_single_vcp_value(brightness);
+   if (contrast)
+      free_single_vcp_value(contrast);
+   return failure_ct;
+}
+
+
+/** Tests #ddc_find_changed_values(), used by differential loadvcp.
+ *
+ *  \param  busno  I2C bus number of display to test
+ */
+void test_find_changed_values(int busno) {
+   testcase_run_on_display(__func__, busno, test_changed_values);
+}
@@ -0,0 +1,14 @@
+/** @file ddc_dumpload_tests.h
+ *
+ *  Testcases for loadvcp.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_DUMPLOAD_TESTS_H_
+#define DDC_DUMPLOAD_TESTS_H_
+
+void test_find_changed_values(int busno);
+
+#endif /* DDC_DUMPLOAD_TESTS_H_ */
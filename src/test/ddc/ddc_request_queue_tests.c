@@ -0,0 +1,255 @@
+/** @file ddc_request_queue_tests.c
+ *
+ *  Testcases for the per-display request queue.
+ *
+ *  The testcases read and write feature x10 (Brightness), writing only
+ *  its current value.  While the testcase thread holds the display lock,
+ *  or the executor thread is held in a request callback, the executor
+ *  cannot start another request, so requests queued in the meantime
+ *  remain in the queue.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "public/ddcutil_status_codes.h"
+
+#include "util/error_info.h"
+
+#include "base/displays.h"
+#include "base/status_code_mgt.h"
+
+#include "vcp/vcp_feature_values.h"
+
+#include "ddc/ddc_packet_io.h"
+#include "ddc/ddc_request_queue.h"
+
+#include "test/testcases.h"
+
+#include "test/ddc/ddc_request_queue_tests.h"
+
+
+#define TEST_FEATURE_CODE 0x10
+
+/** Results recorded by request callbacks */
+typedef struct {
+   GMutex      mutex;
+   GCond       cond;
+   int         completed_ct;
+   DDCA_Status status[3];
+} Callback_Results;
+
+
+static void record_result(Display_Request * request) {
+   Callback_Results * results = request->callback_data;
+   g_mutex_lock(&results->mutex);
+   results->status[results->completed_ct++] = ERRINFO_STATUS(request->excp);
+   g_cond_broadcast(&results->cond);
+   g_mutex_unlock(&results->mutex);
+}
+
+
+/** Holds the executor thread in a request callback until opened */
+typedef struct {
+   GMutex      mutex;
+   GCond       cond;
+   bool        entered;
+   bool        opened;
+} Executor_Gate;
+
+
+static void wait_at_gate(Display_Request * request) {
+   Executor_Gate * gate = request->callback_data;
+   g_mutex_lock(&gate->mutex);
+   gate->entered = true;
+   g_cond_broadcast(&gate->cond);
+   while (!gate->opened)
+      g_cond_wait(&gate->cond, &gate->mutex);
+   g_mutex_unlock(&gate->mutex);
+}
+
+
+static void close_display_and_record_result(Display_Request * request) {
+   // runs on the executor thread, cancels the requests still queued for the handle
+   ddc_close_display(request->dh);
+   record_result(request);
+}
+
+
+/** Checks that #ddc_wait_display_requests_by_dh() called on another thread
+ *  returns only after the queued requests for the handle have completed.
+ */
+static int test_wait_by_dh(Display_Handle * dh) {
+   int failure_ct = 0;
+   Display_Async_Rec * async_rec = dh->dref->async_rec;
+
+   lock_display_lock(async_rec, true);
+   Display_Request * req1 = ddc_queue_get_vcp_request(
+                               dh, TEST_FEATURE_CODE, DDCA_NON_TABLE_VCP_VALUE, NULL, NULL);
+   Display_Request * req2 = ddc_queue_get_vcp_request(
+                               dh, TEST_FEATURE_CODE, DDCA_NON_TABLE_VCP_VALUE, NULL, NULL);
+   unlock_display_lock(async_rec);
+
+   ddc_wait_display_requests_by_dh(dh);
+   if (!testcase_check(req1->completed && req2->completed,
+                       "requests completed when ddc_wait_display_requests_by_dh() returns"))
+      failure_ct++;
+   ddc_wait_display_request(req1);
+   ddc_wait_display_request(req2);
+   if (!testcase_check(!req1->excp && req1->result_value &&
+                       req1->result_value->opcode == TEST_FEATURE_CODE,
+                       "get request returned value of feature 0x%02x, status: %s",
+                       TEST_FEATURE_CODE, errinfo_summary(req1->excp)))
+      failure_ct++;
+   ddc_free_display_request(req1);
+   ddc_free_display_request(req2);
+
+   return failure_ct;
+}
+
+
+/** Checks that a request callback can close its display handle, and that
+ *  the requests still queued for the handle are then cancelled.
+ */
+static int test_close_from_callback(Display_Handle * dh) {
+   int failure_ct = 0;
+   Display_Async_Rec * async_rec = dh->dref->async_rec;
+   // not freed if the callbacks time out, since they may still be called
+   Callback_Results * results = calloc(1, sizeof(Callback_Results));
+   g_mutex_init(&results->mutex);
+   g_cond_init(&results->cond);
+
+   lock_display_lock(async_rec, true);
+   ddc_queue_get_vcp_request(dh, TEST_FEATURE_CODE, DDCA_NON_TABLE_VCP_VALUE,
+                             close_display_and_record_result, results);
+   ddc_queue_get_vcp_request(dh, TEST_FEATURE_CODE, DDCA_NON_TABLE_VCP_VALUE,
+                             record_result, results);
+   ddc_queue_get_vcp_request(dh, TEST_FEATURE_CODE, DDCA_NON_TABLE_VCP_VALUE,
+                             record_result, results);
+   unlock_display_lock(async_rec);
+
+   // dh is closed by the first callback, and must no longer be used
+   g_mutex_lock(&results->mutex);
+   gint64 end_time = g_get_monotonic_time() + 10 * G_TIME_SPAN_SECOND;
+   while (results->completed_ct < 3) {
+      if (!g_cond_wait_until(&results->cond, &results->mutex, end_time))
+         break;
+   }
+   int completed_ct = results->completed_ct;
+   g_mutex_unlock(&results->mutex);
+
+   if (!testcase_check(completed_ct == 3, "all callbacks called, completed_ct = %d", completed_ct)) {
+      failure_ct++;
+   }
+   else {
+      // the queued requests are cancelled before the closing callback records its result
+      if (!testcase_check(results->status[0] == DDCRC_INVALID_OPERATION &&
+                          results->status[1] == DDCRC_INVALID_OPERATION,
+                          "queued requests cancelled, status: %s, %s",
+                          psc_name(results->status[0]), psc_name(results->status[1])))
+         failure_ct++;
+      if (!testcase_check(results->status[2] == 0,
+                          "closing request succeeded, status: %s", psc_name(results->status[2])))
+         failure_ct++;
+      g_mutex_clear(&results->mutex);
+      g_cond_clear(&results->cond);
+      free(results);
+   }
+   return failure_ct;
+}
+
+
+static int test_wait_then_close(Display_Handle * dh) {
+   int failure_ct = test_wait_by_dh(dh);
+   failure_ct += test_close_from_callback(dh);   // closes dh
+   return failure_ct;
+}
+
+
+/** Checks that set requests for the same feature queued while the executor
+ *  is busy are coalesced, so that only the last value is written.
+ */
+static int test_coalescing(Display_Handle * dh) {
+   int failure_ct = 0;
+
+   Display_Request * getreq = ddc_queue_get_vcp_request(
+                                 dh, TEST_FEATURE_CODE, DDCA_NON_TABLE_VCP_VALUE, NULL, NULL);
+   ddc_wait_display_request(getreq);
+   if (!testcase_check(!getreq->excp && getreq->result_value,
+                       "read current value, status: %s", errinfo_summary(getreq->excp)))
+   {
+      ddc_free_display_request(getreq);
+      return failure_ct+1;
+   }
+   DDCA_Any_Vcp_Value * curval = getreq->result_value;
+
+   Executor_Gate gate = {0};
+   g_mutex_init(&gate.mutex);
+   g_cond_init(&gate.cond);
+   // occupies the executor until the gate is opened, freed by the executor
+   ddc_queue_get_vcp_request(dh, TEST_FEATURE_CODE, DDCA_NON_TABLE_VCP_VALUE, wait_at_gate, &gate);
+   g_mutex_lock(&gate.mutex);
+   while (!gate.entered)
+      g_cond_wait(&gate.cond, &gate.mutex);
+   g_mutex_unlock(&gate.mutex);
+
+   bool saved_coalescing = ddc_enable_setvcp_coalescing(true);
+   Display_Request * setreqs[3];
+   for (int ndx = 0; ndx < 3; ndx++)
+      setreqs[ndx] = ddc_queue_set_vcp_request(dh, clone_single_vcp_value(curval), NULL, NULL);
+   ddc_enable_setvcp_coalescing(saved_coalescing);
+
+   g_mutex_lock(&gate.mutex);
+   gate.opened = true;
+   g_cond_broadcast(&gate.cond);
+   g_mutex_unlock(&gate.mutex);
+   // the set requests execute only after the callback has returned
+   for (int ndx = 0; ndx < 3; ndx++)
+      ddc_wait_display_request(setreqs[ndx]);
+   g_mutex_clear(&gate.mutex);
+   g_cond_clear(&gate.cond);
+
+   if (!testcase_check(setreqs[0]->coalesced && setreqs[1]->coalesced && !setreqs[2]->coalesced,
+                       "first two set requests coalesced with the last"))
+      failure_ct++;
+   for (int ndx = 0; ndx < 3; ndx++) {
+      Display_Request * req = setreqs[ndx];
+      if (!testcase_check(!req->excp && req->result_value &&
+                          req->result_value->val.c_nc.sh == curval->val.c_nc.sh &&
+                          req->result_value->val.c_nc.sl == curval->val.c_nc.sl,
+                          "set request %d reports value written, status: %s",
+                          ndx+1, errinfo_summary(req->excp)))
+         failure_ct++;
+   }
+
+   for (int ndx = 0; ndx < 3; ndx++)
+      ddc_free_display_request(setreqs[ndx]);
+   ddc_free_display_request(getreq);
+   return failure_ct;
+}
+
+
+/** Tests coalescing of queued set requests for the same feature.
+ *  The current value of feature x10 is rewritten.
+ *
+ *  \param  busno  I2C bus number of display to test
+ */
+void test_request_queue_coalescing(int busno) {
+   testcase_run_on_display(__func__, busno, test_coalescing);
+}
+
+
+/** Tests waiting for the queued requests of a display handle, both on
+ *  another thread and on the executor thread when a callback closes
+ *  the handle.
+ *
+ *  \param  busno  I2C bus number of display to test
+ */
+void test_request_queue_wait_by_dh(int busno) {
+   testcase_run_on_display(__func__, busno, test_wait_then_close);
+}
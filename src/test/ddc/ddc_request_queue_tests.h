@@ -0,0 +1,15 @@
+/** @file ddc_request_queue_tests.h
+ *
+ *  Testcases for the per-display request queue.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_REQUEST_QUEUE_TESTS_H_
+#define DDC_REQUEST_QUEUE_TESTS_H_
+
+void test_request_queue_wait_by_dh(int busno);
+void test_request_queue_coalescing(int busno);
+
+#endif /* DDC_REQUEST_QUEUE_TESTS_H_ */
@@ -0,0 +1,163 @@
+/** @file ddc_vcp_value_cache_tests.c
+ *
+ *  Testcases for the VCP value cache.
+ *
+ *  Values are recorded directly in the cache of a display reference that
+ *  is not associated with a display, so no monitor is required.  The
+ *  feature volatility classes used are those of the VCP feature table:
+ *  x10 and x12 are TTL, xDF is static, x60 is live.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "base/ddc_packets.h"
+#include "base/displays.h"
+
+#include "ddc/ddc_vcp_value_cache.h"
+
+#include "test/testcases.h"
+
+#include "test/ddc/ddc_vcp_value_cache_tests.h"
+
+
+// not a real bus, the display reference is never opened
+#define TEST_BUSNO  255
+
+#define TEST_TTL_MILLIS  50
+
+
+static void note_value(Display_Ref * dref, DDCA_Vcp_Feature_Code feature_code, Byte sl) {
+   Parsed_Nontable_Vcp_Response response = {
+         .vcp_code         = feature_code,
+         .valid_response   = true,
+         .supported_opcode = true,
+         .max_value        = 100,
+         .cur_value        = sl,
+         .mh = 0, .ml = 100, .sh = 0, .sl = sl };
+   ddc_note_vcp_value(dref, &response);
+}
+
+
+// Returns true if a value for the feature is cached, checking the value if so
+static bool is_cached(Display_Ref * dref, DDCA_Vcp_Feature_Code feature_code, Byte expected_sl) {
+   Parsed_Nontable_Vcp_Response * response = NULL;
+   bool found = ddc_get_cached_vcp_value(dref, feature_code, &response);
+   if (found) {
+      found = (response->vcp_code == feature_code && response->sl == expected_sl);
+      free(response);
+   }
+   return found;
+}
+
+
+static int test_volatility_classes(Display_Ref * dref) {
+   int failure_ct = 0;
+
+   note_value(dref, 0x10, 40);
+   note_value(dref, 0xdf, 0x21);
+   note_value(dref, 0x60, 0x0f);
+   if (!testcase_check(is_cached(dref, 0x10, 40), "TTL feature x10 cached"))
+      failure_ct++;
+   if (!testcase_check(is_cached(dref, 0xdf, 0x21), "static feature xDF cached"))
+      failure_ct++;
+   if (!testcase_check(!is_cached(dref, 0x60, 0x0f), "live feature x60 not cached"))
+      failure_ct++;
+
+   usleep(2 * TEST_TTL_MILLIS * 1000);
+   if (!testcase_check(!is_cached(dref, 0x10, 40), "x10 expired after TTL"))
+      failure_ct++;
+   if (!testcase_check(is_cached(dref, 0xdf, 0x21), "xDF does not expire"))
+      failure_ct++;
+
+   note_value(dref, 0x10, 41);
+   if (!testcase_check(is_cached(dref, 0x10, 41), "x10 cached again with new value"))
+      failure_ct++;
+
+   ddc_invalidate_cached_vcp_values(dref, true);
+   return failure_ct;
+}
+
+
+static int test_invalidation(Display_Ref * dref) {
+   int failure_ct = 0;
+
+   note_value(dref, 0x10, 40);
+   note_value(dref, 0x12, 50);
+   note_value(dref, 0xdf, 0x21);
+   ddc_note_vcp_write(dref, 0x10);
+   if (!testcase_check(!is_cached(dref, 0x10, 40) && is_cached(dref, 0x12, 50),
+                       "writing x10 invalidates only x10"))
+      failure_ct++;
+
+   note_value(dref, 0x52, 0x12);
+   if (!testcase_check(!is_cached(dref, 0x12, 50),
+                       "x52 (Active Control) reporting x12 invalidates x12"))
+      failure_ct++;
+
+   note_value(dref, 0x10, 40);
+   note_value(dref, 0x12, 50);
+   note_value(dref, 0x02, 0x02);
+   if (!testcase_check(!is_cached(dref, 0x10, 40) && !is_cached(dref, 0x12, 50),
+                       "x02 (New Control Value) invalidates non-static features"))
+      failure_ct++;
+   if (!testcase_check(is_cached(dref, 0xdf, 0x21), "x02 does not invalidate static feature xDF"))
+      failure_ct++;
+
+   note_value(dref, 0x10, 40);
+   ddc_note_vcp_write(dref, 0x04);
+   if (!testcase_check(!is_cached(dref, 0x10, 40) && is_cached(dref, 0xdf, 0x21),
+                       "writing x04 (Restore factory defaults) invalidates non-static features"))
+      failure_ct++;
+
+   ddc_invalidate_cached_vcp_values(dref, true);
+   if (!testcase_check(!is_cached(dref, 0xdf, 0x21), "static feature invalidated when requested"))
+      failure_ct++;
+
+   return failure_ct;
+}
+
+
+static int test_disabled(Display_Ref * dref) {
+   int failure_ct = 0;
+
+   note_value(dref, 0x10, 40);
+   enable_vcp_value_cache(false);
+   if (!testcase_check(!is_cached(dref, 0x10, 40), "no value returned when cache disabled"))
+      failure_ct++;
+   note_value(dref, 0x12, 50);
+   enable_vcp_value_cache(true);
+   if (!testcase_check(!is_cached(dref, 0x12, 50), "no value recorded when cache disabled"))
+      failure_ct++;
+
+   ddc_invalidate_cached_vcp_values(dref, true);
+   return failure_ct;
+}
+
+
+/** Tests the handling of the feature volatility classes, TTL expiry,
+ *  and invalidation of cached values by writes and by change
+ *  notifications.
+ */
+void test_vcp_value_cache() {
+   int failure_ct = 0;
+   bool saved_enabled = enable_vcp_value_cache(true);
+   int  saved_ttl     = get_vcp_value_cache_ttl();
+   set_vcp_value_cache_ttl(TEST_TTL_MILLIS);
+
+   Display_Ref * dref = create_bus_display_ref(TEST_BUSNO);
+   dref->flags |= DREF_TRANSIENT;
+   failure_ct += test_volatility_classes(dref);
+   failure_ct += test_invalidation(dref);
+   failure_ct += test_disabled(dref);
+   free_display_ref(dref);
+
+   set_vcp_value_cache_ttl(saved_ttl);
+   enable_vcp_value_cache(saved_enabled);
+   testcase_report_result(__func__, failure_ct);
+}
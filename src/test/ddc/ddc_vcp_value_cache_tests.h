@@ -0,0 +1,14 @@
+/** @file ddc_vcp_value_cache_tests.h
+ *
+ *  Testcases for the VCP value cache.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_VCP_VALUE_CACHE_TESTS_H_
+#define DDC_VCP_VALUE_CACHE_TESTS_H_
+
+void test_vcp_value_cache();
+
+#endif /* DDC_VCP_VALUE_CACHE_TESTS_H_ */
@@ -23,9 +23,16 @@
 
 #include <config.h>
 
+#include "app_ddcutil/app_daemon_tests.h"
 #include "ddc/ddc_capabilities_tests.h"
+#include "ddc/ddc_deferred_verify_tests.h"
+#include "ddc/ddc_dumpload_tests.h"
+#include "ddc/ddc_request_queue_tests.h"
 #include "ddc/ddc_vcp_tests.h"
+#include "ddc/ddc_vcp_value_cache_tests.h"
 #include "i2c/i2c_edid_tests.h"
+#include "util/file_util_tests.h"
+#include "vcp/vcp_feature_codes_tests.h"
 
 #include "testcase_table.h"
 
@@ -33,7 +40,15 @@ Testcase_Descriptor testcase_catalog[] = {
       {"get_luminosity_sample_code",        DisplayRefBus,  NULL, get_luminosity_sample_code, NULL, NULL},
       {"get_luminosity_using_single_ioctl", DisplayRefBus,  NULL, get_luminosity_using_single_ioctl, NULL, NULL},
       {"demo_nvidia_bug_sample_code",       DisplayRefBus,  NULL, demo_nvidia_bug_sample_code, NULL, NULL},
-      {"demo_p2411_problem",                DisplayRefBus,  NULL, demo_p2411_problem, NULL, NULL}
+      {"demo_p2411_problem",                DisplayRefBus,  NULL, demo_p2411_problem, NULL, NULL},
+      {"request_queue_wait_by_dh",          DisplayRefBus,  NULL, test_request_queue_wait_by_dh, NULL, NULL},
+      {"file_util_locking_and_atomic_write",DisplayRefNone, test_file_util_locking_and_atomic_write, NULL, NULL, NULL},
+      {"vcp_feature_table_indexes",         DisplayRefNone, test_vcp_feature_table_indexes, NULL, NULL, NULL},
+      {"vcp_value_cache",                   DisplayRefNone, test_vcp_value_cache, NULL, NULL, NULL},
+      {"daemon_forward_getvcp",             DisplayRefBus,  NULL, test_daemon_forward_getvcp, NULL, NULL},
+      {"request_queue_coalescing",          DisplayRefBus,  NULL, test_request_queue_coalescing, NULL, NULL},
+      {"deferred_verify",                   DisplayRefBus,  NULL, test_deferred_verify, NULL, NULL},
+      {"find_changed_values",               DisplayRefBus,  NULL, test_find_changed_values, NULL, NULL}
 };
 int testcase_catalog_ct = sizeof(testcase_catalog)/sizeof(Testcase_Descriptor);
 
@@ -24,12 +24,16 @@
  */
 
 #include <config.h>
+#include <stdarg.h>
 #include <stdio.h>
 
 #include "base/core.h"
 
 #include "adl/adl_shim.h"
 
+#include "ddc/ddc_displays.h"
+#include "ddc/ddc_packet_io.h"
+
 #include "test/testcase_table.h"
 
 #include <test/testcases.h>
@@ -134,3 +138,76 @@ bool execute_testcase(int testnum, Display_Identifier* pdid) {
 
      return ok;
 }
+
+
+/** Reports the result of a single check made by a testcase.
+ *
+ *  \param  ok      result of the check
+ *  \param  format  printf() style description of what was checked
+ *  \return **ok**
+ */
+bool testcase_check(bool ok, const char * format, ...) {
+   va_list args;
+   va_start(args, format);
+   printf("   %-7s ", (ok) ? "ok:" : "FAILED:");
+   vprintf(format, args);
+   puts("");
+   va_end(args);
+   return ok;
+}
+
+
+/** Reports the overall result of a testcase.
+ *
+ *  \param  testcase_name  testcase name
+ *  \param  failure_ct     number of checks that failed
+ */
+void testcase_report_result(const char * testcase_name, int failure_ct) {
+   if (failure_ct == 0)
+      printf("%s: PASSED\n", testcase_name);
+   else
+      printf("%s: FAILED, %d check(s) failed\n", testcase_name, failure_ct);
+}
+
+
+/** Opens the detected display on an I2C bus, for testcases that
+ *  exercise the DDC layer.
+ *
+ *  \param  busno  I2C bus number
+ *  \return display handle, NULL if the display cannot be opened
+ */
+Display_Handle * testcase_open_display(int busno) {
+   Display_Handle * dh = NULL;
+   Display_Identifier * pdid = create_busno_display_identifier(busno);
+   Display_Ref * dref = get_display_ref_for_display_identifier(pdid, CALLOPT_ERR_MSG);
+   if (dref) {
+      DDCA_Status rc = ddc_open_display(dref, CALLOPT_ERR_MSG, &dh);
+      if (rc != 0)
+         dh = NULL;
+   }
+   free_display_identifier(pdid);
+   return dh;
+}
+
+
+/** Opens the detected display on an I2C bus, executes a testcase
+ *  function with it, closes the display, and reports the result.
+ *  Failure to open the display counts as a failed check.
+ *
+ *  \param  testcase_name  testcase name
+ *  \param  busno          I2C bus number
+ *  \param  func           function to execute, may close the display itself
+ */
+void testcase_run_on_display(const char * testcase_name, int busno, Testcase_Display_Func func) {
+   int failure_ct = 0;
+   Display_Handle * dh = testcase_open_display(busno);
+   if (!dh) {
+      failure_ct++;
+   }
+   else {
+      failure_ct += func(dh);
+      if (ddc_is_valid_display_handle(dh))
+         ddc_close_display(dh);
+   }
+   testcase_report_result(testcase_name, failure_ct);
+}
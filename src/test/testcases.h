@@ -33,4 +33,12 @@
 void show_test_cases();
 bool execute_testcase(int testnum, Display_Identifier* pdid);
 
+/** Function executed by #testcase_run_on_display(), returns the number of failed checks */
+typedef int (*Testcase_Display_Func)(Display_Handle * dh);
+
+bool             testcase_check(bool ok, const char * format, ...);
+void             testcase_report_result(const char * testcase_name, int failure_ct);
+Display_Handle * testcase_open_display(int busno);
+void             testcase_run_on_display(const char * testcase_name, int busno, Testcase_Display_Func func);
+
 #endif /* TESTCASES_H_ */
@@ -0,0 +1,177 @@
+/** @file file_util_tests.c
+ *
+ *  Testcases for the file locking and atomic write functions used by
+ *  the cache files.  Files are created in a temporary directory.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <errno.h>
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "util/file_util.h"
+#include "util/string_util.h"
+
+#include "test/testcases.h"
+
+#include "test/util/file_util_tests.h"
+
+
+static bool write_lines(FILE * fp, void * data) {
+   char ** lines = data;
+   for (int ndx = 0; lines[ndx]; ndx++)
+      fprintf(fp, "%s\n", lines[ndx]);
+   return true;
+}
+
+
+static bool fail_after_partial_write(FILE * fp, void * data) {
+   fprintf(fp, "partial\n");
+   return false;
+}
+
+
+static bool file_contents_equal(const char * path, const char * expected) {
+   gchar * contents = NULL;
+   bool result = g_file_get_contents(path, &contents, NULL, NULL) && streq(contents, expected);
+   g_free(contents);
+   return result;
+}
+
+
+static int count_directory_entries(const char * dirname) {
+   int ct = 0;
+   GDir * dir = g_dir_open(dirname, 0, NULL);
+   if (dir) {
+      while (g_dir_read_name(dir))
+         ct++;
+      g_dir_close(dir);
+   }
+   return ct;
+}
+
+
+// Removes the files created by the testcases, and the directory
+static void remove_test_directory(const char * dirname) {
+   GDir * dir = g_dir_open(dirname, 0, NULL);
+   if (dir) {
+      const char * fn;
+      while ( (fn = g_dir_read_name(dir)) ) {
+         char * path = g_build_filename(dirname, fn, NULL);
+         if (g_file_test(path, G_FILE_TEST_IS_DIR))
+            remove_test_directory(path);
+         else
+            unlink(path);
+         g_free(path);
+      }
+      g_dir_close(dir);
+   }
+   rmdir(dirname);
+}
+
+
+static int test_write_file_atomically(const char * dirname) {
+   int failure_ct = 0;
+   char * path = g_build_filename(dirname, "subdir", "data", NULL);
+
+   char * lines1[] = {"line 1", "line 2", NULL};
+   int rc = write_file_atomically(path, write_lines, lines1, stdout);
+   if (!testcase_check(rc == 0 && file_contents_equal(path, "line 1\nline 2\n"),
+                       "new file written, creating parent directory, rc=%d", rc))
+      failure_ct++;
+
+   struct stat statbuf;
+   if (!testcase_check(stat(path, &statbuf) == 0 && (statbuf.st_mode & 0777) == 0644,
+                       "file mode is 0644"))
+      failure_ct++;
+
+   char * lines2[] = {"replaced", NULL};
+   rc = write_file_atomically(path, write_lines, lines2, stdout);
+   if (!testcase_check(rc == 0 && file_contents_equal(path, "replaced\n"),
+                       "existing file replaced, rc=%d", rc))
+      failure_ct++;
+
+   rc = write_file_atomically(path, fail_after_partial_write, NULL, NULL);
+   if (!testcase_check(rc == -EIO, "writer failure returns -EIO, rc=%d", rc))
+      failure_ct++;
+   if (!testcase_check(file_contents_equal(path, "replaced\n"),
+                       "file unchanged after writer failure"))
+      failure_ct++;
+
+   char * subdir = g_path_get_dirname(path);
+   int ct = count_directory_entries(subdir);
+   if (!testcase_check(ct == 1, "no temporary files left, directory entries: %d", ct))
+      failure_ct++;
+
+   g_free(subdir);
+   g_free(path);
+   return failure_ct;
+}
+
+
+static int test_file_lock(const char * dirname) {
+   int failure_ct = 0;
+   char * path = g_build_filename(dirname, "locks", "test.lock", NULL);
+
+   int shared1 = file_lock(path, false, stdout);
+   if (!testcase_check(shared1 >= 0, "shared lock obtained, creating parent directory, rc=%d", shared1))
+      failure_ct++;
+
+   int shared2 = file_lock_timed(path, false, 0, stdout);
+   if (!testcase_check(shared2 >= 0, "second shared lock obtained while first is held, rc=%d", shared2))
+      failure_ct++;
+
+   int excl = file_lock_timed(path, true, 0, stdout);
+   if (!testcase_check(excl == -EWOULDBLOCK, "exclusive lock not obtained while shared lock held, rc=%d", excl))
+      failure_ct++;
+   file_unlock(excl);       // no-op unless the check failed
+
+   excl = file_lock_timed(path, true, 50, stdout);
+   if (!testcase_check(excl == -EWOULDBLOCK, "exclusive lock times out while shared lock held, rc=%d", excl))
+      failure_ct++;
+   file_unlock(excl);
+
+   file_unlock(shared1);
+   file_unlock(shared2);
+
+   excl = file_lock_timed(path, true, 0, stdout);
+   if (!testcase_check(excl >= 0, "exclusive lock obtained after shared locks released, rc=%d", excl))
+      failure_ct++;
+
+   int shared3 = file_lock_timed(path, false, 0, stdout);
+   if (!testcase_check(shared3 == -EWOULDBLOCK, "shared lock not obtained while exclusive lock held, rc=%d", shared3))
+      failure_ct++;
+   file_unlock(shared3);
+   file_unlock(excl);
+
+   g_free(path);
+   return failure_ct;
+}
+
+
+/** Tests #write_file_atomically(), #file_lock(), #file_lock_timed()
+ *  and #file_unlock().
+ */
+void test_file_util_locking_and_atomic_write() {
+   int failure_ct = 0;
+   GError * error = NULL;
+   char * dirname = g_dir_make_tmp("ddcutil-test-XXXXXX", &error);
+   if (!dirname) {
+      testcase_check(false, "create temporary directory: %s", error->message);
+      g_error_free(error);
+      failure_ct++;
+   }
+   else {
+      failure_ct += test_write_file_atomically(dirname);
+      failure_ct += test_file_lock(dirname);
+      remove_test_directory(dirname);
+      g_free(dirname);
+   }
+   testcase_report_result(__func__, failure_ct);
+}
@@ -0,0 +1,14 @@
+/** @file file_util_tests.h
+ *
+ *  Testcases for the file locking and atomic write functions.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef FILE_UTIL_TESTS_H_
+#define FILE_UTIL_TESTS_H_
+
+void test_file_util_locking_and_atomic_write();
+
+#endif /* FILE_UTIL_TESTS_H_ */
@@ -0,0 +1,142 @@
+/** @file vcp_feature_codes_tests.c
+ *
+ *  Testcases for the indexes into the VCP feature table.
+ *  Each lookup is compared with the result of searching the table.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "public/ddcutil_types.h"
+
+#include "vcp/vcp_feature_codes.h"
+
+#include "test/testcases.h"
+
+#include "test/vcp/vcp_feature_codes_tests.h"
+
+
+// First table entry for a feature code, as found by a linear search
+static VCP_Feature_Table_Entry * search_table_by_code(DDCA_Vcp_Feature_Code id) {
+   int ct = vcp_get_feature_code_count();
+   for (int ndx = 0; ndx < ct; ndx++) {
+      VCP_Feature_Table_Entry * vfte = vcp_get_feature_table_entry(ndx);
+      if (vfte->code == id)
+         return vfte;
+   }
+   return NULL;
+}
+
+
+// Version sensitive flags, computed as before the flags were indexed
+static DDCA_Version_Feature_Flags
+compute_sensitive_flags(VCP_Feature_Table_Entry * vfte, DDCA_MCCS_Version_Spec vspec) {
+   DDCA_Version_Feature_Flags result = get_version_specific_feature_flags(vfte, vspec);
+   if (!result)
+      result = (vfte->v21_flags) ? vfte->v21_flags :
+               (vfte->v30_flags) ? vfte->v30_flags : vfte->v22_flags;
+   return result;
+}
+
+
+static bool entry_has_name(VCP_Feature_Table_Entry * vfte, const char * name) {
+   char * names[] = {vfte->v20_name, vfte->v21_name, vfte->v30_name, vfte->v22_name};
+   for (int ndx = 0; ndx < 4; ndx++) {
+      if (names[ndx] && g_ascii_strcasecmp(names[ndx], name) == 0)
+         return true;
+   }
+   return false;
+}
+
+
+static int test_lookup_by_code() {
+   int failure_ct = 0;
+   int mismatch_ct = 0;
+   for (int code = 0; code < 256; code++) {
+      VCP_Feature_Table_Entry * expected = search_table_by_code(code);
+      VCP_Feature_Table_Entry * found    = vcp_find_feature_by_hexid(code);
+      if (found != expected) {
+         testcase_check(false, "vcp_find_feature_by_hexid(0x%02x) returned %p, expected %p",
+                               code, found, expected);
+         mismatch_ct++;
+      }
+   }
+   if (!testcase_check(mismatch_ct == 0, "lookup by code matches table search for all codes"))
+      failure_ct++;
+   return failure_ct;
+}
+
+
+static int test_version_sensitive_flags() {
+   DDCA_MCCS_Version_Spec vspecs[] = {
+         {0,0}, {1,0}, {2,0}, {2,1}, {2,2}, {2,3}, {3,0}, {3,1} };
+   int vspec_ct = sizeof(vspecs)/sizeof(DDCA_MCCS_Version_Spec);
+
+   int failure_ct = 0;
+   int mismatch_ct = 0;
+   int ct = vcp_get_feature_code_count();
+   for (int ndx = 0; ndx < ct; ndx++) {
+      VCP_Feature_Table_Entry * vfte = vcp_get_feature_table_entry(ndx);
+      for (int vndx = 0; vndx < vspec_ct; vndx++) {
+         DDCA_Version_Feature_Flags expected = compute_sensitive_flags(vfte, vspecs[vndx]);
+         DDCA_Version_Feature_Flags found    = get_version_sensitive_feature_flags(vfte, vspecs[vndx]);
+         if (found != expected) {
+            testcase_check(false, "feature 0x%02x, version %d.%d: flags 0x%04x, expected 0x%04x",
+                                  vfte->code, vspecs[vndx].major, vspecs[vndx].minor, found, expected);
+            mismatch_ct++;
+         }
+      }
+   }
+   if (!testcase_check(mismatch_ct == 0, "indexed version sensitive flags match computed flags"))
+      failure_ct++;
+   return failure_ct;
+}
+
+
+static int test_lookup_by_name() {
+   int failure_ct = 0;
+   int mismatch_ct = 0;
+   int ct = vcp_get_feature_code_count();
+   for (int ndx = 0; ndx < ct; ndx++) {
+      VCP_Feature_Table_Entry * vfte = vcp_get_feature_table_entry(ndx);
+      char * names[] = {vfte->v20_name, vfte->v21_name, vfte->v30_name, vfte->v22_name};
+      for (int nndx = 0; nndx < 4; nndx++) {
+         if (!names[nndx])
+            continue;
+         // if names are shared, the first entry with the name is found
+         VCP_Feature_Table_Entry * found = vcp_find_feature_by_name(names[nndx]);
+         char * uc_name = g_ascii_strup(names[nndx], -1);
+         VCP_Feature_Table_Entry * found_uc = vcp_find_feature_by_name(uc_name);
+         if (!found || !entry_has_name(found, names[nndx]) || found_uc != found) {
+            testcase_check(false, "feature 0x%02x, name \"%s\" not found", vfte->code, names[nndx]);
+            mismatch_ct++;
+         }
+         g_free(uc_name);
+      }
+   }
+   if (!testcase_check(mismatch_ct == 0, "every feature name found, ignoring case"))
+      failure_ct++;
+
+   VCP_Feature_Table_Entry * vfte = vcp_find_feature_by_name("luminosity");
+   if (!testcase_check(vfte && vfte->code == 0x10, "MCCS 3.0 name \"luminosity\" finds feature 0x10"))
+      failure_ct++;
+   if (!testcase_check(!vcp_find_feature_by_name("no such feature"), "unknown name not found"))
+      failure_ct++;
+   return failure_ct;
+}
+
+
+/** Tests lookup of VCP feature table entries by code and by name, and
+ *  the indexed version sensitive feature flags.
+ */
+void test_vcp_feature_table_indexes() {
+   int failure_ct = 0;
+   failure_ct += test_lookup_by_code();
+   failure_ct += test_version_sensitive_flags();
+   failure_ct += test_lookup_by_name();
+   testcase_report_result(__func__, failure_ct);
+}
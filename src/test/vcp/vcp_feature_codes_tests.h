@@ -0,0 +1,14 @@
+/** @file vcp_feature_codes_tests.h
+ *
+ *  Testcases for the indexes into the VCP feature table.
+ */
+
+// Copyright (C) 2022 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef VCP_FEATURE_CODES_TESTS_H_
+#define VCP_FEATURE_CODES_TESTS_H_
+
+void test_vcp_feature_table_indexes();
+
+#endif /* VCP_FEATURE_CODES_TESTS_H_ */
@@ -406,6 +406,20 @@ Byte_Bit_Flags bbf_subtract(Byte_Bit_Flags bbflags1, Byte_Bit_Flags bbflags2) {
 }
 
 
+/** Creates a copy of a **Byte_Bit_Flags** instance.
+ *
+ * @param bbflags instance handle
+ * @return newly created instance
+ */
+Byte_Bit_Flags bbf_copy(Byte_Bit_Flags bbflags) {
+   BYTE_BIT_UNOPAQUE(flags, bbflags);
+   BYTE_BIT_VALIDATE(flags);
+   _ByteBitFlags * result = bbf_create();
+   memcpy(result->byte, flags->byte, BYTE_BIT_BYTE_CT);
+   return result;
+}
+
+
 
 /** Returns a 64 character long hex string representing the data structure.
  *
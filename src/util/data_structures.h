@@ -55,6 +55,7 @@ void           bbf_free(Byte_Bit_Flags flags);
 void           bbf_set(Byte_Bit_Flags flags, Byte val);
 bool           bbf_is_set(Byte_Bit_Flags flags, Byte val);
 Byte_Bit_Flags bbf_subtract(Byte_Bit_Flags bbflags1, Byte_Bit_Flags bbflags2);
+Byte_Bit_Flags bbf_copy(Byte_Bit_Flags bbflags);
 char *         bbf_repr(Byte_Bit_Flags flags, char * buffer, int buflen);
 int            bbf_count_set(Byte_Bit_Flags flags);  // number of bits set
 int            bbf_to_bytes(Byte_Bit_Flags  flags, Byte * buffer, int buflen);
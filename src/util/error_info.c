@@ -338,6 +338,29 @@ errinfo_new2(
 }
 
 
+/** Creates a copy of an #Error_Info instance, including copies of
+ *  all the instances it points to.
+ *
+ *  \param  erec  pointer to instance to copy, may be NULL
+ *  \return pointer to new instance, NULL if **erec** is NULL
+ */
+Error_Info *
+errinfo_copy(
+      Error_Info *   erec)
+{
+   Error_Info * result = NULL;
+   if (erec) {
+      VALID_DDC_ERROR_PTR(erec);
+      result = (erec->detail)
+                  ? errinfo_new2(erec->status_code, erec->func, "%s", erec->detail)
+                  : errinfo_new(erec->status_code, erec->func);
+      for (int ndx = 0; ndx < erec->cause_ct; ndx++)
+         errinfo_add_cause(result, errinfo_copy(erec->causes[ndx]));
+   }
+   return result;
+}
+
+
 /** Creates a new #Error_Info instance, including a reference to another
  *  instance that is the cause of the current error.
  *
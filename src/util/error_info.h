@@ -68,6 +68,9 @@ Error_Info * errinfo_new2(
       const char *   detail,
       ...);
 
+Error_Info * errinfo_copy(
+      Error_Info *   erec);
+
 Error_Info * errinfo_new_with_cause(
       int            status_code,
       Error_Info *   cause,
@@ -9,11 +9,13 @@
 #include <assert.h>
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <glib-2.0/glib.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/file.h>
 #include <sys/stat.h>
 #include <unistd.h>
 /** \endcond */
@@ -735,3 +737,200 @@ int fopen_mkdir(
    return rc;
 }
 
+
+/** Opens a lock file, creating it and its parent directories if necessary,
+ *  and acquires an advisory lock on it using flock(), waiting at most
+ *  a specified time for the lock to become available.
+ *
+ *  \param  path            lock file name
+ *  \param  exclusive       if true acquire an exclusive lock, otherwise a shared lock
+ *  \param  timeout_millis  maximum wait in milliseconds, < 0 to wait indefinitely
+ *  \param  ferr            if non-null, destination for error messages
+ *  \return file descriptor holding the lock if successful, -errno if error,
+ *          -EWOULDBLOCK if the lock was not obtained within the timeout
+ *
+ *  \remark
+ *  The lock is released by #file_unlock(), or when the process terminates.
+ */
+int file_lock_timed(
+      const char * path,
+      bool         exclusive,
+      int          timeout_millis,
+      FILE *       ferr)
+{
+   int rc = 0;
+   char *sep = strrchr(path, '/');
+   if (sep) {
+      char *path0 = strdup(path);
+      path0[ sep - path ] = 0;
+      rc = rek_mkdir(path0, ferr);
+      free(path0);
+   }
+   if (rc == 0) {
+      int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+      if (fd < 0) {
+         rc = -errno;
+         f0printf(ferr, "Unable to open lock file %s: %s\n", path, strerror(errno));
+      }
+      else {
+         int op = (exclusive) ? LOCK_EX : LOCK_SH;
+         if (timeout_millis < 0) {
+            while ( (rc = flock(fd, op)) < 0 && errno == EINTR )
+               ;
+         }
+         else {
+            // poll, since flock() has no timeout
+            int waited_millis = 0;
+            while ( (rc = flock(fd, op | LOCK_NB)) < 0 &&
+                    (errno == EWOULDBLOCK || errno == EINTR) &&
+                    waited_millis < timeout_millis )
+            {
+               usleep(10*1000);
+               waited_millis += 10;
+            }
+         }
+         if (rc < 0) {
+            rc = -errno;
+            if (rc != -EWOULDBLOCK)
+               f0printf(ferr, "Unable to lock %s: %s\n", path, strerror(errno));
+            close(fd);
+         }
+         else
+            rc = fd;
+      }
+   }
+   return rc;
+}
+
+
+/** Opens a lock file, creating it and its parent directories if necessary,
+ *  and acquires an advisory lock on it using flock().  Blocks until the
+ *  lock is obtained.
+ *
+ *  \param  path       lock file name
+ *  \param  exclusive  if true acquire an exclusive lock, otherwise a shared lock
+ *  \param  ferr       if non-null, destination for error messages
+ *  \return file descriptor holding the lock if successful, -errno if error
+ *
+ *  \remark
+ *  The lock is released by #file_unlock(), or when the process terminates.
+ */
+int file_lock(
+      const char * path,
+      bool         exclusive,
+      FILE *       ferr)
+{
+   return file_lock_timed(path, exclusive, -1, ferr);
+}
+
+
+/** Releases a lock obtained by #file_lock().
+ *
+ *  \param  lockfd  file descriptor returned by #file_lock()
+ */
+void file_unlock(int lockfd) {
+   if (lockfd >= 0) {
+      flock(lockfd, LOCK_UN);
+      close(lockfd);
+   }
+}
+
+
+/** Checks that a directory is private to the current user, i.e. that it is
+ *  a directory (not a symbolic link), is owned by the current user, and
+ *  cannot be accessed by other users.  Optionally creates it, with mode 0700,
+ *  if it does not exist.
+ *
+ *  Directories in shared locations such as /tmp can be created by any user.
+ *  Files in them, e.g. sockets or lock files, should be trusted only if
+ *  this check succeeds.
+ *
+ *  \param  path    directory name
+ *  \param  create  if true, create the directory if it does not exist
+ *  \param  ferr    if non-null, destination for error messages
+ *  \return 0 if successful, -errno if error,
+ *          -EPERM if the directory has the wrong type, owner, or mode
+ */
+int private_directory_check(
+      const char * path,
+      bool         create,
+      FILE *       ferr)
+{
+   int rc = 0;
+   if (create && mkdir(path, 0700) < 0 && errno != EEXIST) {
+      rc = -errno;
+      f0printf(ferr, "Unable to create '%s', %s\n", path, strerror(errno));
+   }
+   if (rc == 0) {
+      struct stat statbuf;
+      if (lstat(path, &statbuf) < 0) {
+         rc = -errno;
+         f0printf(ferr, "Unable to stat '%s', %s\n", path, strerror(errno));
+      }
+      else if (!S_ISDIR(statbuf.st_mode)   ||
+               statbuf.st_uid != getuid()  ||
+               (statbuf.st_mode & 0077) != 0)
+      {
+         rc = -EPERM;
+         f0printf(ferr, "'%s' is not a directory owned by and accessible only by the current user\n", path);
+      }
+   }
+   return rc;
+}
+
+
+/** Writes a file by creating a temporary file in the same directory and
+ *  renaming it, so that readers see either the old or the new contents
+ *  but never a partially written file.
+ *
+ *  \param  path       file name
+ *  \param  write_func function that writes the contents to an open file,
+ *                     returns false if an error occurred
+ *  \param  data       passed to **write_func**
+ *  \param  ferr       if non-null, destination for error messages
+ *  \return 0 if successful, -errno if error
+ */
+int write_file_atomically(
+      const char *         path,
+      File_Writer_Func     write_func,
+      void *               data,
+      FILE *               ferr)
+{
+   char * tmp_path = g_strdup_printf("%s.XXXXXX", path);
+   int rc = 0;
+   char *sep = strrchr(path, '/');
+   if (sep) {
+      char *path0 = strdup(path);
+      path0[ sep - path ] = 0;
+      rc = rek_mkdir(path0, ferr);
+      free(path0);
+   }
+   if (rc == 0) {
+      int fd = mkstemp(tmp_path);
+      if (fd < 0) {
+         rc = -errno;
+         f0printf(ferr, "Unable to create %s: %s\n", tmp_path, strerror(errno));
+      }
+      else {
+         fchmod(fd, 0644);
+         FILE * fp = fdopen(fd, "w");
+         bool ok = write_func(fp, data);
+         if (fflush(fp) != 0 || fsync(fd) != 0)
+            ok = false;
+         if (fclose(fp) != 0)
+            ok = false;
+         if (!ok) {
+            rc = -EIO;
+            f0printf(ferr, "Error writing %s\n", tmp_path);
+         }
+         else if (rename(tmp_path, path) < 0) {
+            rc = -errno;
+            f0printf(ferr, "Unable to rename %s to %s: %s\n", tmp_path, path, strerror(errno));
+         }
+         if (rc != 0)
+            unlink(tmp_path);
+      }
+   }
+   g_free(tmp_path);
+   return rc;
+}
@@ -121,4 +121,31 @@ int fopen_mkdir(
       FILE *       ferr,
       FILE **      fp_loc);
 
+int file_lock(
+      const char * path,
+      bool         exclusive,
+      FILE *       ferr);
+
+int file_lock_timed(
+      const char * path,
+      bool         exclusive,
+      int          timeout_millis,
+      FILE *       ferr);
+
+void file_unlock(
+      int          lockfd);
+
+int private_directory_check(
+      const char * path,
+      bool         create,
+      FILE *       ferr);
+
+typedef bool (*File_Writer_Func)(FILE * fp, void * data);
+
+int write_file_atomically(
+      const char *     path,
+      File_Writer_Func write_func,
+      void *           data,
+      FILE *           ferr);
+
 #endif /* FILE_UTIL_H_ */
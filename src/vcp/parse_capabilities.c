@@ -1,5 +1,9 @@
 /** @file parse_capabilities.c
  *  Parse the capabilities string returned by DDC, query the parsed data structure.
+ *
+ *  Parsed capabilities are reference counted.  get_parsed_capabilities()
+ *  maintains a cache of parsed results keyed by the raw capabilities string,
+ *  so monitors of the same model share a single immutable instance.
  */
 
 // Copyright (C) 2014-2021 Sanford Rockowitz <rockowitz@minsoft.com>
@@ -47,6 +51,12 @@ char* test_cap_strings[] = {
 };
 #endif
 
+// Parsed capabilities shared by all displays reporting the same capabilities string
+#define PARSED_CAPABILITIES_CACHE_MAX 32
+static GHashTable * parsed_capabilities_cache = NULL;   // raw string -> Parsed_Capabilities *
+static GMutex       parsed_capabilities_cache_mutex;
+
+
 Value_Name_Table capabilities_validity_names = {
    VN(CAPABILITIES_VALID),
    VN(CAPABILITIES_USABLE),
@@ -64,6 +74,7 @@ void dbgrpt_parsed_capabilities(Parsed_Capabilities * pcaps, int depth) {
    int d2 = depth+2;
    rpt_structure_loc("Parsed_Capabilities", pcaps, depth);
    if (pcaps) {
+       rpt_vstring(d1, "ref_ct:                  %d",       g_atomic_int_get(&pcaps->ref_ct));
        rpt_vstring(d1, "raw value:               %s",       pcaps->raw_value);
        rpt_vstring(d1, "raw_value_synthesized:   %s",  sbool(pcaps->raw_value_synthesized));
        rpt_vstring(d1, "model:                   %s", pcaps->model);
@@ -96,7 +107,21 @@ void dbgrpt_parsed_capabilities(Parsed_Capabilities * pcaps, int depth) {
 }
 
 
-/** Frees a Parsed_Capabilities record
+/** Increments the reference count of a #Parsed_Capabilities record.
+ *
+ * @param  pcaps  pointer to #Parsed_Capabilities struct
+ * @return pcaps
+ */
+Parsed_Capabilities * parsed_capabilities_ref(Parsed_Capabilities * pcaps) {
+   assert( pcaps );
+   assert( memcmp(pcaps->marker, PARSED_CAPABILITIES_MARKER, 4) == 0);
+   g_atomic_int_inc(&pcaps->ref_ct);
+   return pcaps;
+}
+
+
+/** Releases a reference to a Parsed_Capabilities record,
+ *  freeing the record when the last reference is released.
  *
  * @param pcaps  pointer to #Parsed_Capabilities struct
  */
@@ -107,6 +132,11 @@ void free_parsed_capabilities(Parsed_Capabilities * pcaps) {
    assert( pcaps );
    assert( memcmp(pcaps->marker, PARSED_CAPABILITIES_MARKER, 4) == 0);
 
+   if (!g_atomic_int_dec_and_test(&pcaps->ref_ct)) {
+      DBGMSF(debug, "Done.     Other references remain");
+      return;
+   }
+
    free(pcaps->raw_value);
    free(pcaps->mccs_version_string);
    free(pcaps->model);
@@ -128,6 +158,8 @@ void free_parsed_capabilities(Parsed_Capabilities * pcaps) {
       if (pcaps->messages)
          g_ptr_array_free(pcaps->messages, true);
    }
+   bbf_free(pcaps->feature_ids);
+   bbf_free(pcaps->readable_feature_ids);
 
    pcaps->marker[3] = 'x';
    free(pcaps);
@@ -619,6 +651,40 @@ bye:
 }
 
 
+// Builds the list of feature ids in the vcp segment
+static Byte_Bit_Flags collect_feature_ids(
+      Parsed_Capabilities * pcaps,
+      bool                  readable_only)
+{
+   assert(pcaps);
+   bool debug = false;
+   DBGMSF(debug, "Starting. readable_only=%s, feature count=%d",
+                 sbool(readable_only), pcaps->vcp_features->len);
+
+   Byte_Bit_Flags flags = bbf_create();
+   if (pcaps->vcp_features) {    // pathological case of 0 length capabilities string
+      for (int ndx = 0; ndx < pcaps->vcp_features->len; ndx++) {
+         Capabilities_Feature_Record * frec = g_ptr_array_index(pcaps->vcp_features, ndx);
+         // DBGMSG("Feature 0x%02x", frec->feature_id);
+
+         bool add_feature_to_list = true;
+         if (readable_only) {
+            VCP_Feature_Table_Entry * vfte = vcp_find_feature_by_hexid_w_default(frec->feature_id);
+            if (!is_feature_readable_by_vcp_version(vfte, pcaps->parsed_mccs_version))
+               add_feature_to_list = false;
+            if (vfte->vcp_global_flags & DDCA_SYNTHETIC_VCP_FEATURE_TABLE_ENTRY)
+               free_synthetic_vcp_entry(vfte);
+         }
+         if (add_feature_to_list)
+            bbf_set(flags, frec->feature_id);
+      }
+   }
+
+   DBGMSF(debug, "Returning Byte_Bit_Flags: %s", bbf_to_string(flags, NULL, 0));
+   return flags;
+}
+
+
 /** Parses the entire capabilities string
  *
  *  @param  buf_start   starting address of string
@@ -645,6 +711,7 @@ Parsed_Capabilities * parse_capabilities(
    char * capabilities_string_start = buf_start;
    Parsed_Capabilities* pcaps = calloc(1, sizeof(Parsed_Capabilities));
    memcpy(pcaps->marker, PARSED_CAPABILITIES_MARKER, 4);
+   pcaps->ref_ct = 1;
 
    // Explicitly initialize all fields as documentation
    pcaps->raw_value = chars_to_string(buf_start, buf_len);
@@ -751,6 +818,9 @@ Parsed_Capabilities * parse_capabilities(
    }
 
 bye:
+   pcaps->feature_ids          = collect_feature_ids(pcaps, false);
+   pcaps->readable_feature_ids = collect_feature_ids(pcaps, true);
+
    if (debug) {
       dbgrpt_parsed_capabilities(pcaps, 0);  // handles NULL
       DBGMSF(debug, "Done.     Returning %p", pcaps);
@@ -779,6 +849,68 @@ Parsed_Capabilities* parse_capabilities_string(
 }
 
 
+/** Returns the parsed form of a capabilities string, using a cached
+ *  result if the same string has already been parsed.
+ *
+ *  @param  caps   null terminated capabilities string
+ *  @return pointer to shared #Parsed_Capabilities structure, to be
+ *          released with free_parsed_capabilities()
+ *
+ *  @remark
+ *  The returned structure may be referenced by other displays and
+ *  other threads.  It must not be modified.
+ */
+Parsed_Capabilities* get_parsed_capabilities(
+      char * caps)
+{
+   assert(caps);
+   bool debug = false;
+   DBGMSF(debug, "Starting. caps=|%s|", caps);
+
+   g_mutex_lock(&parsed_capabilities_cache_mutex);
+   if (!parsed_capabilities_cache)
+      parsed_capabilities_cache = g_hash_table_new_full(
+            g_str_hash, g_str_equal, g_free, (GDestroyNotify) free_parsed_capabilities);
+   Parsed_Capabilities * pcaps = g_hash_table_lookup(parsed_capabilities_cache, caps);
+   if (pcaps)
+      parsed_capabilities_ref(pcaps);
+   g_mutex_unlock(&parsed_capabilities_cache_mutex);
+
+   if (!pcaps) {
+      // parse outside the lock, another thread may parse the same string concurrently
+      pcaps = parse_capabilities_string(caps);
+      g_mutex_lock(&parsed_capabilities_cache_mutex);
+      Parsed_Capabilities * existing = g_hash_table_lookup(parsed_capabilities_cache, caps);
+      if (existing) {
+         free_parsed_capabilities(pcaps);
+         pcaps = parsed_capabilities_ref(existing);
+      }
+      else if (g_hash_table_size(parsed_capabilities_cache) < PARSED_CAPABILITIES_CACHE_MAX) {
+         g_hash_table_insert(parsed_capabilities_cache,
+                             g_strdup(caps),
+                             parsed_capabilities_ref(pcaps));
+      }
+      g_mutex_unlock(&parsed_capabilities_cache_mutex);
+   }
+
+   DBGMSF(debug, "Done.     Returning %p, ref_ct=%d", pcaps, g_atomic_int_get(&pcaps->ref_ct));
+   return pcaps;
+}
+
+
+/** Releases the cache's references to parsed capabilities.
+ *  Records still referenced elsewhere remain valid.
+ */
+void clear_parsed_capabilities_cache() {
+   g_mutex_lock(&parsed_capabilities_cache_mutex);
+   if (parsed_capabilities_cache) {
+      g_hash_table_destroy(parsed_capabilities_cache);
+      parsed_capabilities_cache = NULL;
+   }
+   g_mutex_unlock(&parsed_capabilities_cache_mutex);
+}
+
+
 //
 // Functions to query Parsed_Capabilities
 //
@@ -788,38 +920,18 @@ Parsed_Capabilities* parse_capabilities_string(
  *  @param pcaps           pointer to #Parsed_Capabilities
  *  @param readable_only   restrict returned list to readable features
  *
- *  @return  #Byte_Bit_Flags value indicating features found
+ *  @return  #Byte_Bit_Flags value indicating features found,
+ *           caller is responsible for freeing
+ *
+ *  @remark
+ *  The lists are computed once, when the capabilities string is parsed.
  */
 Byte_Bit_Flags get_parsed_capabilities_feature_ids(
       Parsed_Capabilities * pcaps,
       bool                  readable_only)
 {
    assert(pcaps);
-   bool debug = false;
-   DBGMSF(debug, "Starting. readable_only=%s, feature count=%d",
-                 sbool(readable_only), pcaps->vcp_features->len);
-
-   Byte_Bit_Flags flags = bbf_create();
-   if (pcaps->vcp_features) {    // pathological case of 0 length capabilities string
-      for (int ndx = 0; ndx < pcaps->vcp_features->len; ndx++) {
-         Capabilities_Feature_Record * frec = g_ptr_array_index(pcaps->vcp_features, ndx);
-         // DBGMSG("Feature 0x%02x", frec->feature_id);
-
-         bool add_feature_to_list = true;
-         if (readable_only) {
-            VCP_Feature_Table_Entry * vfte = vcp_find_feature_by_hexid_w_default(frec->feature_id);
-            if (!is_feature_readable_by_vcp_version(vfte, pcaps->parsed_mccs_version))
-               add_feature_to_list = false;
-            if (vfte->vcp_global_flags & DDCA_SYNTHETIC_VCP_FEATURE_TABLE_ENTRY)
-               free_synthetic_vcp_entry(vfte);
-         }
-         if (add_feature_to_list)
-            bbf_set(flags, frec->feature_id);
-      }
-   }
-
-   DBGMSF(debug, "Returning Byte_Bit_Flags: %s", bbf_to_string(flags, NULL, 0));
-   return flags;
+   return bbf_copy( (readable_only) ? pcaps->readable_feature_ids : pcaps->feature_ids );
 }
 
 
@@ -838,7 +950,7 @@ bool parsed_capabilities_supports_table_commands(Parsed_Capabilities * pcaps) {
        bva_contains(pcaps->commands, 0xe4)         // Table Read Reply
       )
    {
-         result = false;
+         result = true;
    }
    return result;
 }
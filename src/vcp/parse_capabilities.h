@@ -23,9 +23,14 @@ typedef enum {
 
 
 #define PARSED_CAPABILITIES_MARKER "CAPA"
-/** Contains parsed capabilities information */
-typedef struct {
+/** Contains parsed capabilities information
+ *
+ *  Instances returned by get_parsed_capabilities() are shared and must be
+ *  treated as immutable.  They are released using free_parsed_capabilities().
+ */
+typedef struct Parsed_Capabilities {
    char                    marker[4];             // always "CAPA"
+   int                     ref_ct;                // reference count
    char *                  raw_value;
    bool                    raw_value_synthesized;
    char *                  model;
@@ -38,11 +43,16 @@ typedef struct {
    GPtrArray *             vcp_features;         // entries are Capabilities_Feature_Record *
    Parsed_Capabilities_Validity caps_validity;
    GPtrArray *             messages;
+   Byte_Bit_Flags          feature_ids;          // all features in vcp segment
+   Byte_Bit_Flags          readable_feature_ids; // readable features in vcp segment
 } Parsed_Capabilities;
 
 
 Parsed_Capabilities* parse_capabilities_string(char * capabilities);
+Parsed_Capabilities* get_parsed_capabilities(char * capabilities);
+Parsed_Capabilities* parsed_capabilities_ref(Parsed_Capabilities * pcaps);
 void                 free_parsed_capabilities(Parsed_Capabilities * pcaps);
+void                 clear_parsed_capabilities_cache();
 Byte_Bit_Flags       get_parsed_capabilities_feature_ids(Parsed_Capabilities * pcaps, bool readable_only);
 bool                 parsed_capabilities_supports_table_commands(Parsed_Capabilities * pcaps);
 char *               parsed_capabilities_validity_name(Parsed_Capabilities_Validity validity);
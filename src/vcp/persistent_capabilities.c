@@ -1,4 +1,15 @@
-/** \file persistent_capabilities.c */
+/** \file persistent_capabilities.c
+ *
+ *  Saves capabilities strings in file $HOME/.cache/ddcutil/capabilities,
+ *  one line per monitor model, of the form:
+ *     <monitor model string>:<capabilities string>
+ *
+ *  Multiple ddcutil processes may use the file concurrently.  Updates are
+ *  made while holding an exclusive flock() lock on file capabilities.lock.
+ *  A new entry is appended to the file.  A changed entry causes the file to
+ *  be rewritten to a temporary file that is then renamed, so that a reader
+ *  never sees a truncated file.
+ */
 
 // Copyright (C) 2021 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
@@ -8,6 +19,7 @@
 #include <glib-2.0/glib.h>
 #include <stddef.h>
 #include <strings.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "public/ddcutil_types.h"
@@ -30,6 +42,8 @@ static DDCA_Trace_Group TRACE_GROUP  = DDCA_TRC_VCP;
 static bool capabilities_cache_enabled = false;   // default set in parser
 static GHashTable *  capabilities_hash = NULL;
 static GMutex persistent_capabilities_mutex;
+static struct stat   loaded_file_stat;            // state of file when last read or written
+static bool          loaded_file_stat_valid = false;
 
 
 static void dbgrpt_capabilities_hash0(int depth, const char * msg) {
@@ -58,10 +72,45 @@ static void dbgrpt_capabilities_hash0(int depth, const char * msg) {
 }
 
 
+static char * get_capabilities_lock_file_name() {
+   return xdg_cache_home_file("ddcutil", "capabilities.lock");
+}
+
+
+// Records the current size and modification time of the capabilities file,
+// so that changes made by other processes can be detected.
+static void note_capabilities_file_state() {
+   char * fn = get_capabilities_cache_file_name();
+   loaded_file_stat_valid = (stat(fn, &loaded_file_stat) == 0);
+   free(fn);
+}
+
+
+// Reports whether the capabilities file has changed since it was last
+// read or written by this process.
+static bool capabilities_file_changed() {
+   char * fn = get_capabilities_cache_file_name();
+   struct stat cur;
+   bool exists = (stat(fn, &cur) == 0);
+   free(fn);
+   if (exists != loaded_file_stat_valid)
+      return true;
+   if (!exists)
+      return false;
+   return cur.st_size          != loaded_file_stat.st_size          ||
+          cur.st_ino           != loaded_file_stat.st_ino           ||
+          cur.st_mtim.tv_sec   != loaded_file_stat.st_mtim.tv_sec   ||
+          cur.st_mtim.tv_nsec  != loaded_file_stat.st_mtim.tv_nsec;
+}
+
+
 static void delete_capabilities_file() {
    bool debug = false;
    char * fn = get_capabilities_cache_file_name();
    if (regular_file_exists(fn)) {
+      char * lockfn = get_capabilities_lock_file_name();
+      int lockfd = file_lock(lockfn, true, ferr());
+      free(lockfn);
       DBGMSF(debug, "Deleting file: %s", fn);
       int rc = unlink(fn);
       if (rc < 0) {
@@ -69,15 +118,19 @@ static void delete_capabilities_file() {
          fprintf(fout(), "Unexpected error deleting file %s: %s\n",
                          fn, strerror(errno));
       }
+      file_unlock(lockfd);
    }
    else {
       DBGMSF(debug, "File does not exist: %s", fn);
    }
    free(fn);
+   loaded_file_stat_valid = false;
 }
 
 
-static Error_Info * load_persistent_capabilities_file() {
+// Reads the capabilities file into capabilities_hash.
+// The caller must hold the capabilities lock file.
+static Error_Info * load_persistent_capabilities_file0() {
    bool debug = false;
    if (debug || IS_TRACING()) {
       DBGTRC_STARTING(debug, TRACE_GROUP, "capabilities_hash:");
@@ -96,6 +149,7 @@ static Error_Info * load_persistent_capabilities_file() {
       GPtrArray * linearray = g_ptr_array_new_with_free_func(g_free);
       errs = file_getlines_errinfo(data_file_name, linearray);
       free(data_file_name);
+      note_capabilities_file_state();
       if (!errs) {
          for (int ndx = 0; ndx < linearray->len; ndx++) {
             char * aline = strtrim(g_ptr_array_index(linearray, ndx));
@@ -116,8 +170,8 @@ static Error_Info * load_persistent_capabilities_file() {
             }
             free(aline);
          }
-         g_ptr_array_free(linearray, true);
       }
+      g_ptr_array_free(linearray, true);
    }
    else {
       if (capabilities_hash) {
@@ -137,37 +191,88 @@ static Error_Info * load_persistent_capabilities_file() {
 }
 
 
+static Error_Info * load_persistent_capabilities_file() {
+   Error_Info * errs = NULL;
+   if (capabilities_cache_enabled) {
+      char * lockfn = get_capabilities_lock_file_name();
+      int lockfd = file_lock(lockfn, false, ferr());
+      free(lockfn);
+      errs = load_persistent_capabilities_file0();
+      file_unlock(lockfd);
+   }
+   else {
+      errs = load_persistent_capabilities_file0();
+   }
+   return errs;
+}
+
+
+// loads the file if not yet loaded, reporting any errors
+static void ensure_capabilities_loaded(bool have_lock) {
+   if (!capabilities_hash) {
+      Error_Info * errs = (have_lock) ? load_persistent_capabilities_file0()
+                                      : load_persistent_capabilities_file();
+      if (errs) {
+         if (ERRINFO_STATUS(errs) == -ENOENT)
+            errinfo_free(errs);
+         else
+            ERRINFO_FREE_WITH_REPORT(errs,true);
+      }
+   }
+}
+
+
+static bool write_capabilities_lines(FILE * fp, void * data) {
+   bool debug = false;
+   bool ok = true;
+   GHashTableIter iter;
+   gpointer key, value;
+   g_hash_table_iter_init(&iter, capabilities_hash);
+   for (int line_ctr=1; g_hash_table_iter_next(&iter, &key, &value); line_ctr++) {
+      DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Writing line %d: %s:%s", line_ctr, key, value);
+      if (fprintf(fp, "%s:%s\n", (char *) key, (char*) value) < 0) {
+         ok = false;
+         break;
+      }
+   }
+   return ok;
+}
+
+
+// Rewrites the entire capabilities file from capabilities_hash.
+// The caller must hold the capabilities lock file exclusively.
 static void save_persistent_capabilities_file() {
    bool debug = false;
-   char * data_file_name = xdg_cache_home_file("ddcutil", "capabilities");
+   char * data_file_name = get_capabilities_cache_file_name();
    DBGTRC_STARTING(debug, TRACE_GROUP, "capabilities_cache_enabled: %s, data_file_name=%s",
                               sbool(capabilities_cache_enabled), data_file_name);
 
-   if (capabilities_cache_enabled) {
-      FILE * fp = NULL;
-      fopen_mkdir(data_file_name, "w", ferr(), &fp);
-      if (!fp) {
-         // SEVEREMSG("Error opening %s: %s", data_file_name, strerror(errno));   // handled by fopen_mdkr()
-         goto bye;
-      }
-      if (capabilities_hash) {
-         GHashTableIter iter;
-         gpointer key, value;
-         g_hash_table_iter_init(&iter, capabilities_hash);
+   if (capabilities_cache_enabled && capabilities_hash) {
+      write_file_atomically(data_file_name, write_capabilities_lines, NULL, ferr());
+      note_capabilities_file_state();
+   }
 
-         for (int line_ctr=1; g_hash_table_iter_next(&iter, &key, &value); line_ctr++) {
-            DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Writing line %d: %s:%s", line_ctr, key, value);
-            int ct = fprintf(fp, "%s:%s\n", (char *) key, (char*) value);
-            if (ct < 0) {
-               SEVEREMSG("Error writing to file %s:%s", data_file_name, strerror(errno) );
-               break;
-            }
-         }
-      }
+   free(data_file_name);
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+// Appends a single entry to the capabilities file.
+// The caller must hold the capabilities lock file exclusively.
+static void append_persistent_capabilities_line(const char * mms, const char * capabilities) {
+   bool debug = false;
+   char * data_file_name = get_capabilities_cache_file_name();
+   DBGTRC_STARTING(debug, TRACE_GROUP, "data_file_name=%s, mms=%s", data_file_name, mms);
+
+   FILE * fp = NULL;
+   fopen_mkdir(data_file_name, "a", ferr(), &fp);
+   if (fp) {
+      if (fprintf(fp, "%s:%s\n", mms, capabilities) < 0)
+         SEVEREMSG("Error writing to file %s:%s", data_file_name, strerror(errno) );
       fclose(fp);
+      note_capabilities_file_state();
    }
 
-bye:
    free(data_file_name);
    DBGTRC_DONE(debug, TRACE_GROUP, "");
 }
@@ -256,11 +361,14 @@ bool enable_capabilities_cache(bool newval) {
 
 /** Look up the capabilities string for a monitor model.
  *
- *  The returned value is owned by the persistent capabilities
- *  hash table and should not be freed.
+ *  If the string is not found and the file has been changed by
+ *  another process since it was read, it is read again.
  *
  *  \param mmk monitor model key
- *  \return capabilities string, NULL if not found
+ *  \return newly allocated copy of capabilities string, NULL if not found
+ *
+ *  \remark
+ *  Caller is responsible for freeing the returned value.
  */
 char * get_persistent_capabilities(DDCA_Monitor_Model_Key* mmk)
 {
@@ -276,28 +384,25 @@ char * get_persistent_capabilities(DDCA_Monitor_Model_Key* mmk)
    }
 
    if (capabilities_cache_enabled) {
-      if (!capabilities_hash) {  // if not yet loaded
-         Error_Info * errs = load_persistent_capabilities_file();
-         if (errs) {
-            if (ERRINFO_STATUS(errs) == -ENOENT)
-               errinfo_free(errs);
-            else
-               ERRINFO_FREE_WITH_REPORT(errs,true);
-         }
-      }
+      ensure_capabilities_loaded(false);
 
-      if (mmk) {
-         char * mms = strdup(monitor_model_string(mmk));
-
-         if (debug) {
-            DBGMSG("Hash table before lookup:");
-            dbgrpt_capabilities_hash0(2, NULL);
-            DBGMSG("Looking for key: mms -> |%s|", mms);
-         }
+      char * mms = strdup(monitor_model_string(mmk));
+      if (debug) {
+         DBGMSG("Hash table before lookup:");
+         dbgrpt_capabilities_hash0(2, NULL);
+         DBGMSG("Looking for key: mms -> |%s|", mms);
+      }
 
-         result = g_hash_table_lookup (capabilities_hash, mms);
-         free(mms);
-     }
+      result = g_hash_table_lookup(capabilities_hash, mms);
+      if (!result && capabilities_file_changed()) {
+         DBGTRC_NOPREFIX(debug, TRACE_GROUP, "File changed by another process, reloading");
+         g_hash_table_destroy(capabilities_hash);
+         capabilities_hash = NULL;
+         ensure_capabilities_loaded(false);
+         result = g_hash_table_lookup(capabilities_hash, mms);
+      }
+      result = g_strdup(result);
+      free(mms);
    }
 
 bye:
@@ -311,6 +416,9 @@ bye:
  *  if persistent capabilities are enabled, writes the string and its
  *  key to the table on the file system.
  *
+ *  Entries written by other processes since the file was read are
+ *  merged before the file is updated.
+ *
  *  \param mmk            monitor model key
  *  \param capabilities   capabilities string
  *
@@ -331,11 +439,28 @@ void set_persistent_capabilites(
          DBGTRC_NOPREFIX(debug, TRACE_GROUP,
                          "Not saving capabilities for non-unique Monitor_Model_Key.");
       else {
-         char * mms = strdup(monitor_model_string(mmk));
-         g_hash_table_insert(capabilities_hash, mms, strdup(capabilities));
-         if (debug || IS_TRACING())
-            dbgrpt_capabilities_hash0(2, "Capabilities hash after insert and before saving");
-         save_persistent_capabilities_file();
+         char * lockfn = get_capabilities_lock_file_name();
+         int lockfd = file_lock(lockfn, true, ferr());
+         free(lockfn);
+
+         if (capabilities_hash && capabilities_file_changed()) {
+            g_hash_table_destroy(capabilities_hash);
+            capabilities_hash = NULL;
+         }
+         ensure_capabilities_loaded(true);
+
+         char * mms = monitor_model_string(mmk);
+         char * old = g_hash_table_lookup(capabilities_hash, mms);
+         if (!old || !streq(old, capabilities)) {
+            g_hash_table_replace(capabilities_hash, strdup(mms), strdup(capabilities));
+            if (debug || IS_TRACING())
+               dbgrpt_capabilities_hash0(2, "Capabilities hash after insert and before saving");
+            if (old)
+               save_persistent_capabilities_file();
+            else
+               append_persistent_capabilities_line(mms, capabilities);
+         }
+         file_unlock(lockfd);
       }
    }
    g_mutex_unlock(&persistent_capabilities_mutex);
@@ -348,6 +473,7 @@ void init_persistent_capabilities() {
    RTTI_ADD_FUNC(enable_capabilities_cache);
    RTTI_ADD_FUNC(load_persistent_capabilities_file);
    RTTI_ADD_FUNC(save_persistent_capabilities_file);
+   RTTI_ADD_FUNC(append_persistent_capabilities_line);
    RTTI_ADD_FUNC(get_persistent_capabilities);
    RTTI_ADD_FUNC(set_persistent_capabilites);
 }
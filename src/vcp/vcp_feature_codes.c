@@ -8,6 +8,7 @@
 
 /** \cond */
 #include <assert.h>
+#include <glib-2.0/glib.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
@@ -46,6 +47,21 @@ static DDCA_Feature_Value_Entry xca_v22_osd_button_sh_values[];
 
 static bool vcp_feature_codes_initialized = false;
 
+// Indexes into vcp_code_table[], built by init_vcp_feature_codes()
+
+// MCCS version classes for which version sensitive flags are precomputed
+typedef enum {
+   VSPEC_CLASS_V20,      // 2.0 and anything not matched below
+   VSPEC_CLASS_V21,      // 2.1
+   VSPEC_CLASS_V22,      // 2.2 and later 2.x
+   VSPEC_CLASS_V30,      // 3.0 and later
+   VSPEC_CLASS_CT
+} Vspec_Class;
+
+static VCP_Feature_Table_Entry *   vcp_code_index[256];   // feature code -> table entry
+static DDCA_Version_Feature_Flags  vcp_sensitive_flags_index[256][VSPEC_CLASS_CT];
+static GHashTable *                vcp_name_index = NULL; // lower case feature name -> table entry
+
 //
 // Functions implementing the VCPINFO command
 //
@@ -183,6 +199,19 @@ int vcp_get_feature_code_count() {
 
 
 
+// Maps a VCP version to the class used to index vcp_sensitive_flags_index[].
+// Must be consistent with get_version_specific_feature_flags().
+static inline Vspec_Class vspec_class(DDCA_MCCS_Version_Spec vcp_version) {
+   if (vcp_version.major >= 3)
+      return VSPEC_CLASS_V30;
+   if (vcp_version.major == 2 && vcp_version.minor >= 2)
+      return VSPEC_CLASS_V22;
+   if (vcp_version.major == 2 && vcp_version.minor == 1)
+      return VSPEC_CLASS_V21;
+   return VSPEC_CLASS_V20;
+}
+
+
 /* Gets the appropriate VCP flags value for a feature, given
  * the VCP version for the monitor.
  *
@@ -288,8 +317,13 @@ get_version_sensitive_feature_flags(
        DDCA_MCCS_Version_Spec    vcp_version)
 {
    bool debug = false;
-   DDCA_Version_Feature_Flags result = get_version_specific_feature_flags(pvft_entry, vcp_version);
+   DDCA_Version_Feature_Flags result = 0;
+   if (vcp_feature_codes_initialized && vcp_code_index[pvft_entry->code] == pvft_entry)
+      result = vcp_sensitive_flags_index[pvft_entry->code][vspec_class(vcp_version)];
+   if (result)
+      goto bye;
 
+   result = get_version_specific_feature_flags(pvft_entry, vcp_version);
    if (!result) {
       // vcp_version is lower than the first version level at which the field
       // was defined.  This can occur e.g. if scanning.  Pick the best
@@ -308,6 +342,7 @@ get_version_sensitive_feature_flags(
       }
    }
 
+bye:
    DBGMSF(debug, "Feature = 0x%02x, vcp version=%d.%d, returning 0x%02x",
           pvft_entry->code, vcp_version.major, vcp_version.minor, result);
    return result;
@@ -1089,9 +1124,11 @@ vcp_create_table_dummy_feature_for_hexid(DDCA_Vcp_Feature_Code id) {
 VCP_Feature_Table_Entry *
 vcp_find_feature_by_hexid(DDCA_Vcp_Feature_Code id) {
    // DBGMSG("Starting. id=0x%02x ", id );
+   if (vcp_feature_codes_initialized)
+      return vcp_code_index[id];
+
    int ndx = 0;
    VCP_Feature_Table_Entry * result = NULL;
-
    for (;ndx < vcp_feature_code_count; ndx++) {
       if (id == vcp_code_table[ndx].code) {
          result = &vcp_code_table[ndx];
@@ -1125,6 +1162,28 @@ vcp_find_feature_by_hexid_w_default(DDCA_Vcp_Feature_Code id) {
 }
 
 
+
+/* Returns an entry in the VCP feature table based on its name.
+ * The name of any MCCS version is accepted.  Case is ignored.
+ *
+ * Arguments:
+ *    name  feature name, e.g. "Brightness"
+ *
+ * Returns:
+ *    VCP_Feature_Table_Entry, NULL if not found
+ *    Note this is a pointer into the VCP feature data structures.
+ *    It should NOT be freed by the caller.
+ */
+VCP_Feature_Table_Entry *
+vcp_find_feature_by_name(const char * name) {
+   assert(vcp_feature_codes_initialized);
+   char * lc_name = g_ascii_strdown(name, -1);
+   VCP_Feature_Table_Entry * result = g_hash_table_lookup(vcp_name_index, lc_name);
+   g_free(lc_name);
+   return result;
+}
+
+
 ////////////////////////////////////////////////////////////////////////
 //
 //  Functions to format Table values
@@ -2757,6 +2816,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
      .v20_flags =  DDCA_RW | DDCA_STD_CONT,
      .v20_name = "Brightness",
      .v30_name = "Luminosity",
+     .volatility = VCP_VOLATILITY_TTL,
    },
    {  .code=0x11,
       // not in 2.0, is in 3.0, assume introduced in 2.1
@@ -2774,6 +2834,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .vcp_subsets = VCP_SUBSET_COLOR | VCP_SUBSET_PROFILE,
       .v20_flags = DDCA_RW | DDCA_STD_CONT,
       .v20_name = "Contrast",
+      .volatility = VCP_VOLATILITY_TTL,
    },
    {  .code=0x13,
       .vcp_spec_groups = VCP_SPEC_IMAGE,
@@ -2810,6 +2871,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .vcp_subsets = VCP_SUBSET_COLOR | VCP_SUBSET_PROFILE,
       .v20_flags = DDCA_RW | DDCA_STD_CONT,
       .v20_name = "Video gain: Red",
+      .volatility = VCP_VOLATILITY_TTL,
    },
    {  .code=0x17,
       .vcp_spec_groups = VCP_SPEC_IMAGE,
@@ -2825,6 +2887,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .vcp_subsets = VCP_SUBSET_COLOR | VCP_SUBSET_PROFILE,
       .v20_flags = DDCA_RW | DDCA_STD_CONT,
       .v20_name = "Video gain: Green",
+      .volatility = VCP_VOLATILITY_TTL,
    },
    {  .code=0x1a,
       .vcp_spec_groups = VCP_SPEC_IMAGE,
@@ -2832,6 +2895,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .vcp_subsets = VCP_SUBSET_COLOR | VCP_SUBSET_PROFILE,
       .v20_flags = DDCA_RW | DDCA_STD_CONT,
       .v20_name = "Video gain: Blue",
+      .volatility = VCP_VOLATILITY_TTL,
    },
    {  .code=0x1c,
       .vcp_spec_groups = VCP_SPEC_IMAGE,
@@ -3862,6 +3926,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .v21_sl_values = xb6_display_technology_type_values,
       .v20_flags = DDCA_RO | DDCA_SIMPLE_NC,
       .v20_name = "Display technology type",
+      .volatility = VCP_VOLATILITY_STATIC,
    },
    {  .code=0xb7,
       .vcp_spec_groups = VCP_SPEC_DPVL,
@@ -3966,6 +4031,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .desc = "A 2 byte value used to allow an application to only operate with known products.",
       .v20_flags = DDCA_RO | DDCA_COMPLEX_NC,
       .v20_name = "Application enable key",
+      .volatility = VCP_VOLATILITY_STATIC,
    },
    {  .code=0xc8,
       .vcp_spec_groups = VCP_SPEC_MISC | VCP_SPEC_CONTROL,    // 2.0: MISC, 3.0: CONTROL
@@ -3974,6 +4040,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .desc = "Mfg id of controller and 2 byte manufacturer-specific controller type",
       .v20_flags = DDCA_RO | DDCA_COMPLEX_NC,
       .v20_name = "Display controller type",
+      .volatility = VCP_VOLATILITY_STATIC,
    },
    {  .code=0xc9,
       .vcp_spec_groups = VCP_SPEC_MISC | VCP_SPEC_CONTROL,    // 2.: MISC, 3.0: CONTROL
@@ -3981,6 +4048,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .desc = "2 byte firmware level",
       .v20_flags = DDCA_RO | DDCA_COMPLEX_NC,
       .v20_name = "Display firmware level",
+      .volatility = VCP_VOLATILITY_STATIC,
    },
    {  .code=0xca,
       // Says the v2.2 spec: A new feature added to V3.0 and expanded in V2.2
@@ -4115,6 +4183,7 @@ VCP_Feature_Table_Entry vcp_code_table[] = {
       .desc = "MCCS version",
       .v20_flags = DDCA_RO | DDCA_COMPLEX_NC,
       .v20_name  = "VCP Version",
+      .volatility = VCP_VOLATILITY_STATIC,
    }
 };
 // #pragma GCC diagnostic pop
@@ -4402,6 +4471,60 @@ static void init_func_name_table() {
 }
 
 
+// Adds a feature name to the name index, first entry wins
+static void add_to_name_index(char * name, VCP_Feature_Table_Entry * vfte) {
+   if (name) {
+      char * lc_name = g_ascii_strdown(name, -1);
+      if (g_hash_table_contains(vcp_name_index, lc_name))
+         g_free(lc_name);
+      else
+         g_hash_table_insert(vcp_name_index, lc_name, vfte);
+   }
+}
+
+
+/* Builds the lookup indexes for vcp_code_table[], and precomputes
+ * version sensitive feature flags for each MCCS version class.
+ */
+static void init_vcp_feature_indexes() {
+   DDCA_MCCS_Version_Spec class_vspecs[VSPEC_CLASS_CT] = {
+         [VSPEC_CLASS_V20] = DDCA_VSPEC_V20,
+         [VSPEC_CLASS_V21] = DDCA_VSPEC_V21,
+         [VSPEC_CLASS_V22] = DDCA_VSPEC_V22,
+         [VSPEC_CLASS_V30] = DDCA_VSPEC_V30,
+   };
+
+   vcp_name_index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+   for (int ndx=vcp_feature_code_count-1; ndx >= 0; ndx--) {
+      // iterate backwards so that the first entry for a code wins, as with a linear search
+      VCP_Feature_Table_Entry * vfte = &vcp_code_table[ndx];
+      vcp_code_index[vfte->code] = vfte;
+   }
+   for (int code = 0; code < 256; code++) {
+      VCP_Feature_Table_Entry * vfte = vcp_code_index[code];
+      if (vfte) {
+         for (int vclass = 0; vclass < VSPEC_CLASS_CT; vclass++) {
+            // same fallback order as get_version_sensitive_feature_flags(),
+            // left 0 if there are no flags, so the full path reports the error
+            DDCA_Version_Feature_Flags flags =
+                  get_version_specific_feature_flags(vfte, class_vspecs[vclass]);
+            if (!flags)
+               flags = (vfte->v21_flags) ? vfte->v21_flags :
+                       (vfte->v30_flags) ? vfte->v30_flags : vfte->v22_flags;
+            vcp_sensitive_flags_index[code][vclass] = flags;
+         }
+      }
+   }
+   for (int ndx=0; ndx < vcp_feature_code_count; ndx++) {
+      VCP_Feature_Table_Entry * vfte = &vcp_code_table[ndx];
+      add_to_name_index(vfte->v20_name, vfte);
+      add_to_name_index(vfte->v21_name, vfte);
+      add_to_name_index(vfte->v30_name, vfte);
+      add_to_name_index(vfte->v22_name, vfte);
+   }
+}
+
+
 /** Initialize the vcp_feature_codes module.
  *  Must be called before any other function in this file.
  */
@@ -4412,6 +4535,7 @@ void init_vcp_feature_codes() {
    for (int ndx=0; ndx < vcp_feature_code_count; ndx++) {
       memcpy( vcp_code_table[ndx].marker, VCP_FEATURE_TABLE_ENTRY_MARKER, 4);
    }
+   init_vcp_feature_indexes();
    init_func_name_table();
    // dbgrpt_func_name_table(0);
    vcp_feature_codes_initialized = true;
@@ -160,6 +160,7 @@ struct {
    DDCA_Feature_Value_Entry *            v21_sl_values;
    DDCA_Feature_Value_Entry *            v30_sl_values;
    DDCA_Feature_Value_Entry *            v22_sl_values;
+   Vcp_Volatility                        volatility;     // how long a value read remains valid
 } VCP_Feature_Table_Entry;
 
 void dbgrpt_vcp_entry(VCP_Feature_Table_Entry * pfte, int depth);
@@ -203,6 +204,10 @@ VCP_Feature_Table_Entry *
 vcp_find_feature_by_hexid_w_default(
       DDCA_Vcp_Feature_Code id);
 
+VCP_Feature_Table_Entry *
+vcp_find_feature_by_name(
+      const char * name);
+
 //
 // Functions to extract information from a VCP_Feature_Table_Entry
 //
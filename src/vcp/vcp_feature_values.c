@@ -225,6 +225,23 @@ void free_single_vcp_value(DDCA_Any_Vcp_Value * vcp_value) {
 }
 
 
+/** Creates a deep copy of a #DDCA_Any_Vcp_Value.
+ *
+ *  @param  old  value to copy
+ *  @return newly allocated copy, caller must free using #free_single_vcp_value()
+ */
+DDCA_Any_Vcp_Value * clone_single_vcp_value(DDCA_Any_Vcp_Value * old) {
+   DDCA_Any_Vcp_Value * valrec = NULL;
+   if (old->value_type == DDCA_TABLE_VCP_VALUE)
+      valrec = create_table_vcp_value_by_bytes(old->opcode, old->val.t.bytes, old->val.t.bytect);
+   else {
+      valrec = calloc(1, sizeof(DDCA_Any_Vcp_Value));
+      memcpy(valrec, old, sizeof(DDCA_Any_Vcp_Value));
+   }
+   return valrec;
+}
+
+
 // wrap free_single_vcp_value() in signature of GDestroyNotify()
 void free_single_vcp_value_func(gpointer data) {
    free_single_vcp_value((DDCA_Any_Vcp_Value *) data);
@@ -113,6 +113,8 @@ Nontable_Vcp_Value *
       single_vcp_value_to_nontable_vcp_value(
                                DDCA_Any_Vcp_Value * valrec);
 void  free_single_vcp_value(   DDCA_Any_Vcp_Value * vcp_value);
+DDCA_Any_Vcp_Value *
+      clone_single_vcp_value(  DDCA_Any_Vcp_Value * old);
 void  dbgrpt_single_vcp_value( DDCA_Any_Vcp_Value * valrec, int depth);
 
 // void report_any_vcp_value(DDCA_Any_Vcp_Value * valrec, int depth);